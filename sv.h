@@ -5,47 +5,602 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
 #include <assert.h>
 
+/* Define SV_STATIC_INLINE to get every function as static inline in the
+including file (the implementation comes along), so hot loops can inline and
+constant-fold arguments. Each such file then has its own SIMD level. */
+#ifdef SV_STATIC_INLINE
+#define SVDEF static inline
+#ifndef SV_IMPLEMENTATION
+#define SV_IMPLEMENTATION
+#endif
+#else
+#define SVDEF
+#endif
+
 typedef struct StringView
 {
 	size_t len;
 	const char *data;
 } StringView;
 
-char *read_file_cstr(char *filename);
+SVDEF char *read_file_cstr(char *filename);
+
+SVDEF StringView sv_from_cstr(char *cstr);
+SVDEF StringView sv_construct(char *cstr, size_t len);
+
+SVDEF StringView sv_split_left(StringView *sv, char delim);
+SVDEF StringView sv_split_right(StringView *sv, char delim);
+
+SVDEF StringView sv_cut_left(StringView *sv, size_t num);
+SVDEF StringView sv_cut_right(StringView *sv, size_t num);
+
+SVDEF int sv_strip_left(StringView *sv);
+SVDEF int sv_strip_right(StringView *sv);
+
+SVDEF int sv_find_left_char(StringView *sv, char n);
+SVDEF int sv_find_right_char(StringView *sv, char n);
+
+SVDEF int sv_find_left_predicate(StringView *sv, bool (*predicate)(char));
+
+SVDEF bool sv_starts_with(StringView sv, StringView sv_other);
+SVDEF bool sv_ends_with(StringView sv, StringView sv_other);
+
+SVDEF int sv_starts_with_predicate(StringView *sv, bool (*predicate)(char));
+SVDEF int sv_ends_with_predicate(StringView *sv, bool (*predicate)(char));
+
+SVDEF bool sv_whitespace_predicate(char n);
+
+SVDEF bool sv_compare(StringView sv, StringView sv_other);
+
+/* Flags for sv_map_file. Advice the platform does not support is ignored. */
+enum
+{
+	SV_MAP_POPULATE = 1 << 0,	/* prefault the whole file at map time */
+	SV_MAP_SEQUENTIAL = 1 << 1, /* aggressive read-ahead, pages dropped behind the reader */
+	SV_MAP_WILLNEED = 1 << 2,	/* start reading the file in the background */
+	SV_MAP_HUGEPAGES = 1 << 3,	/* ask for transparent huge pages */
+};
+
+typedef struct sv_mapped_file
+{
+	StringView view;
+	void *addr;
+	size_t size;
+} sv_mapped_file;
+
+SVDEF int sv_map_file(const char *filename, int flags, sv_mapped_file *file);
+SVDEF int sv_unmap_file(sv_mapped_file *file);
+
+/* Reads records from a file descriptor through one fixed buffer. A partial
+record at the end of the buffer is moved to the front before the next read, so
+memory stays at the buffer size (it only grows for a record longer than it).
+Views handed out are valid until the next call on the reader. */
+typedef struct sv_reader
+{
+	int fd;
+	char *buffer;
+	size_t capacity;
+	size_t start;	/* first byte not handed out yet */
+	size_t end;		/* one past the last byte read */
+	size_t scanned; /* bytes after start known not to hold the delimiter */
+	bool eof;
+	int error;
+} sv_reader;
+
+SVDEF int sv_reader_init(sv_reader *reader, int fd, size_t capacity);
+SVDEF void sv_reader_free(sv_reader *reader);
+SVDEF StringView sv_reader_next(sv_reader *reader, char delim);
+SVDEF bool sv_reader_refill(sv_reader *reader);
+SVDEF StringView sv_reader_peek(const sv_reader *reader);
+SVDEF void sv_reader_consume(sv_reader *reader, size_t num);
+
+typedef enum sv_simd_level
+{
+	SV_SIMD_SCALAR = 0,
+	SV_SIMD_SSE2,
+	SV_SIMD_AVX2,
+	SV_SIMD_AVX512,
+} sv_simd_level;
+
+SVDEF sv_simd_level sv_simd_detect(void);
+SVDEF sv_simd_level sv_simd_get(void);
+SVDEF sv_simd_level sv_simd_set(sv_simd_level level);
+
+SVDEF int sv_find_left_char_scalar(StringView *sv, char n);
+SVDEF int sv_find_right_char_scalar(StringView *sv, char n);
+
+/* 256-bit set of byte values. Byte b is a member when
+rows[(b >> 7) * 16 + (b & 15)] has bit ((b >> 4) & 7) set; the layout lets the
+SIMD kernels use the rows directly as nibble lookup tables. */
+typedef struct sv_charset
+{
+	unsigned char rows[32];
+} sv_charset;
+
+SVDEF sv_charset sv_charset_from_cstr(const char *chars);
+SVDEF sv_charset sv_charset_from_sv(StringView chars);
+SVDEF void sv_charset_add(sv_charset *set, char c);
+SVDEF bool sv_charset_has(const sv_charset *set, char c);
+
+SVDEF int sv_find_left_any(StringView *sv, const sv_charset *set);
+SVDEF int sv_find_right_any(StringView *sv, const sv_charset *set);
+
+SVDEF StringView sv_split_left_any(StringView *sv, const sv_charset *set);
+SVDEF StringView sv_split_right_any(StringView *sv, const sv_charset *set);
+
+/* Builtin ASCII character classes (C locale), usable wherever a charset is
+taken. SV_CLASS_SPACE is " \t\n\r\v\f". */
+enum
+{
+	SV_CLASS_SPACE,
+	SV_CLASS_DIGIT,
+	SV_CLASS_ALPHA,
+	SV_CLASS_ALNUM,
+	SV_CLASS_XDIGIT,
+	SV_CLASS_UPPER,
+	SV_CLASS_LOWER,
+	SV_CLASS_PUNCT,
+	SV_CLASS_COUNT
+};
+
+SVDEF const sv_charset *sv_charset_class(int cls);
+SVDEF sv_charset sv_charset_complement(const sv_charset *set);
+SVDEF sv_charset sv_charset_from_predicate(bool (*predicate)(char));
+
+/* Table-driven counterparts of the _predicate functions below. */
+SVDEF int sv_find_left_class(StringView *sv, const sv_charset *set);
+SVDEF int sv_starts_with_class(StringView *sv, const sv_charset *set);
+SVDEF int sv_ends_with_class(StringView *sv, const sv_charset *set);
+
+/* Offsets of every line start in a text, for line <-> position lookups.
+Lines end at '\n'; a '\r' before it is not part of the line. Line and column
+numbers are zero based. The text is not copied and must outlive the index. */
+typedef struct sv_line_index
+{
+	StringView text;
+	size_t *line_starts;
+	size_t line_count;
+} sv_line_index;
+
+typedef struct sv_line_pos
+{
+	size_t line;
+	size_t column;
+} sv_line_pos;
+
+SVDEF int sv_line_index_build(sv_line_index *index, StringView text);
+SVDEF void sv_line_index_free(sv_line_index *index);
+SVDEF StringView sv_line_index_line(const sv_line_index *index, size_t line);
+SVDEF bool sv_line_index_locate(const sv_line_index *index, const char *ptr, sv_line_pos *pos);
+
+/* Runs callback on every record of a large buffer from a pool of threads.
+Records are what repeated sv_split_left calls produce, except that the last
+record does not need a trailing delimiter. Order across threads is unspecified.
+With hooks, thread_init creates per-thread state passed to every callback as
+local, and thread_reduce folds it into ctx (calls are serialized). POSIX
+builds use pthreads (link with -pthread); others run on the calling thread. */
+typedef void (*sv_record_callback)(StringView record, void *local, void *ctx);
+
+typedef struct sv_parallel_hooks
+{
+	void *(*thread_init)(void *ctx);
+	void (*thread_reduce)(void *local, void *ctx);
+} sv_parallel_hooks;
+
+SVDEF int sv_parallel_for_each_record(StringView buffer, char delim, size_t nthreads,
+									  sv_record_callback callback, void *ctx);
+SVDEF int sv_parallel_for_each_record_reduce(StringView buffer, char delim, size_t nthreads,
+											 sv_record_callback callback, const sv_parallel_hooks *hooks, void *ctx);
+
+SVDEF int sv_find_left_sv(StringView *sv, StringView needle);
+SVDEF int sv_find_right_sv(StringView *sv, StringView needle);
+SVDEF StringView sv_split_left_sv(StringView *sv, StringView delim);
+SVDEF int sv_find_left_sv_icase(StringView *sv, StringView needle);
+
+/* Needle compiled once for many searches. The algorithm is chosen by needle
+length: single byte scan, packed SIMD compare up to 16 bytes, Horspool with a
+Two-Way fallback above that. The needle is not copied and must outlive it. */
+typedef struct sv_searcher
+{
+	StringView needle;
+	int kind;
+	unsigned char packed[16];
+	uint32_t packed_mask;
+	ptrdiff_t twoway_ell;
+	ptrdiff_t twoway_period;
+	bool twoway_periodic;
+	size_t shift[256];
+} sv_searcher;
+
+SVDEF void sv_searcher_init(sv_searcher *searcher, StringView needle);
+SVDEF int sv_searcher_find(const sv_searcher *searcher, StringView haystack);
+SVDEF size_t sv_searcher_count(const sv_searcher *searcher, StringView haystack);
+
+/* Aho-Corasick automaton over a set of patterns, reporting (pattern index,
+start offset) for matches in one pass over the haystack. Root transitions are
+a dense 256-entry table, all other states keep sorted sparse edge lists.
+Empty patterns never match; duplicate patterns report the lowest index. */
+typedef struct sv_match
+{
+	size_t pattern;
+	size_t offset;
+} sv_match;
+
+/* Return false to stop the scan. */
+typedef bool (*sv_match_callback)(sv_match match, void *ctx);
+
+enum
+{
+	SV_MATCH_ALL = 0,			   /* every occurrence, overlapping ones included */
+	SV_MATCH_LEFTMOST_LONGEST = 1, /* non-overlapping, leftmost start, longest pattern */
+};
+
+typedef struct sv_multimatch
+{
+	uint32_t root[256];
+	uint32_t *edge_start;
+	uint16_t *edge_count;
+	unsigned char *edge_labels;
+	uint32_t *edge_targets;
+	uint32_t *fail;
+	uint32_t *depth;
+	uint32_t *output;
+	uint32_t *output_link;
+	size_t state_count;
+	size_t pattern_count;
+} sv_multimatch;
+
+SVDEF int sv_multimatch_build(sv_multimatch *mm, const StringView *patterns, size_t count);
+SVDEF void sv_multimatch_free(sv_multimatch *mm);
+SVDEF size_t sv_multimatch_scan(const sv_multimatch *mm, StringView haystack, int mode,
+								sv_match_callback callback, void *ctx);
+
+/* Bump-pointer allocator for owned copies of views. Memory comes in blocks of
+block_size bytes (1 MiB when 0); a larger request gets a block of its own.
+Nothing is freed one by one: rewind to a mark or reset drops everything
+allocated since, and sv_arena_free releases the blocks. A zeroed sv_arena is a
+valid empty arena with default settings. */
+enum
+{
+	SV_ARENA_HUGEPAGES = 1 << 0, /* map blocks and ask for transparent huge pages */
+};
+
+typedef struct sv_arena
+{
+	struct sv__arena_block *block; /* newest block */
+	char *ptr;
+	char *end;
+	size_t block_size;
+	int flags;
+} sv_arena;
+
+typedef struct sv_arena_mark
+{
+	struct sv__arena_block *block;
+	char *ptr;
+} sv_arena_mark;
+
+SVDEF void sv_arena_init(sv_arena *arena, size_t block_size, int flags);
+SVDEF void sv_arena_free(sv_arena *arena);
+SVDEF void *sv_arena_alloc(sv_arena *arena, size_t size, size_t align);
+SVDEF StringView sv_arena_dup(sv_arena *arena, StringView sv);
+SVDEF sv_arena_mark sv_arena_get_mark(const sv_arena *arena);
+SVDEF void sv_arena_rewind(sv_arena *arena, sv_arena_mark mark);
+SVDEF void sv_arena_reset(sv_arena *arena);
+
+/* Growable output buffer. Short results stay in the inline buffer; past that
+the heap buffer at least doubles on every growth, so appends are amortized
+O(1). The contents are always followed by a '\0'. An append that runs out of
+memory sets error and leaves the contents as they were; later appends do
+nothing until sv_builder_clear. A zeroed sv_builder is a valid empty builder. */
+typedef struct sv_builder
+{
+	char *heap; /* NULL while the inline buffer is used */
+	size_t len;
+	size_t capacity;
+	int error;
+	char small[48];
+} sv_builder;
+
+SVDEF void sv_builder_init(sv_builder *builder);
+SVDEF void sv_builder_free(sv_builder *builder);
+SVDEF void sv_builder_clear(sv_builder *builder);
+SVDEF int sv_builder_reserve(sv_builder *builder, size_t extra);
+SVDEF void sv_builder_append_sv(sv_builder *builder, StringView sv);
+SVDEF void sv_builder_append_char(sv_builder *builder, char c);
+SVDEF void sv_builder_append_repeat(sv_builder *builder, char c, size_t count);
+SVDEF void sv_builder_append_u64(sv_builder *builder, uint64_t value);
+SVDEF void sv_builder_append_i64(sv_builder *builder, int64_t value);
+SVDEF StringView sv_builder_view(const sv_builder *builder);
+
+/* Decimal integer parsing straight from a view: no terminator, no locale, no
+leading whitespace. The unsigned parsers take digits only, sv_parse_i64 an
+optional '+' or '-' first. Return 0, EINVAL when there are no digits, or
+ERANGE on overflow with value clamped to the type's limit. consumed (may be
+NULL) gets the length of the number, digits past an overflow included. */
+SVDEF int sv_parse_u64(StringView sv, uint64_t *value, size_t *consumed);
+SVDEF int sv_parse_u32(StringView sv, uint32_t *value, size_t *consumed);
+SVDEF int sv_parse_i64(StringView sv, int64_t *value, size_t *consumed);
+
+/* Correctly rounded floating-point parsing from a view, locale independent.
+Accepts [+-] digits [. digits] [e|E [+-] digits] (either digit run may be
+empty, not both) and inf, infinity, nan in any case. Return 0, EINVAL when no
+number starts the view, or ERANGE when the result overflows to infinity or a
+nonzero number underflows to zero. consumed (may be NULL) is as for integers. */
+SVDEF int sv_parse_double(StringView sv, double *value, size_t *consumed);
+SVDEF int sv_parse_float(StringView sv, float *value, size_t *consumed);
+
+/* Number formatting into caller memory, no stdio and no locale. The buffer
+must hold SV_FORMAT_*_MAX bytes; no terminator is written. The returned view
+covers the written bytes. sv_format_double gives the shortest digits that
+sv_parse_double reads back to the same value. */
+#define SV_FORMAT_U64_MAX 20
+#define SV_FORMAT_I64_MAX 20
+#define SV_FORMAT_DOUBLE_MAX 32
+SVDEF StringView sv_format_u64(char *buffer, uint64_t value);
+SVDEF StringView sv_format_i64(char *buffer, int64_t value);
+SVDEF StringView sv_format_double(char *buffer, double value);
+SVDEF void sv_builder_append_double(sv_builder *builder, double value);
+
+/* 64-bit hash of the bytes of a view (wyhash-style multiply-fold mixing).
+Keys up to 16 bytes take two overlapping loads, longer ones are mixed 48 bytes
+per step in three independent lanes. Values depend on the host byte order. */
+SVDEF uint64_t sv_hash(StringView sv);
+SVDEF uint64_t sv_hash_seeded(StringView sv, uint64_t seed);
+
+/* Open-addressing (linear probing) map from StringView keys to void * values.
+Each slot caches the key's hash and a tag of its length and first six bytes,
+so probing only reads key bytes for a likely match. Keys are not copied and
+must outlive the map. sv_map_init gives every map its own hash seed, so keys
+that collide in one map or process do not collide in the next. A zeroed
+sv_map is a valid empty map that hashes with seed 0. */
+typedef struct sv_map_slot
+{
+	uint64_t hash; /* 0 marks an empty slot */
+	uint64_t tag;
+	StringView key;
+	void *value;
+} sv_map_slot;
+
+typedef struct sv_map
+{
+	sv_map_slot *slots;
+	size_t capacity;
+	size_t count;
+	uint64_t seed;
+} sv_map;
+
+SVDEF int sv_map_init(sv_map *map, size_t expected);
+SVDEF void sv_map_free(sv_map *map);
+SVDEF int sv_map_put(sv_map *map, StringView key, void *value);
+SVDEF void **sv_map_upsert(sv_map *map, StringView key);
+SVDEF bool sv_map_get(const sv_map *map, StringView key, void **value);
+SVDEF bool sv_map_remove(sv_map *map, StringView key);
+SVDEF size_t sv_map_find_many(const sv_map *map, const StringView *keys, size_t count, void **values, bool *found);
+
+/* Interning: every distinct string gets a dense 32-bit id (0, 1, 2, ...) and
+one NUL-terminated copy in an arena, so equal ids mean equal strings. Views
+returned for an id stay valid until the table is freed. A zeroed sv_intern is
+a valid empty table. */
+#define SV_INTERN_NONE UINT32_MAX
+
+typedef struct sv_intern
+{
+	uint64_t *slots; /* hash high half << 32 | id + 1, 0 when empty */
+	size_t capacity;
+	StringView *strings; /* by id */
+	size_t count;
+	size_t strings_capacity;
+	sv_arena arena;
+} sv_intern;
+
+SVDEF int sv_intern_init(sv_intern *intern, size_t expected);
+SVDEF void sv_intern_free(sv_intern *intern);
+SVDEF uint32_t sv_intern_id(sv_intern *intern, StringView sv);
+SVDEF bool sv_intern_lookup(const sv_intern *intern, StringView sv, uint32_t *id);
+SVDEF StringView sv_intern_view(const sv_intern *intern, uint32_t id);
+
+/* Thread-safe interning. Strings are spread over shards by hash; lookups are
+lock-free, inserts lock only their shard. Ids are dense across shards. Only
+init and free must not run concurrently with other calls. Non-POSIX builds
+fall back to a single-threaded table. */
+typedef struct sv_intern_concurrent
+{
+	struct sv__intern_shared *shared;
+} sv_intern_concurrent;
+
+SVDEF int sv_intern_concurrent_init(sv_intern_concurrent *intern);
+SVDEF void sv_intern_concurrent_free(sv_intern_concurrent *intern);
+SVDEF uint32_t sv_intern_concurrent_id(sv_intern_concurrent *intern, StringView sv);
+SVDEF bool sv_intern_concurrent_lookup(const sv_intern_concurrent *intern, StringView sv, uint32_t *id);
+SVDEF StringView sv_intern_concurrent_view(const sv_intern_concurrent *intern, uint32_t id);
+SVDEF size_t sv_intern_concurrent_count(const sv_intern_concurrent *intern);
 
-StringView sv_from_cstr(char *cstr);
-StringView sv_construct(char *cstr, size_t len);
+/* RFC 4180 records, one per sv_csv_next call, from a buffer or a reader.
+Quotes, delimiters and newlines are found 64 bytes at a time and quoted
+regions resolved with a prefix xor of the quote mask, so a delimiter or
+newline between quotes does not split. Records end at '\n' (a '\r' before it
+is dropped). Quoted fields come out without their quotes; only a quoted field
+with doubled quotes is copied, unescaped, into scratch memory. Every quote
+toggles the quoted state, as in other bitmask parsers: a stray quote inside an
+unquoted field starts a quoted region, and the field is returned as it is.
+fields stay valid until the next call.
+A reader must outlive the sv_csv and is read only through it. */
+typedef struct sv_csv
+{
+	StringView *fields;
+	size_t field_count;
+	size_t field_capacity;
+	int error;
+	char delim;
+	sv_reader *reader; /* NULL for a buffer */
+	const char *data;  /* the buffer, or the reader's unconsumed bytes */
+	size_t len;
+	size_t pos;				/* start of the next record */
+	size_t scanned;			/* end of the last block loaded */
+	uint64_t pending;		/* unquoted separators of that block not handed out yet */
+	uint64_t inside;		/* all ones when the block ended inside quotes */
+	uint64_t closing_tail;	/* 1 when the block ended with a closing quote */
+	uint64_t doubled;		/* second quotes of the doubled quotes in that block */
+	char *scratch;
+	size_t scratch_capacity;
+} sv_csv;
 
-StringView sv_split_left(StringView *sv, char delim);
-StringView sv_split_right(StringView *sv, char delim);
+SVDEF void sv_csv_init(sv_csv *csv, StringView input, char delim);
+SVDEF void sv_csv_init_reader(sv_csv *csv, sv_reader *reader, char delim);
+SVDEF void sv_csv_free(sv_csv *csv);
+SVDEF bool sv_csv_next(sv_csv *csv);
 
-StringView sv_cut_left(StringView *sv, size_t num);
-StringView sv_cut_right(StringView *sv, size_t num);
+/* Three-way compare: bytes as unsigned, then a proper prefix sorts first.
+Returns <0, 0 or >0 like memcmp. sv_sort orders arr by sv_cmp (not stable)
+with a multikey quicksort over cached big-endian prefixes, so most steps
+compare integers instead of touching the strings. Returns 0 or ENOMEM, in
+which case arr is untouched. */
+SVDEF int sv_cmp(StringView sv, StringView sv_other);
+SVDEF int sv_sort(StringView *arr, size_t n);
 
-int sv_strip_left(StringView *sv);
-int sv_strip_right(StringView *sv);
+/* External sort of delimiter-separated records from in_fd to out_fd, for
+inputs larger than memory. Input is read through buffers of about
+memory bytes in total (plus ~40 bytes per record for the sort arrays); each
+full buffer becomes a run sorted with sv_sort and spilled to an unlinked file
+in tmp_dir, and the runs are k-way merged with a loser tree. Records are
+compared with sv_cmp on key(record, key_ctx), which must return a sub-range
+of record (the whole record without a key callback); records with equal keys
+come out in unspecified order. Every output record ends with delim. A zeroed
+or NULL options struct means 256 MiB, $TMPDIR (or /tmp), and one run-sorting
+thread per online CPU. Unless nthreads is 1, key is called from several
+threads at once with the same key_ctx, so it must be thread-safe. Neither fd
+is closed. Returns 0 or an errno value; ENOSYS without POSIX, and in strict
+ISO builds (-std=c11 without _POSIX_C_SOURCE) where mkstemp is not declared. */
+typedef StringView (*sv_key_callback)(StringView record, void *ctx);
 
-int sv_find_left_char(StringView *sv, char n);
-int sv_find_right_char(StringView *sv, char n);
+typedef struct sv_extsort_options
+{
+	size_t memory;
+	size_t nthreads;
+	const char *tmp_dir;
+	sv_key_callback key;
+	void *key_ctx;
+} sv_extsort_options;
 
-int sv_find_left_predicate(StringView *sv, void (*predicate)(char));
+SVDEF int sv_extsort(int in_fd, int out_fd, char delim, const sv_extsort_options *options);
 
-bool sv_starts_with(StringView sv, StringView sv_other);
-bool sv_ends_with(StringView sv, StringView sv_other);
+/* ASCII case-insensitive versions: 'A'..'Z' match 'a'..'z', every other byte
+(UTF-8 included) must be equal. No locale, no copies. */
+SVDEF bool sv_compare_icase(StringView sv, StringView sv_other);
+SVDEF bool sv_starts_with_icase(StringView sv, StringView sv_other);
+SVDEF bool sv_ends_with_icase(StringView sv, StringView sv_other);
 
-int sv_starts_with_predicate(StringView *sv, bool (*predicate)(char));
-int sv_ends_with_predicate(StringView *sv, bool (*predicate)(char));
+/* ASCII transforms into caller memory, no locale. out must hold sv.len bytes
+and may be sv.data itself; memory from sv_arena_alloc(arena, sv.len, 1) works
+too. The result is a view of out. sv_translate_into replaces every byte b by
+map[b]. sv_squeeze_into writes one replacement for each run of bytes in set
+("a \t b" with SV_CLASS_SPACE and ' ' gives "a b"), so it can be shorter. */
+SVDEF StringView sv_to_lower_into(StringView sv, char *out);
+SVDEF StringView sv_to_upper_into(StringView sv, char *out);
+SVDEF StringView sv_translate_into(StringView sv, const unsigned char map[256], char *out);
+SVDEF StringView sv_squeeze_into(StringView sv, const sv_charset *set, char replacement, char *out);
 
-bool sv_whitespace_predicate(char n);
+/* UTF-8 validation per RFC 3629 (no overlongs, surrogates or code points past
+U+10FFFF), 64 bytes per step with a fast path for pure ASCII blocks.
+sv_utf8_validate sets error_offset (may be NULL) to the start of the first
+invalid or truncated sequence, or to sv.len when it returns true. The
+validator takes a stream in chunks of any size, e.g. what sv_reader_peek
+shows before each consume; a sequence split across chunks is carried over and
+error_offset counts from the start of the stream. */
+typedef struct sv_utf8_validator
+{
+	size_t offset;			  /* bytes fed so far */
+	size_t error_offset;	  /* valid once a call returned false */
+	unsigned char pending[4]; /* sequence cut off by the end of the last chunk */
+	size_t pending_len;
+	bool failed;
+} sv_utf8_validator;
 
-bool sv_compare(StringView sv, StringView sv_other);
+SVDEF bool sv_utf8_validate(StringView sv, size_t *error_offset);
+SVDEF void sv_utf8_validator_init(sv_utf8_validator *validator);
+SVDEF bool sv_utf8_validator_feed(sv_utf8_validator *validator, StringView chunk);
+SVDEF bool sv_utf8_validator_finish(sv_utf8_validator *validator);
 
 #define StringViewFormat "%.*s"
 #define StringViewNull sv_construct(NULL, 0)
 #define StringViewFromStr(liter) (sv_construct(liter, strlen(liter)))
 
+static inline size_t sv__swar_find(const char *data, size_t len, unsigned char delim)
+{
+	/*Offset of the first delim in data, or len. Eight bytes per step; a word
+	with a hit is rescanned bytewise, so the result does not depend on endianness.*/
+	const uint64_t ones = 0x0101010101010101ULL;
+	const uint64_t pattern = ones * delim;
+	size_t i = 0;
+	for (; i + 8 <= len; i += 8)
+	{
+		uint64_t word;
+		memcpy(&word, data + i, 8);
+		word ^= pattern;
+		if ((word - ones) & ~word & (ones << 7))
+			break;
+	}
+	for (; i < len; i++)
+	{
+		if ((unsigned char)data[i] == delim)
+			return i;
+	}
+	return len;
+}
+
+/* SV_DEFINE_SPLITTER(name, delim) emits StringView name(StringView *sv) with
+the delimiter baked in as a constant. It returns the piece before the first
+delim and drops it and the delim from sv; unlike sv_split_left, the last piece
+consumes the rest, so `while (sv.len) name(&sv);` terminates. */
+#define SV_DEFINE_SPLITTER(name, delim)                                      \
+	static inline StringView name(StringView *sv)                            \
+	{                                                                        \
+		size_t n = sv__swar_find(sv->data, sv->len, (unsigned char)(delim)); \
+		StringView piece = {.len = n, .data = sv->data};                     \
+		size_t skip = n < sv->len ? n + 1 : n;                               \
+		sv->data += skip;                                                    \
+		sv->len -= skip;                                                     \
+		return piece;                                                        \
+	}
+
+/* SV_DEFINE_SCANNER(name, expr) emits int name(StringView *sv) returning the
+offset of the first byte for which expr holds, or -1. expr sees the byte as
+`unsigned char c`, e.g. SV_DEFINE_SCANNER(find_sep, c == ',' || c == ';').
+expr is evaluated for whole 32-byte blocks into a hit array without an early
+exit, which the compiler vectorizes; the block with a hit is rescanned
+bytewise. expr must not have side effects. */
+#define SV_DEFINE_SCANNER(name, expr)                                 \
+	static inline int name(StringView *sv)                            \
+	{                                                                 \
+		size_t i = 0;                                                 \
+		for (; i + 32 <= sv->len; i += 32)                            \
+		{                                                             \
+			unsigned char hits[32];                                   \
+			for (size_t j = 0; j < 32; j++)                           \
+			{                                                         \
+				unsigned char c = (unsigned char)sv->data[i + j];     \
+				hits[j] = (expr) ? 1 : 0;                             \
+			}                                                         \
+			uint64_t any[4];                                          \
+			memcpy(any, hits, sizeof(hits));                          \
+			if (any[0] | any[1] | any[2] | any[3])                    \
+				break;                                                \
+		}                                                             \
+		for (; i < sv->len; i++)                                      \
+		{                                                             \
+			unsigned char c = (unsigned char)sv->data[i];             \
+			if (expr)                                                 \
+				return i;                                             \
+		}                                                             \
+		return -1;                                                    \
+	}
+
 #endif
 
 #ifdef SV_IMPLEMENTATION
@@ -55,244 +610,6580 @@ bool sv_compare(StringView sv, StringView sv_other);
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <float.h>
+#include <time.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SV_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#endif
+
+/* mkstemp is POSIX.1-2008/XSI; glibc hides it in strict ISO builds (-std=c11),
+where sv_extsort cannot spill runs and reports ENOSYS instead. */
+#if defined(SV_POSIX) &&                                                                                    \
+	(defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__) ||          \
+	 (defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200809L) || (defined(_XOPEN_SOURCE) && _XOPEN_SOURCE >= 500))
+#define SV__HAS_MKSTEMP 1
+#endif
+
+/* SIMD kernels are compiled per function with target attributes and picked
+at startup from what the CPU reports, so the header builds without any -m flags.
+Define SV_NO_SIMD to keep only the scalar loops. */
+#if !defined(SV_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SV_X86_DISPATCH 1
+#include <immintrin.h>
+#define SV__TARGET(isa) __attribute__((target(isa)))
+#endif
 
-char *read_file_cstr(char *filename)
+static const char *sv__find_char_scalar(const char *data, size_t len, char n)
 {
-	/*Read whole file and returns string C style NULL terminated.
-	Also enshures that new line and return are added at the end of the file.
-	The string is malloc-ed and need to be freed after.*/
-	FILE *f = fopen(filename, "rb");
-	if (f == NULL)
+	for (size_t i = 0; i < len; i++)
 	{
-		printf("Could not open file!");
-		exit(1);
+		if (data[i] == n)
+			return data + i;
 	}
-	fseek(f, 0, SEEK_END);
-	long fsize = ftell(f);
-	fseek(f, 0, SEEK_SET); /* same as rewind(f); */
+	return NULL;
+}
 
-	char *string = malloc((fsize + 3) * sizeof(char));
-	fread(string, fsize, 1, f);
-	fclose(f);
+static const char *sv__rfind_char_scalar(const char *data, size_t len, char n)
+{
+	for (size_t i = len; i > 0; i--)
+	{
+		if (data[i - 1] == n)
+			return data + i - 1;
+	}
+	return NULL;
+}
 
-	// Guarantee that the file ends with carrage return, newline. Null termination. BS.
-	if ((string[fsize - 1] != '\n') && (string[fsize - 2] != '\r'))
+static inline bool sv__charset_test(const sv_charset *set, unsigned char b)
+{
+	return (set->rows[((b >> 7) << 4) | (b & 15)] >> ((b >> 4) & 7)) & 1;
+}
+
+// Precomputed in the sv_charset layout; every class is ASCII only, so the
+// rows for bytes >= 0x80 stay zero.
+static const sv_charset sv__class_sets[SV_CLASS_COUNT] = {
+	[SV_CLASS_SPACE] = {{0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00}},
+	[SV_CLASS_DIGIT] = {{0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+	[SV_CLASS_ALPHA] = {{0xa0, 0xf0, 0xf0, 0xf0, 0xf0, 0xf0, 0xf0, 0xf0, 0xf0, 0xf0, 0xf0, 0x50, 0x50, 0x50, 0x50, 0x50}},
+	[SV_CLASS_ALNUM] = {{0xa8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf0, 0x50, 0x50, 0x50, 0x50, 0x50}},
+	[SV_CLASS_XDIGIT] = {{0x08, 0x58, 0x58, 0x58, 0x58, 0x58, 0x58, 0x08, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+	[SV_CLASS_UPPER] = {{0x20, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x10, 0x10, 0x10, 0x10, 0x10}},
+	[SV_CLASS_LOWER] = {{0x80, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40}},
+	[SV_CLASS_PUNCT] = {{0x50, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0c, 0xac, 0xac, 0xac, 0xac, 0x2c}},
+};
+
+static const char *sv__find_any_scalar(const char *data, size_t len, const sv_charset *set)
+{
+	for (size_t i = 0; i < len; i++)
 	{
-		string[fsize] = 13;
-		string[fsize + 1] = 10;
-		string[fsize + 2] = 0;
+		if (sv__charset_test(set, data[i]))
+			return data + i;
 	}
-	else
+	return NULL;
+}
+
+static const char *sv__rfind_any_scalar(const char *data, size_t len, const sv_charset *set)
+{
+	for (size_t i = len; i > 0; i--)
 	{
-		string[fsize] = 0;
-		string[fsize + 1] = 0;
-		string[fsize + 2] = 0;
+		if (sv__charset_test(set, data[i - 1]))
+			return data + i - 1;
 	}
-	return string;
+	return NULL;
 }
 
-StringView sv_from_cstr(char *cstr)
-{ /*Maybe not needed...*/
-	size_t len = strlen(cstr);
-	StringView sv = {.data = cstr, .len = len};
-	return sv;
+static uint64_t sv__eq_mask64_scalar(const char *data, char n)
+{
+	/*Bit i is set when data[i] == n, for the 64 bytes at data.*/
+	uint64_t mask = 0;
+	for (int i = 0; i < 64; i++)
+		mask |= (uint64_t)(data[i] == n) << i;
+	return mask;
 }
 
-StringView sv_construct(char *cstr, size_t len)
+static uint64_t sv__csv_mask64_scalar(const char *data, char delim, uint64_t *quotes)
 {
-	StringView sv;
-	sv.len = len;
-	sv.data = cstr;
-	return sv;
+	/*For the 64 bytes at data: quote bits into *quotes, delimiter and newline
+	bits returned.*/
+	uint64_t q = 0, separators = 0;
+	for (int i = 0; i < 64; i++)
+	{
+		q |= (uint64_t)(data[i] == '"') << i;
+		separators |= (uint64_t)(data[i] == delim || data[i] == '\n') << i;
+	}
+	*quotes = q;
+	return separators;
 }
 
-StringView sv_split_left(StringView *sv, char delim)
+static uint64_t sv__prefix_xor_scalar(uint64_t x)
 {
-	if (sv->len <= 0)
-		return StringViewNull;
-	int n = sv_find_left_char(sv, delim);
-	if (n < 0)
-		return *sv;
+	/*Bit i becomes the xor of bits 0..i: applied to a quote mask, set from an
+	opening quote up to (not including) its closing one.*/
+	x ^= x << 1;
+	x ^= x << 2;
+	x ^= x << 4;
+	x ^= x << 8;
+	x ^= x << 16;
+	x ^= x << 32;
+	return x;
+}
 
-	StringView piece = {.data = sv->data, .len = n};
+static inline unsigned char sv__fold(unsigned char c)
+{
+	/*ASCII lowercase: only 'A'..'Z' change, every other byte maps to itself.*/
+	return (unsigned char)(c - 'A') < 26 ? c | 0x20 : c;
+}
 
-	sv->data = sv->data + n + 1;
-	sv->len = sv->len - n - 1;
-	return piece;
+static inline uint64_t sv__flip_case_swar(uint64_t x, unsigned char first)
+{
+	/*Flips the 0x20 bit of the bytes of x in [first, first + 26), 'A' or 'a'.
+	The range checks run on the low seven bits, so nothing carries between
+	bytes; bytes with the top bit are kept.*/
+	const uint64_t high = 0x8080808080808080ULL, ones = 0x0101010101010101ULL;
+	uint64_t low7 = x & ~high;
+	uint64_t at_least_first = low7 + ones * (0x80 - first);
+	uint64_t past_last = low7 + ones * (0x80 - first - 26);
+	uint64_t letters = at_least_first & ~past_last & ~x & high;
+	return x ^ (letters >> 2);
 }
 
-StringView sv_split_right(StringView *sv, char delim)
+static inline uint64_t sv__fold_swar(uint64_t x)
 {
-	if (sv->len <= 0)
-		return StringViewNull;
-	int n = sv_find_right_char(sv, delim);
-	if (n < 0)
-		return StringViewNull;
+	/*sv__fold on the eight bytes of x.*/
+	return sv__flip_case_swar(x, 'A');
+}
 
-	StringView piece = {.data = sv->data + n + 1, .len = sv->len - n - 1};
+/* Two-Way string matching (Crochemore-Perrin): linear time, constant space.
+Used on its own by the scalar level and as the worst-case fallback of the
+SIMD filters. With reversed set, needle and haystack are both read back to
+front, which turns the search for the first match into one for the last. */
+typedef struct sv__twoway
+{
+	const unsigned char *needle;
+	ptrdiff_t len;
+	ptrdiff_t ell;
+	ptrdiff_t period;
+	bool periodic;
+	bool reversed;
+	bool fold; /* compare with ASCII case folded */
+} sv__twoway;
 
-	sv->len = n;
-	return piece;
+static inline unsigned char sv__twoway_at(const unsigned char *p, ptrdiff_t len, ptrdiff_t i, bool reversed, bool fold)
+{
+	unsigned char c = reversed ? p[len - 1 - i] : p[i];
+	return fold ? sv__fold(c) : c;
 }
 
-StringView sv_cut_left(StringView *sv, size_t num)
+static ptrdiff_t sv__maximal_suffix(const unsigned char *x, ptrdiff_t m, bool reversed, bool fold, bool tilde,
+									ptrdiff_t *period)
 {
-	if ((sv->len <= 0) | (num <= 0))
-		return StringViewNull;
+	ptrdiff_t ms = -1, j = 0, k = 1, p = 1;
+	while (j + k < m)
+	{
+		unsigned char a = sv__twoway_at(x, m, j + k, reversed, fold);
+		unsigned char b = sv__twoway_at(x, m, ms + k, reversed, fold);
+		if (tilde ? a > b : a < b)
+		{
+			j += k;
+			k = 1;
+			p = j - ms;
+		}
+		else if (a == b)
+		{
+			if (k != p)
+			{
+				k++;
+			}
+			else
+			{
+				j += p;
+				k = 1;
+			}
+		}
+		else
+		{
+			ms = j;
+			j = ms + 1;
+			k = p = 1;
+		}
+	}
+	*period = p;
+	return ms;
+}
 
-	StringView piece;
-	if (num > sv->len)
+static void sv__twoway_prepare(sv__twoway *tw, const char *needle, size_t len, bool reversed, bool fold)
+{
+	const unsigned char *x = (const unsigned char *)needle;
+	ptrdiff_t m = len, p, q;
+	ptrdiff_t i = sv__maximal_suffix(x, m, reversed, fold, false, &p);
+	ptrdiff_t j = sv__maximal_suffix(x, m, reversed, fold, true, &q);
+	tw->needle = x;
+	tw->len = m;
+	tw->reversed = reversed;
+	tw->fold = fold;
+	tw->ell = i > j ? i : j;
+	tw->period = i > j ? p : q;
+
+	tw->periodic = true;
+	for (ptrdiff_t k = 0; k <= tw->ell; k++)
 	{
-		piece.data = sv->data;
-		piece.len = sv->len;
-		*sv = StringViewNull;
+		if (sv__twoway_at(x, m, k, reversed, fold) != sv__twoway_at(x, m, k + tw->period, reversed, fold))
+		{
+			tw->periodic = false;
+			break;
+		}
 	}
-	else
+	if (!tw->periodic)
 	{
-		piece.data = sv->data;
-		piece.len = num;
-
-		sv->data = sv->data + num;
-		sv->len = sv->len - num;
+		ptrdiff_t left = tw->ell + 1, right = m - tw->ell - 1;
+		tw->period = (left > right ? left : right) + 1;
 	}
-	return piece;
 }
 
-StringView sv_cut_right(StringView *sv, size_t num)
+static size_t sv__twoway_search(const sv__twoway *tw, const char *haystack, size_t len)
 {
-	if ((sv->len <= 0) | (num <= 0))
-		return StringViewNull;
+	/*Offset of the first match (last one when reversed), or SIZE_MAX.*/
+	const unsigned char *x = tw->needle, *y = (const unsigned char *)haystack;
+	const ptrdiff_t m = tw->len, n = len, ell = tw->ell, per = tw->period;
+	const bool rev = tw->reversed, fold = tw->fold;
+	if (m > n)
+		return SIZE_MAX;
 
-	StringView piece;
-	if (num > sv->len)
+	ptrdiff_t j = 0, i;
+	if (tw->periodic)
 	{
-		piece.data = sv->data;
-		piece.len = sv->len;
-		*sv = StringViewNull;
+		ptrdiff_t memory = -1;
+		while (j <= n - m)
+		{
+			i = (ell > memory ? ell : memory) + 1;
+			while (i < m && sv__twoway_at(x, m, i, rev, fold) == sv__twoway_at(y, n, i + j, rev, fold))
+				i++;
+			if (i >= m)
+			{
+				i = ell;
+				while (i > memory && sv__twoway_at(x, m, i, rev, fold) == sv__twoway_at(y, n, i + j, rev, fold))
+					i--;
+				if (i <= memory)
+					return rev ? (size_t)(n - m - j) : (size_t)j;
+				j += per;
+				memory = m - per - 1;
+			}
+			else
+			{
+				j += i - ell;
+				memory = -1;
+			}
+		}
 	}
 	else
 	{
-		piece.data = sv->data + sv->len - num;
-		piece.len = num;
-		sv->data = sv->data;
-		sv->len = sv->len - num;
+		while (j <= n - m)
+		{
+			i = ell + 1;
+			while (i < m && sv__twoway_at(x, m, i, rev, fold) == sv__twoway_at(y, n, i + j, rev, fold))
+				i++;
+			if (i >= m)
+			{
+				i = ell;
+				while (i >= 0 && sv__twoway_at(x, m, i, rev, fold) == sv__twoway_at(y, n, i + j, rev, fold))
+					i--;
+				if (i < 0)
+					return rev ? (size_t)(n - m - j) : (size_t)j;
+				j += per;
+			}
+			else
+			{
+				j += i - ell;
+			}
+		}
 	}
-	return piece;
+	return SIZE_MAX;
 }
 
-int sv_find_left_char(StringView *sv, char n)
+static const char *sv__find_sv_scalar(const char *data, size_t len, const char *needle, size_t needle_len)
 {
-	for (size_t i = 0; i < sv->len; i++)
-	{
-		if (sv->data[i] == n)
-			return i;
-	}
-	return -1;
+	sv__twoway tw;
+	sv__twoway_prepare(&tw, needle, needle_len, false, false);
+	size_t pos = sv__twoway_search(&tw, data, len);
+	return pos == SIZE_MAX ? NULL : data + pos;
+}
+
+static const char *sv__rfind_sv_scalar(const char *data, size_t len, const char *needle, size_t needle_len)
+{
+	sv__twoway tw;
+	sv__twoway_prepare(&tw, needle, needle_len, true, false);
+	size_t pos = sv__twoway_search(&tw, data, len);
+	return pos == SIZE_MAX ? NULL : data + pos;
 }
 
-int sv_find_right_char(StringView *sv, char n)
+static bool sv__equal_icase_scalar(const char *a, const char *b, size_t len)
 {
-	for (int i = sv->len - 1; i >= 0; i--)
+	/*Equality with ASCII case folded, eight bytes per step.*/
+	size_t i = 0;
+	for (; i + 8 <= len; i += 8)
 	{
-		if (sv->data[i] == n)
-			return i;
+		uint64_t x, y;
+		memcpy(&x, a + i, 8);
+		memcpy(&y, b + i, 8);
+		if (sv__fold_swar(x) != sv__fold_swar(y))
+			return false;
+	}
+	for (; i < len; i++)
+	{
+		if (sv__fold(a[i]) != sv__fold(b[i]))
+			return false;
 	}
-	return -1;
+	return true;
+}
+
+static const char *sv__find_sv_icase_scalar(const char *data, size_t len, const char *needle, size_t needle_len)
+{
+	sv__twoway tw;
+	sv__twoway_prepare(&tw, needle, needle_len, false, true);
+	size_t pos = sv__twoway_search(&tw, data, len);
+	return pos == SIZE_MAX ? NULL : data + pos;
 }
 
-int sv_find_left_predicate(StringView *sv, bool (*predicate)(char))
+static void sv__flip_case_scalar(const char *in, size_t len, char *out, unsigned char first)
 {
+	/*Flips the case of the ASCII letters from first ('A' lowers, 'a' uppers),
+	eight bytes per step.*/
+	size_t i = 0;
+	for (; i + 8 <= len; i += 8)
 	{
-		for (int i = 0; i < sv->len; i++)
-			if ((*predicate)(sv->data[i]))
-				return i;
-		return -1;
+		uint64_t x;
+		memcpy(&x, in + i, 8);
+		x = sv__flip_case_swar(x, first);
+		memcpy(out + i, &x, 8);
+	}
+	for (; i < len; i++)
+	{
+		unsigned char c = in[i];
+		out[i] = (unsigned char)(c - first) < 26 ? c ^ 0x20 : c;
 	}
 }
 
-#define WHITESPACE_SYMBOLS " \t\r\n"
-#define WHITESPACE_SYMBOLS_LEN sizeof(WHITESPACE_SYMBOLS)
-bool sv_whitespace_predicate(char n)
+static void sv__translate_scalar(const char *in, size_t len, char *out, const unsigned char *map)
 {
-	for (size_t i = 0; i < WHITESPACE_SYMBOLS_LEN; ++i)
+	size_t i = 0;
+	for (; i + 4 <= len; i += 4)
 	{
-		if (n == WHITESPACE_SYMBOLS[i])
-			return true;
+		unsigned char a = map[(unsigned char)in[i]], b = map[(unsigned char)in[i + 1]];
+		unsigned char c = map[(unsigned char)in[i + 2]], d = map[(unsigned char)in[i + 3]];
+		out[i] = a;
+		out[i + 1] = b;
+		out[i + 2] = c;
+		out[i + 3] = d;
 	}
-	return false;
+	for (; i < len; i++)
+		out[i] = map[(unsigned char)in[i]];
 }
 
-int sv_strip_left(StringView *sv)
+static inline size_t sv__squeeze_bytes(const char *in, size_t len, char *out, const sv_charset *set,
+									   uint64_t members, uint64_t *run, char replacement)
 {
-	int num_spaces = sv_starts_with_predicate(sv, sv_whitespace_predicate);
-	sv_cut_left(sv, num_spaces);
-	return num_spaces;
+	/*Branch-free squeeze of len <= 64 bytes: every byte is written, and the
+	output only advances past a member when it starts a run. members has the
+	membership bits when set is NULL. *run carries "last byte was a member"
+	across calls. out may be in: out never gets ahead of in.*/
+	size_t o = 0;
+	uint64_t prev = *run;
+	for (size_t j = 0; j < len; j++)
+	{
+		uint64_t member = set ? sv__charset_test(set, in[j]) : (members >> j) & 1;
+		char c = in[j];
+		out[o] = member ? replacement : c;
+		o += !(member & prev);
+		prev = member;
+	}
+	*run = prev;
+	return o;
 }
 
-int sv_strip_right(StringView *sv)
+static size_t sv__squeeze_scalar(const char *in, size_t len, char *out, const sv_charset *set, char replacement)
 {
-	int num_spaces = sv_ends_with_predicate(sv, sv_whitespace_predicate);
-	sv_cut_right(sv, num_spaces);
-	return num_spaces;
+	uint64_t run = 0;
+	return sv__squeeze_bytes(in, len, out, set, 0, &run, replacement);
 }
 
-bool sv_starts_with(StringView sv, StringView sv_other)
+static inline size_t sv__utf8_sequence_len(unsigned char lead)
 {
-	if (sv.len < sv_other.len)
-		return false;
-	int res = memcmp(sv.data, sv_other.data, sv_other.len);
-	return (bool)(res == 0);
+	/*Bytes announced by a lead byte; 1 for ASCII and for bytes that cannot
+	start a sequence.*/
+	return lead >= 0xF0 ? (lead < 0xF8 ? 4 : 1) : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
 }
 
-int sv_starts_with_predicate(StringView *sv, bool (*predicate)(char))
+static size_t sv__utf8_valid_scalar(const char *data, size_t len)
 {
-	if (sv->len == 0)
-		return 0;
-	int count = 0;
+	/*Length of the longest prefix of whole, valid sequences, i.e. the offset
+	of the first sequence that is invalid or cut off by the end. Overlongs,
+	surrogates and code points past U+10FFFF are invalid.*/
+	const unsigned char *s = (const unsigned char *)data;
 	size_t i = 0;
-	char n = sv->data[i];
-	while (predicate(n))
+	while (i < len)
 	{
-		count += 1;
-		i += 1;
-		n = sv->data[i];
+		uint64_t word;
+		if (len - i >= 8 && (memcpy(&word, s + i, 8), (word & 0x8080808080808080ULL) == 0))
+		{
+			i += 8;
+			continue;
+		}
+		unsigned char c = s[i];
+		if (c < 0x80)
+		{
+			i++;
+			continue;
+		}
+		size_t n = sv__utf8_sequence_len(c);
+		unsigned char lo = 0x80, hi = 0xBF;
+		if (c == 0xE0)
+			lo = 0xA0;
+		else if (c == 0xED)
+			hi = 0x9F;
+		else if (c == 0xF0)
+			lo = 0x90;
+		else if (c == 0xF4)
+			hi = 0x8F;
+		if (c < 0xC2 || c > 0xF4 || len - i < n || s[i + 1] < lo || s[i + 1] > hi)
+			return i;
+		for (size_t k = 2; k < n; k++)
+			if ((s[i + k] & 0xC0) != 0x80)
+				return i;
+		i += n;
 	}
-	return count;
+	return i;
 }
 
-bool sv_ends_with(StringView sv, StringView sv_other)
+/* The SIMD substring filters verify candidates with memcmp, which is quadratic
+on inputs like "aaaa...ab" in "aaaa...". Once verification work exceeds a few
+times the bytes covered so far they hand the rest over to Two-Way. */
+static inline bool sv__find_sv_over_budget(size_t verified, size_t covered)
 {
-	if (sv.len < sv_other.len)
-		return false;
-	int diff = sv.len - sv_other.len;
-	int res = memcmp(sv.data + diff, sv_other.data, sv_other.len);
-	return (bool)res == 0;
+	return verified > 8 * covered + 4096;
 }
 
-int sv_ends_with_predicate(StringView *sv, bool (*predicate)(char))
+enum
 {
-	if (sv->len == 0)
-		return 0;
-	// int count = 0;
-	// size_t i = sv->len;
-	// char n = sv->data[i];
-	// while (predicate(n))
-	// {
-	// 	count += 1;
-	// 	i -= 1;
-	// 	n = sv->data[i];
-	// }
-	int count = 0;
-	for (size_t i = sv->len - 1; i >= 0 && predicate(sv->data[i]); i--)
-		count += 1;
-	return count;
+	SV__SEARCH_EMPTY,
+	SV__SEARCH_BYTE,
+	SV__SEARCH_PACKED,
+	SV__SEARCH_LONG,
+};
+
+static const char *sv__find_packed_scalar(const char *data, size_t len, const sv_searcher *searcher)
+{
+	const char *needle = searcher->needle.data;
+	size_t needle_len = searcher->needle.len;
+	while (len >= needle_len)
+	{
+		const char *hit = sv__find_char_scalar(data, len - needle_len + 1, needle[0]);
+		if (hit == NULL)
+			return NULL;
+		if (memcmp(hit + 1, needle + 1, needle_len - 1) == 0)
+			return hit;
+		len -= hit + 1 - data;
+		data = hit + 1;
+	}
+	return NULL;
 }
 
-bool sv_compare(StringView sv, StringView sv_other)
+#ifdef SV_X86_DISPATCH
+SV__TARGET("sse2")
+static const char *sv__find_char_sse2(const char *data, size_t len, char n)
 {
-	/*Compares two string views.*/
+	if (len < 16)
+		return sv__find_char_scalar(data, len, n);
+	const __m128i needle = _mm_set1_epi8(n);
+	size_t i = 0;
+	for (; i + 16 <= len; i += 16)
+	{
+		unsigned hits = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + i)), needle));
+		if (hits)
+			return data + i + __builtin_ctz(hits);
+	}
+	if (i < len)
+	{
+		// Overlapping load of the last 16 bytes; the overlap is already known to be clean.
+		i = len - 16;
+		unsigned hits = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + i)), needle));
+		if (hits)
+			return data + i + __builtin_ctz(hits);
+	}
+	return NULL;
+}
+
+SV__TARGET("sse2")
+static const char *sv__rfind_char_sse2(const char *data, size_t len, char n)
+{
+	if (len < 16)
+		return sv__rfind_char_scalar(data, len, n);
+	const __m128i needle = _mm_set1_epi8(n);
+	size_t i = len;
+	while (i >= 16)
+	{
+		i -= 16;
+		unsigned hits = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + i)), needle));
+		if (hits)
+			return data + i + 31 - __builtin_clz(hits);
+	}
+	if (i > 0)
+	{
+		// Unaligned head: reload the first 16 bytes and keep only the i bytes not scanned yet.
+		unsigned hits = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)data), needle));
+		hits &= (1u << i) - 1;
+		if (hits)
+			return data + 31 - __builtin_clz(hits);
+	}
+	return NULL;
+}
+
+SV__TARGET("avx2")
+static const char *sv__find_char_avx2(const char *data, size_t len, char n)
+{
+	if (len < 32)
+		return sv__find_char_sse2(data, len, n);
+	const __m256i needle = _mm256_set1_epi8(n);
+	size_t i = 0;
+	for (; i + 64 <= len; i += 64)
+	{
+		__m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(data + i)), needle);
+		__m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(data + i + 32)), needle);
+		if (_mm256_movemask_epi8(_mm256_or_si256(a, b)))
+		{
+			unsigned hits = _mm256_movemask_epi8(a);
+			if (hits)
+				return data + i + __builtin_ctz(hits);
+			return data + i + 32 + __builtin_ctz((unsigned)_mm256_movemask_epi8(b));
+		}
+	}
+	for (; i + 32 <= len; i += 32)
+	{
+		unsigned hits = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(data + i)), needle));
+		if (hits)
+			return data + i + __builtin_ctz(hits);
+	}
+	if (i < len)
+	{
+		i = len - 32;
+		unsigned hits = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(data + i)), needle));
+		if (hits)
+			return data + i + __builtin_ctz(hits);
+	}
+	return NULL;
+}
+
+SV__TARGET("avx2")
+static const char *sv__rfind_char_avx2(const char *data, size_t len, char n)
+{
+	if (len < 32)
+		return sv__rfind_char_sse2(data, len, n);
+	const __m256i needle = _mm256_set1_epi8(n);
+	size_t i = len;
+	while (i >= 64)
+	{
+		i -= 64;
+		__m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(data + i)), needle);
+		__m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(data + i + 32)), needle);
+		if (_mm256_movemask_epi8(_mm256_or_si256(a, b)))
+		{
+			unsigned hits = _mm256_movemask_epi8(b);
+			if (hits)
+				return data + i + 32 + 31 - __builtin_clz(hits);
+			return data + i + 31 - __builtin_clz((unsigned)_mm256_movemask_epi8(a));
+		}
+	}
+	if (i >= 32)
+	{
+		i -= 32;
+		unsigned hits = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(data + i)), needle));
+		if (hits)
+			return data + i + 31 - __builtin_clz(hits);
+	}
+	if (i > 0)
+	{
+		unsigned hits = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)data), needle));
+		hits &= (1u << i) - 1;
+		if (hits)
+			return data + 31 - __builtin_clz(hits);
+	}
+	return NULL;
+}
+
+SV__TARGET("avx512f,avx512bw")
+static const char *sv__find_char_avx512(const char *data, size_t len, char n)
+{
+	const __m512i needle = _mm512_set1_epi8(n);
+	size_t i = 0;
+	for (; i + 64 <= len; i += 64)
+	{
+		__mmask64 hits = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512((const void *)(data + i)), needle);
+		if (hits)
+			return data + i + __builtin_ctzll(hits);
+	}
+	if (i < len)
+	{
+		// Masked load: lanes past the end are never touched, so no fault and no scalar tail.
+		__mmask64 live = ~0ULL >> (64 - (len - i));
+		__mmask64 hits = _mm512_mask_cmpeq_epi8_mask(live, _mm512_maskz_loadu_epi8(live, data + i), needle);
+		if (hits)
+			return data + i + __builtin_ctzll(hits);
+	}
+	return NULL;
+}
+
+SV__TARGET("avx512f,avx512bw")
+static const char *sv__rfind_char_avx512(const char *data, size_t len, char n)
+{
+	const __m512i needle = _mm512_set1_epi8(n);
+	size_t i = len;
+	while (i >= 64)
+	{
+		i -= 64;
+		__mmask64 hits = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512((const void *)(data + i)), needle);
+		if (hits)
+			return data + i + 63 - __builtin_clzll(hits);
+	}
+	if (i > 0)
+	{
+		__mmask64 live = ~0ULL >> (64 - i);
+		__mmask64 hits = _mm512_mask_cmpeq_epi8_mask(live, _mm512_maskz_loadu_epi8(live, data), needle);
+		if (hits)
+			return data + 63 - __builtin_clzll(hits);
+	}
+	return NULL;
+}
+
+SV__TARGET("sse2")
+static uint64_t sv__eq_mask64_sse2(const char *data, char n)
+{
+	const __m128i needle = _mm_set1_epi8(n);
+	uint64_t m0 = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)data), needle));
+	uint64_t m1 = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + 16)), needle));
+	uint64_t m2 = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + 32)), needle));
+	uint64_t m3 = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + 48)), needle));
+	return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+}
+
+SV__TARGET("avx2")
+static uint64_t sv__eq_mask64_avx2(const char *data, char n)
+{
+	const __m256i needle = _mm256_set1_epi8(n);
+	uint64_t lo = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)data), needle));
+	uint64_t hi = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(data + 32)), needle));
+	return lo | (hi << 32);
+}
+
+SV__TARGET("avx512f,avx512bw")
+static uint64_t sv__eq_mask64_avx512(const char *data, char n)
+{
+	return _mm512_cmpeq_epi8_mask(_mm512_loadu_si512((const void *)data), _mm512_set1_epi8(n));
+}
+
+SV__TARGET("sse2")
+static uint64_t sv__csv_mask64_sse2(const char *data, char delim, uint64_t *quotes)
+{
+	const __m128i quote = _mm_set1_epi8('"'), sep = _mm_set1_epi8(delim), newline = _mm_set1_epi8('\n');
+	uint64_t q = 0, separators = 0;
+	for (int i = 0; i < 64; i += 16)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+		q |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block, quote)) << i;
+		__m128i hit = _mm_or_si128(_mm_cmpeq_epi8(block, sep), _mm_cmpeq_epi8(block, newline));
+		separators |= (uint64_t)(unsigned)_mm_movemask_epi8(hit) << i;
+	}
+	*quotes = q;
+	return separators;
+}
+
+SV__TARGET("avx2")
+static uint64_t sv__csv_mask64_avx2(const char *data, char delim, uint64_t *quotes)
+{
+	const __m256i quote = _mm256_set1_epi8('"'), sep = _mm256_set1_epi8(delim), newline = _mm256_set1_epi8('\n');
+	__m256i lo = _mm256_loadu_si256((const __m256i *)data);
+	__m256i hi = _mm256_loadu_si256((const __m256i *)(data + 32));
+	*quotes = (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, quote)) |
+			  (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, quote)) << 32;
+	__m256i hit_lo = _mm256_or_si256(_mm256_cmpeq_epi8(lo, sep), _mm256_cmpeq_epi8(lo, newline));
+	__m256i hit_hi = _mm256_or_si256(_mm256_cmpeq_epi8(hi, sep), _mm256_cmpeq_epi8(hi, newline));
+	return (uint64_t)(unsigned)_mm256_movemask_epi8(hit_lo) | (uint64_t)(unsigned)_mm256_movemask_epi8(hit_hi) << 32;
+}
+
+SV__TARGET("avx512f,avx512bw")
+static uint64_t sv__csv_mask64_avx512(const char *data, char delim, uint64_t *quotes)
+{
+	__m512i block = _mm512_loadu_si512((const void *)data);
+	*quotes = _mm512_cmpeq_epi8_mask(block, _mm512_set1_epi8('"'));
+	return _mm512_cmpeq_epi8_mask(block, _mm512_set1_epi8(delim)) | _mm512_cmpeq_epi8_mask(block, _mm512_set1_epi8('\n'));
+}
+
+SV__TARGET("sse2,pclmul")
+static uint64_t sv__prefix_xor_clmul(uint64_t x)
+{
+	/*Carry-less multiplication by all ones is the prefix xor in one instruction.*/
+	__m128i product = _mm_clmulepi64_si128(_mm_set_epi64x(0, (long long)x), _mm_set1_epi8(-1), 0);
+	uint64_t low;
+	_mm_storel_epi64((__m128i *)&low, product);
+	return low;
+}
+
+/* Set membership for a whole block with two nibble lookups: the low nibble
+(plus the top bit, which makes pshufb return zero for the other half) picks a
+row, the high nibble picks the bit inside the row. */
+static const char sv__charset_bits[16] = {1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128};
+
+SV__TARGET("ssse3")
+static inline unsigned sv__classify_ssse3(__m128i block, __m128i rows_lo, __m128i rows_hi, __m128i bits)
+{
+	__m128i idx = _mm_and_si128(block, _mm_set1_epi8((char)0x8F));
+	__m128i row = _mm_or_si128(_mm_shuffle_epi8(rows_lo, idx),
+							   _mm_shuffle_epi8(rows_hi, _mm_xor_si128(idx, _mm_set1_epi8((char)0x80))));
+	__m128i bit = _mm_shuffle_epi8(bits, _mm_and_si128(_mm_srli_epi16(block, 4), _mm_set1_epi8(0x0F)));
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(row, bit), bit));
+}
+
+SV__TARGET("ssse3")
+static const char *sv__find_any_ssse3(const char *data, size_t len, const sv_charset *set)
+{
+	if (len < 16)
+		return sv__find_any_scalar(data, len, set);
+	const __m128i rows_lo = _mm_loadu_si128((const __m128i *)set->rows);
+	const __m128i rows_hi = _mm_loadu_si128((const __m128i *)(set->rows + 16));
+	const __m128i bits = _mm_loadu_si128((const __m128i *)sv__charset_bits);
+	size_t i = 0;
+	for (; i + 16 <= len; i += 16)
+	{
+		unsigned hits = sv__classify_ssse3(_mm_loadu_si128((const __m128i *)(data + i)), rows_lo, rows_hi, bits);
+		if (hits)
+			return data + i + __builtin_ctz(hits);
+	}
+	if (i < len)
+	{
+		i = len - 16;
+		unsigned hits = sv__classify_ssse3(_mm_loadu_si128((const __m128i *)(data + i)), rows_lo, rows_hi, bits);
+		if (hits)
+			return data + i + __builtin_ctz(hits);
+	}
+	return NULL;
+}
+
+SV__TARGET("ssse3")
+static const char *sv__rfind_any_ssse3(const char *data, size_t len, const sv_charset *set)
+{
+	if (len < 16)
+		return sv__rfind_any_scalar(data, len, set);
+	const __m128i rows_lo = _mm_loadu_si128((const __m128i *)set->rows);
+	const __m128i rows_hi = _mm_loadu_si128((const __m128i *)(set->rows + 16));
+	const __m128i bits = _mm_loadu_si128((const __m128i *)sv__charset_bits);
+	size_t i = len;
+	while (i >= 16)
+	{
+		i -= 16;
+		unsigned hits = sv__classify_ssse3(_mm_loadu_si128((const __m128i *)(data + i)), rows_lo, rows_hi, bits);
+		if (hits)
+			return data + i + 31 - __builtin_clz(hits);
+	}
+	if (i > 0)
+	{
+		unsigned hits = sv__classify_ssse3(_mm_loadu_si128((const __m128i *)data), rows_lo, rows_hi, bits);
+		hits &= (1u << i) - 1;
+		if (hits)
+			return data + 31 - __builtin_clz(hits);
+	}
+	return NULL;
+}
+
+SV__TARGET("avx2")
+static inline unsigned sv__classify_avx2(__m256i block, __m256i rows_lo, __m256i rows_hi, __m256i bits)
+{
+	__m256i idx = _mm256_and_si256(block, _mm256_set1_epi8((char)0x8F));
+	__m256i row = _mm256_or_si256(_mm256_shuffle_epi8(rows_lo, idx),
+								  _mm256_shuffle_epi8(rows_hi, _mm256_xor_si256(idx, _mm256_set1_epi8((char)0x80))));
+	__m256i bit = _mm256_shuffle_epi8(bits, _mm256_and_si256(_mm256_srli_epi16(block, 4), _mm256_set1_epi8(0x0F)));
+	return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit));
+}
+
+SV__TARGET("avx2")
+static const char *sv__find_any_avx2(const char *data, size_t len, const sv_charset *set)
+{
+	if (len < 32)
+		return sv__find_any_ssse3(data, len, set);
+	const __m256i rows_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)set->rows));
+	const __m256i rows_hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(set->rows + 16)));
+	const __m256i bits = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)sv__charset_bits));
+	size_t i = 0;
+	for (; i + 32 <= len; i += 32)
+	{
+		unsigned hits = sv__classify_avx2(_mm256_loadu_si256((const __m256i *)(data + i)), rows_lo, rows_hi, bits);
+		if (hits)
+			return data + i + __builtin_ctz(hits);
+	}
+	if (i < len)
+	{
+		i = len - 32;
+		unsigned hits = sv__classify_avx2(_mm256_loadu_si256((const __m256i *)(data + i)), rows_lo, rows_hi, bits);
+		if (hits)
+			return data + i + __builtin_ctz(hits);
+	}
+	return NULL;
+}
+
+SV__TARGET("avx2")
+static const char *sv__rfind_any_avx2(const char *data, size_t len, const sv_charset *set)
+{
+	if (len < 32)
+		return sv__rfind_any_ssse3(data, len, set);
+	const __m256i rows_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)set->rows));
+	const __m256i rows_hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(set->rows + 16)));
+	const __m256i bits = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)sv__charset_bits));
+	size_t i = len;
+	while (i >= 32)
+	{
+		i -= 32;
+		unsigned hits = sv__classify_avx2(_mm256_loadu_si256((const __m256i *)(data + i)), rows_lo, rows_hi, bits);
+		if (hits)
+			return data + i + 31 - __builtin_clz(hits);
+	}
+	if (i > 0)
+	{
+		unsigned hits = sv__classify_avx2(_mm256_loadu_si256((const __m256i *)data), rows_lo, rows_hi, bits);
+		hits &= (1u << i) - 1;
+		if (hits)
+			return data + 31 - __builtin_clz(hits);
+	}
+	return NULL;
+}
+
+SV__TARGET("avx512f,avx512bw")
+static inline __mmask64 sv__classify_avx512(__m512i block, __m512i rows_lo, __m512i rows_hi, __m512i bits)
+{
+	__m512i idx = _mm512_and_si512(block, _mm512_set1_epi8((char)0x8F));
+	__m512i row = _mm512_or_si512(_mm512_shuffle_epi8(rows_lo, idx),
+								  _mm512_shuffle_epi8(rows_hi, _mm512_xor_si512(idx, _mm512_set1_epi8((char)0x80))));
+	__m512i bit = _mm512_shuffle_epi8(bits, _mm512_and_si512(_mm512_srli_epi16(block, 4), _mm512_set1_epi8(0x0F)));
+	return _mm512_test_epi8_mask(row, bit);
+}
+
+SV__TARGET("avx512f,avx512bw")
+static const char *sv__find_any_avx512(const char *data, size_t len, const sv_charset *set)
+{
+	const __m512i rows_lo = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)set->rows));
+	const __m512i rows_hi = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)(set->rows + 16)));
+	const __m512i bits = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)sv__charset_bits));
+	size_t i = 0;
+	for (; i + 64 <= len; i += 64)
+	{
+		__mmask64 hits = sv__classify_avx512(_mm512_loadu_si512((const void *)(data + i)), rows_lo, rows_hi, bits);
+		if (hits)
+			return data + i + __builtin_ctzll(hits);
+	}
+	if (i < len)
+	{
+		__mmask64 live = ~0ULL >> (64 - (len - i));
+		__mmask64 hits = live & sv__classify_avx512(_mm512_maskz_loadu_epi8(live, data + i), rows_lo, rows_hi, bits);
+		if (hits)
+			return data + i + __builtin_ctzll(hits);
+	}
+	return NULL;
+}
+
+SV__TARGET("avx512f,avx512bw")
+static const char *sv__rfind_any_avx512(const char *data, size_t len, const sv_charset *set)
+{
+	const __m512i rows_lo = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)set->rows));
+	const __m512i rows_hi = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)(set->rows + 16)));
+	const __m512i bits = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)sv__charset_bits));
+	size_t i = len;
+	while (i >= 64)
+	{
+		i -= 64;
+		__mmask64 hits = sv__classify_avx512(_mm512_loadu_si512((const void *)(data + i)), rows_lo, rows_hi, bits);
+		if (hits)
+			return data + i + 63 - __builtin_clzll(hits);
+	}
+	if (i > 0)
+	{
+		__mmask64 live = ~0ULL >> (64 - i);
+		__mmask64 hits = live & sv__classify_avx512(_mm512_maskz_loadu_epi8(live, data), rows_lo, rows_hi, bits);
+		if (hits)
+			return data + 63 - __builtin_clzll(hits);
+	}
+	return NULL;
+}
+
+/* Substring filters: a candidate start must match the needle's first byte and,
+needle_len - 1 bytes later, its last byte. Both compares run over a whole block
+of candidate starts; only surviving bits are confirmed with memcmp. Needles are
+at least 2 bytes long here. */
+#define SV__DEFINE_FIND_SV(isa, target, width, vec, set1, load, cmpeq, and, movemask)                              \
+	SV__TARGET(target)                                                                                            \
+	static const char *sv__find_sv_##isa(const char *data, size_t len, const char *needle, size_t needle_len)     \
+	{                                                                                                             \
+		const vec first = set1(needle[0]);                                                                        \
+		const vec last = set1(needle[needle_len - 1]);                                                            \
+		size_t verified = 0, i = 0;                                                                               \
+		for (; i + needle_len - 1 + width <= len; i += width)                                                     \
+		{                                                                                                         \
+			vec a = cmpeq(load((const vec *)(data + i)), first);                                                  \
+			vec b = cmpeq(load((const vec *)(data + i + needle_len - 1)), last);                                  \
+			uint32_t hits = (uint32_t)movemask(and(a, b));                                                        \
+			while (hits)                                                                                          \
+			{                                                                                                     \
+				size_t at = i + __builtin_ctz(hits);                                                              \
+				if (memcmp(data + at + 1, needle + 1, needle_len - 2) == 0)                                       \
+					return data + at;                                                                             \
+				verified += needle_len;                                                                           \
+				hits &= hits - 1;                                                                                 \
+			}                                                                                                     \
+			if (sv__find_sv_over_budget(verified, i + width))                                                     \
+			{                                                                                                     \
+				const char *hit = sv__find_sv_scalar(data + i + width, len - i - width, needle, needle_len);      \
+				return hit;                                                                                       \
+			}                                                                                                     \
+		}                                                                                                         \
+		for (; i + needle_len <= len; i++)                                                                        \
+		{                                                                                                         \
+			if (data[i] == needle[0] && memcmp(data + i + 1, needle + 1, needle_len - 1) == 0)                    \
+				return data + i;                                                                                  \
+		}                                                                                                         \
+		return NULL;                                                                                              \
+	}                                                                                                             \
+                                                                                                                  \
+	SV__TARGET(target)                                                                                            \
+	static const char *sv__rfind_sv_##isa(const char *data, size_t len, const char *needle, size_t needle_len)    \
+	{                                                                                                             \
+		if (needle_len > len)                                                                                     \
+			return NULL;                                                                                          \
+		const vec first = set1(needle[0]);                                                                        \
+		const vec last = set1(needle[needle_len - 1]);                                                            \
+		size_t verified = 0, starts = len - needle_len + 1; /* candidate starts not ruled out yet */              \
+		while (starts >= width)                                                                                   \
+		{                                                                                                         \
+			size_t i = starts - width;                                                                            \
+			vec a = cmpeq(load((const vec *)(data + i)), first);                                                  \
+			vec b = cmpeq(load((const vec *)(data + i + needle_len - 1)), last);                                  \
+			uint32_t hits = (uint32_t)movemask(and(a, b));                                                        \
+			while (hits)                                                                                          \
+			{                                                                                                     \
+				int bit = 31 - __builtin_clz(hits);                                                               \
+				if (memcmp(data + i + bit + 1, needle + 1, needle_len - 2) == 0)                                  \
+					return data + i + bit;                                                                        \
+				verified += needle_len;                                                                           \
+				hits &= ~(1u << bit);                                                                             \
+			}                                                                                                     \
+			starts = i;                                                                                           \
+			if (sv__find_sv_over_budget(verified, len - starts))                                                  \
+				return sv__rfind_sv_scalar(data, starts + needle_len - 1, needle, needle_len);                    \
+		}                                                                                                         \
+		while (starts > 0)                                                                                        \
+		{                                                                                                         \
+			starts--;                                                                                             \
+			if (data[starts] == needle[0] && memcmp(data + starts + 1, needle + 1, needle_len - 1) == 0)          \
+				return data + starts;                                                                             \
+		}                                                                                                         \
+		return NULL;                                                                                              \
+	}
+
+SV__DEFINE_FIND_SV(sse2, "sse2", 16, __m128i, _mm_set1_epi8, _mm_loadu_si128, _mm_cmpeq_epi8, _mm_and_si128, _mm_movemask_epi8)
+SV__DEFINE_FIND_SV(avx2, "avx2", 32, __m256i, _mm256_set1_epi8, _mm256_loadu_si256, _mm256_cmpeq_epi8, _mm256_and_si256, _mm256_movemask_epi8)
+
+/* Case changes in registers: adding 0x80 - first moves the 26 letters from
+first on to the bottom of the signed range, where one compare picks them out
+for the 0x20 bit. */
+SV__TARGET("sse2")
+static inline __m128i sv__flip_case_m128(__m128i x, unsigned char first)
+{
+	__m128i letters = _mm_cmplt_epi8(_mm_add_epi8(x, _mm_set1_epi8((char)(0x80 - first))), _mm_set1_epi8(-128 + 26));
+	return _mm_xor_si128(x, _mm_and_si128(letters, _mm_set1_epi8(0x20)));
+}
+
+SV__TARGET("avx2")
+static inline __m256i sv__flip_case_m256(__m256i x, unsigned char first)
+{
+	__m256i letters =
+		_mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), _mm256_add_epi8(x, _mm256_set1_epi8((char)(0x80 - first))));
+	return _mm256_xor_si256(x, _mm256_and_si256(letters, _mm256_set1_epi8(0x20)));
+}
+
+SV__TARGET("sse2")
+static inline __m128i sv__fold_sse2(__m128i x)
+{
+	return sv__flip_case_m128(x, 'A');
+}
+
+SV__TARGET("avx2")
+static inline __m256i sv__fold_avx2(__m256i x)
+{
+	return sv__flip_case_m256(x, 'A');
+}
+
+SV__TARGET("sse2")
+static bool sv__equal_icase_sse2(const char *a, const char *b, size_t len)
+{
+	/*A last partial block is compared overlapping the one before it.*/
+	if (len < 16)
+		return sv__equal_icase_scalar(a, b, len);
+	for (size_t i = 0;; i += 16)
+	{
+		if (i + 16 > len)
+			i = len - 16;
+		__m128i x = sv__fold_sse2(_mm_loadu_si128((const __m128i *)(a + i)));
+		__m128i y = sv__fold_sse2(_mm_loadu_si128((const __m128i *)(b + i)));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF)
+			return false;
+		if (i + 16 == len)
+			return true;
+	}
+}
+
+SV__TARGET("avx2")
+static bool sv__equal_icase_avx2(const char *a, const char *b, size_t len)
+{
+	if (len < 32)
+		return sv__equal_icase_sse2(a, b, len);
+	for (size_t i = 0;; i += 32)
+	{
+		if (i + 32 > len)
+			i = len - 32;
+		__m256i x = sv__fold_avx2(_mm256_loadu_si256((const __m256i *)(a + i)));
+		__m256i y = sv__fold_avx2(_mm256_loadu_si256((const __m256i *)(b + i)));
+		if ((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) != 0xFFFFFFFFu)
+			return false;
+		if (i + 32 == len)
+			return true;
+	}
+}
+
+SV__TARGET("avx512f,avx512bw")
+static bool sv__equal_icase_avx512(const char *a, const char *b, size_t len)
+{
+	/*Masked loads cover the tail without reading past either buffer.*/
+	const __m512i A = _mm512_set1_epi8('A'), letters = _mm512_set1_epi8(26), bit = _mm512_set1_epi8(0x20);
+	for (size_t i = 0; i < len; i += 64)
+	{
+		__mmask64 live = len - i >= 64 ? ~0ULL : (1ULL << (len - i)) - 1;
+		__m512i x = _mm512_maskz_loadu_epi8(live, a + i);
+		__m512i y = _mm512_maskz_loadu_epi8(live, b + i);
+		x = _mm512_mask_add_epi8(x, _mm512_cmplt_epu8_mask(_mm512_sub_epi8(x, A), letters), x, bit);
+		y = _mm512_mask_add_epi8(y, _mm512_cmplt_epu8_mask(_mm512_sub_epi8(y, A), letters), y, bit);
+		if (_mm512_cmpneq_epi8_mask(x, y))
+			return false;
+	}
+	return true;
+}
+
+/* Case-insensitive version of the first/last byte filter: each of the two
+bytes is compared against both of its cases, candidates are verified folded. */
+#define SV__DEFINE_FIND_SV_ICASE(isa, target, width, vec, set1, load, cmpeq, and, or, movemask)                    \
+	SV__TARGET(target)                                                                                            \
+	static const char *sv__find_sv_icase_##isa(const char *data, size_t len, const char *needle, size_t needle_len) \
+	{                                                                                                             \
+		unsigned char f = sv__fold(needle[0]), l = sv__fold(needle[needle_len - 1]);                              \
+		const vec first_lower = set1(f), first_upper = set1((unsigned char)(f - 'a') < 26 ? f ^ 0x20 : f);        \
+		const vec last_lower = set1(l), last_upper = set1((unsigned char)(l - 'a') < 26 ? l ^ 0x20 : l);          \
+		size_t verified = 0, i = 0;                                                                               \
+		for (; i + needle_len - 1 + width <= len; i += width)                                                     \
+		{                                                                                                         \
+			vec x = load((const vec *)(data + i));                                                                \
+			vec y = load((const vec *)(data + i + needle_len - 1));                                               \
+			vec a = or(cmpeq(x, first_lower), cmpeq(x, first_upper));                                             \
+			vec b = or(cmpeq(y, last_lower), cmpeq(y, last_upper));                                               \
+			uint32_t hits = (uint32_t)movemask(and(a, b));                                                        \
+			while (hits)                                                                                          \
+			{                                                                                                     \
+				size_t at = i + __builtin_ctz(hits);                                                              \
+				if (sv__equal_icase_##isa(data + at + 1, needle + 1, needle_len - 2))                             \
+					return data + at;                                                                             \
+				verified += needle_len;                                                                           \
+				hits &= hits - 1;                                                                                 \
+			}                                                                                                     \
+			if (sv__find_sv_over_budget(verified, i + width))                                                     \
+				return sv__find_sv_icase_scalar(data + i + width, len - i - width, needle, needle_len);           \
+		}                                                                                                         \
+		for (; i + needle_len <= len; i++)                                                                        \
+		{                                                                                                         \
+			if (sv__fold(data[i]) == f && sv__equal_icase_scalar(data + i + 1, needle + 1, needle_len - 1))       \
+				return data + i;                                                                                  \
+		}                                                                                                         \
+		return NULL;                                                                                              \
+	}
+
+SV__DEFINE_FIND_SV_ICASE(sse2, "sse2", 16, __m128i, _mm_set1_epi8, _mm_loadu_si128, _mm_cmpeq_epi8, _mm_and_si128, _mm_or_si128,
+						 _mm_movemask_epi8)
+SV__DEFINE_FIND_SV_ICASE(avx2, "avx2", 32, __m256i, _mm256_set1_epi8, _mm256_loadu_si256, _mm256_cmpeq_epi8, _mm256_and_si256,
+						 _mm256_or_si256, _mm256_movemask_epi8)
+
+SV__TARGET("sse2")
+static void sv__flip_case_sse2(const char *in, size_t len, char *out, unsigned char first)
+{
+	/*The last partial block is redone overlapping the one before: flipping
+	from the same input gives the same bytes, and in place the overlap is
+	already converted and holds no letters of the flipped case.*/
+	if (len < 16)
+	{
+		sv__flip_case_scalar(in, len, out, first);
+		return;
+	}
+	for (size_t i = 0;; i += 16)
+	{
+		if (i + 16 > len)
+			i = len - 16;
+		__m128i x = _mm_loadu_si128((const __m128i *)(in + i));
+		_mm_storeu_si128((__m128i *)(out + i), sv__flip_case_m128(x, first));
+		if (i + 16 == len)
+			return;
+	}
+}
+
+SV__TARGET("avx2")
+static void sv__flip_case_avx2(const char *in, size_t len, char *out, unsigned char first)
+{
+	if (len < 32)
+	{
+		sv__flip_case_sse2(in, len, out, first);
+		return;
+	}
+	for (size_t i = 0;; i += 32)
+	{
+		if (i + 32 > len)
+			i = len - 32;
+		__m256i x = _mm256_loadu_si256((const __m256i *)(in + i));
+		_mm256_storeu_si256((__m256i *)(out + i), sv__flip_case_m256(x, first));
+		if (i + 32 == len)
+			return;
+	}
+}
+
+SV__TARGET("avx512f,avx512bw")
+static void sv__flip_case_avx512(const char *in, size_t len, char *out, unsigned char first)
+{
+	const __m512i base = _mm512_set1_epi8((char)first), letters = _mm512_set1_epi8(26), bit = _mm512_set1_epi8(0x20);
+	for (size_t i = 0; i < len; i += 64)
+	{
+		__mmask64 live = len - i >= 64 ? ~0ULL : ~0ULL >> (64 - (len - i));
+		__m512i x = _mm512_maskz_loadu_epi8(live, in + i);
+		__mmask64 hits = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(x, base), letters);
+		_mm512_mask_storeu_epi8(out + i, live, _mm512_xor_si512(x, _mm512_maskz_mov_epi8(hits, bit)));
+	}
+}
+
+static size_t sv__translate_sparse(const unsigned char *map, unsigned char *from, unsigned char *to)
+{
+	/*Collects the bytes map changes, up to 5; more than 4 means the map is
+	dense and a table lookup per byte wins.*/
+	size_t count = 0;
+	for (int c = 0; c < 256 && count < 5; c++)
+	{
+		if (map[c] != c)
+		{
+			from[count] = c;
+			to[count++] = map[c];
+		}
+	}
+	return count;
+}
+
+/* A map that changes at most four bytes (replace ',' by ';', '\0' by ' ', ...)
+is a handful of compare and blend steps per vector. Dense maps and short
+inputs keep the table loop. */
+SV__TARGET("sse2")
+static void sv__translate_sse2(const char *in, size_t len, char *out, const unsigned char *map)
+{
+	unsigned char from[5], to[5];
+	size_t count = len >= 256 ? sv__translate_sparse(map, from, to) : 5;
+	if (count > 4)
+	{
+		sv__translate_scalar(in, len, out, map);
+		return;
+	}
+	size_t i = 0;
+	for (; i + 16 <= len; i += 16)
+	{
+		__m128i x = _mm_loadu_si128((const __m128i *)(in + i)), r = x;
+		for (size_t k = 0; k < count; k++)
+		{
+			__m128i hit = _mm_cmpeq_epi8(x, _mm_set1_epi8((char)from[k]));
+			r = _mm_or_si128(_mm_andnot_si128(hit, r), _mm_and_si128(hit, _mm_set1_epi8((char)to[k])));
+		}
+		_mm_storeu_si128((__m128i *)(out + i), r);
+	}
+	sv__translate_scalar(in + i, len - i, out + i, map);
+}
+
+SV__TARGET("avx2")
+static void sv__translate_avx2(const char *in, size_t len, char *out, const unsigned char *map)
+{
+	unsigned char from[5], to[5];
+	size_t count = len >= 256 ? sv__translate_sparse(map, from, to) : 5;
+	if (count > 4)
+	{
+		sv__translate_scalar(in, len, out, map);
+		return;
+	}
+	size_t i = 0;
+	for (; i + 32 <= len; i += 32)
+	{
+		__m256i x = _mm256_loadu_si256((const __m256i *)(in + i)), r = x;
+		for (size_t k = 0; k < count; k++)
+		{
+			__m256i hit = _mm256_cmpeq_epi8(x, _mm256_set1_epi8((char)from[k]));
+			r = _mm256_blendv_epi8(r, _mm256_set1_epi8((char)to[k]), hit);
+		}
+		_mm256_storeu_si256((__m256i *)(out + i), r);
+	}
+	sv__translate_scalar(in + i, len - i, out + i, map);
+}
+
+SV__TARGET("avx512f,avx512bw,avx512vbmi")
+static void sv__translate_avx512vbmi(const char *in, size_t len, char *out, const unsigned char *map)
+{
+	/*The whole table in four registers: two-source byte permutes look up the
+	low and high halves, the top bit of each byte picks between them.*/
+	const __m512i t0 = _mm512_loadu_si512((const void *)map), t1 = _mm512_loadu_si512((const void *)(map + 64));
+	const __m512i t2 = _mm512_loadu_si512((const void *)(map + 128)), t3 = _mm512_loadu_si512((const void *)(map + 192));
+	for (size_t i = 0; i < len; i += 64)
+	{
+		__mmask64 live = len - i >= 64 ? ~0ULL : ~0ULL >> (64 - (len - i));
+		__m512i x = _mm512_maskz_loadu_epi8(live, in + i);
+		__m512i low = _mm512_permutex2var_epi8(t0, x, t1);
+		__m512i high = _mm512_permutex2var_epi8(t2, x, t3);
+		_mm512_mask_storeu_epi8(out + i, live, _mm512_mask_blend_epi8(_mm512_movepi8_mask(x), low, high));
+	}
+}
+
+/* Squeeze with vector membership tests: a block without members is stored
+whole, any other goes through the branch-free byte loop with its mask. */
+#define SV__DEFINE_SQUEEZE(isa, target, width, vec, load, store, classify, broadcast)                               \
+	SV__TARGET(target)                                                                                            \
+	static size_t sv__squeeze_##isa(const char *in, size_t len, char *out, const sv_charset *set, char replacement) \
+	{                                                                                                             \
+		const vec rows_lo = broadcast(_mm_loadu_si128((const __m128i *)set->rows));                               \
+		const vec rows_hi = broadcast(_mm_loadu_si128((const __m128i *)(set->rows + 16)));                        \
+		const vec bits = broadcast(_mm_loadu_si128((const __m128i *)sv__charset_bits));                           \
+		uint64_t run = 0;                                                                                         \
+		size_t i = 0, o = 0;                                                                                      \
+		for (; i + width <= len; i += width)                                                                      \
+		{                                                                                                         \
+			vec x = load((const vec *)(in + i));                                                                  \
+			uint64_t members = classify(x, rows_lo, rows_hi, bits);                                               \
+			if (members == 0)                                                                                     \
+			{                                                                                                     \
+				store((vec *)(out + o), x);                                                                       \
+				o += width;                                                                                       \
+				run = 0;                                                                                          \
+				continue;                                                                                         \
+			}                                                                                                     \
+			o += sv__squeeze_bytes(in + i, width, out + o, NULL, members, &run, replacement);                     \
+		}                                                                                                         \
+		return o + sv__squeeze_bytes(in + i, len - i, out + o, set, 0, &run, replacement);                        \
+	}
+
+static inline __m128i sv__broadcast_m128(__m128i x)
+{
+	return x;
+}
+
+SV__DEFINE_SQUEEZE(ssse3, "ssse3", 16, __m128i, _mm_loadu_si128, _mm_storeu_si128, sv__classify_ssse3,
+				   sv__broadcast_m128)
+SV__DEFINE_SQUEEZE(avx2, "avx2", 32, __m256i, _mm256_loadu_si256, _mm256_storeu_si256, sv__classify_avx2,
+				   _mm256_broadcastsi128_si256)
+
+SV__TARGET("avx512f,avx512bw,avx512vbmi2")
+static size_t sv__squeeze_avx512vbmi2(const char *in, size_t len, char *out, const sv_charset *set, char replacement)
+{
+	/*Branch-free per block: members become the replacement, members that
+	follow a member are dropped, and a byte compress packs what is left. The
+	full-width store stays inside out because out never gets ahead of in.*/
+	const __m512i rows_lo = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)set->rows));
+	const __m512i rows_hi = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)(set->rows + 16)));
+	const __m512i bits = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)sv__charset_bits));
+	const __m512i fill = _mm512_set1_epi8(replacement);
+	uint64_t carry = 0; // 1 when the byte before the block was a member
+	size_t o = 0;
+	for (size_t i = 0; i < len; i += 64)
+	{
+		__mmask64 live = len - i >= 64 ? ~0ULL : ~0ULL >> (64 - (len - i));
+		__m512i x = _mm512_maskz_loadu_epi8(live, in + i);
+		uint64_t members = live & sv__classify_avx512(x, rows_lo, rows_hi, bits);
+		uint64_t keep = live & ~(members & (members << 1 | carry));
+		carry = members >> 63;
+		__m512i packed = _mm512_maskz_compress_epi8(keep, _mm512_mask_blend_epi8(members, x, fill));
+		size_t n = __builtin_popcountll(keep);
+		if (live == ~0ULL)
+			_mm512_storeu_si512((void *)(out + o), packed);
+		else if (n)
+			_mm512_mask_storeu_epi8(out + o, ~0ULL >> (64 - n), packed);
+		o += n;
+	}
+	return o;
+}
+#undef SV__DEFINE_FIND_SV
+
+/* Packed search for 2..16 byte needles: candidates come from the first/last
+byte filter and are confirmed with one 16-byte compare against the stored
+needle, so each candidate costs O(1) and the worst case stays linear. */
+#define SV__DEFINE_FIND_PACKED(isa, target, width, vec, set1, load, cmpeq, and, movemask)                       \
+	SV__TARGET(target)                                                                                        \
+	static const char *sv__find_packed_##isa(const char *data, size_t len, const sv_searcher *searcher)       \
+	{                                                                                                         \
+		const size_t needle_len = searcher->needle.len;                                                       \
+		const vec first = set1(searcher->packed[0]);                                                          \
+		const vec last = set1(searcher->packed[needle_len - 1]);                                              \
+		const __m128i whole = _mm_loadu_si128((const __m128i *)searcher->packed);                             \
+		size_t i = 0;                                                                                         \
+		for (; i + width + 15 <= len; i += width)                                                             \
+		{                                                                                                     \
+			vec a = cmpeq(load((const vec *)(data + i)), first);                                              \
+			vec b = cmpeq(load((const vec *)(data + i + needle_len - 1)), last);                              \
+			uint32_t hits = (uint32_t)movemask(and(a, b));                                                    \
+			while (hits)                                                                                      \
+			{                                                                                                 \
+				size_t at = i + __builtin_ctz(hits);                                                          \
+				__m128i block = _mm_loadu_si128((const __m128i *)(data + at));                                \
+				uint32_t same = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, whole));                    \
+				if ((same & searcher->packed_mask) == searcher->packed_mask)                                  \
+					return data + at;                                                                         \
+				hits &= hits - 1;                                                                             \
+			}                                                                                                 \
+		}                                                                                                     \
+		const char *hit = sv__find_packed_scalar(data + i, len - i, searcher);                                \
+		return hit;                                                                                           \
+	}
+
+SV__DEFINE_FIND_PACKED(sse2, "sse2", 16, __m128i, _mm_set1_epi8, _mm_loadu_si128, _mm_cmpeq_epi8, _mm_and_si128, _mm_movemask_epi8)
+SV__DEFINE_FIND_PACKED(avx2, "avx2", 32, __m256i, _mm256_set1_epi8, _mm256_loadu_si256, _mm256_cmpeq_epi8, _mm256_and_si256, _mm256_movemask_epi8)
+#undef SV__DEFINE_FIND_PACKED
+
+/* UTF-8 validation after Keiser and Lemire: three nibble lookups (high and
+low nibble of the previous byte, high nibble of the current one) each give a
+set of error classes, and a byte pair is wrong when all three agree on one.
+Third and fourth bytes of long sequences are checked with two saturating
+subtracts. Blocks of pure ASCII only check that nothing was left open. */
+enum
+{
+	SV__UTF8_TOO_SHORT = 1 << 0,
+	SV__UTF8_TOO_LONG = 1 << 1,
+	SV__UTF8_OVERLONG_3 = 1 << 2,
+	SV__UTF8_TOO_LARGE = 1 << 3,
+	SV__UTF8_SURROGATE = 1 << 4,
+	SV__UTF8_OVERLONG_2 = 1 << 5,
+	SV__UTF8_TOO_LARGE_1000 = 1 << 6,
+	SV__UTF8_OVERLONG_4 = 1 << 6,
+	SV__UTF8_TWO_CONTS = 1 << 7,
+	SV__UTF8_CARRY = SV__UTF8_TOO_SHORT | SV__UTF8_TOO_LONG | SV__UTF8_TWO_CONTS,
+};
+
+static const unsigned char sv__utf8_byte_1_high[16] = {
+	SV__UTF8_TOO_LONG, SV__UTF8_TOO_LONG, SV__UTF8_TOO_LONG, SV__UTF8_TOO_LONG,
+	SV__UTF8_TOO_LONG, SV__UTF8_TOO_LONG, SV__UTF8_TOO_LONG, SV__UTF8_TOO_LONG,
+	SV__UTF8_TWO_CONTS, SV__UTF8_TWO_CONTS, SV__UTF8_TWO_CONTS, SV__UTF8_TWO_CONTS,
+	SV__UTF8_TOO_SHORT | SV__UTF8_OVERLONG_2,
+	SV__UTF8_TOO_SHORT,
+	SV__UTF8_TOO_SHORT | SV__UTF8_OVERLONG_3 | SV__UTF8_SURROGATE,
+	SV__UTF8_TOO_SHORT | SV__UTF8_TOO_LARGE | SV__UTF8_TOO_LARGE_1000 | SV__UTF8_OVERLONG_4,
+};
+
+static const unsigned char sv__utf8_byte_1_low[16] = {
+	SV__UTF8_CARRY | SV__UTF8_OVERLONG_3 | SV__UTF8_OVERLONG_2 | SV__UTF8_OVERLONG_4,
+	SV__UTF8_CARRY | SV__UTF8_OVERLONG_2,
+	SV__UTF8_CARRY,
+	SV__UTF8_CARRY,
+	SV__UTF8_CARRY | SV__UTF8_TOO_LARGE,
+	SV__UTF8_CARRY | SV__UTF8_TOO_LARGE | SV__UTF8_TOO_LARGE_1000,
+	SV__UTF8_CARRY | SV__UTF8_TOO_LARGE | SV__UTF8_TOO_LARGE_1000,
+	SV__UTF8_CARRY | SV__UTF8_TOO_LARGE | SV__UTF8_TOO_LARGE_1000,
+	SV__UTF8_CARRY | SV__UTF8_TOO_LARGE | SV__UTF8_TOO_LARGE_1000,
+	SV__UTF8_CARRY | SV__UTF8_TOO_LARGE | SV__UTF8_TOO_LARGE_1000,
+	SV__UTF8_CARRY | SV__UTF8_TOO_LARGE | SV__UTF8_TOO_LARGE_1000,
+	SV__UTF8_CARRY | SV__UTF8_TOO_LARGE | SV__UTF8_TOO_LARGE_1000,
+	SV__UTF8_CARRY | SV__UTF8_TOO_LARGE | SV__UTF8_TOO_LARGE_1000,
+	SV__UTF8_CARRY | SV__UTF8_TOO_LARGE | SV__UTF8_TOO_LARGE_1000 | SV__UTF8_SURROGATE,
+	SV__UTF8_CARRY | SV__UTF8_TOO_LARGE | SV__UTF8_TOO_LARGE_1000,
+	SV__UTF8_CARRY | SV__UTF8_TOO_LARGE | SV__UTF8_TOO_LARGE_1000,
+};
+
+static const unsigned char sv__utf8_byte_2_high[16] = {
+	SV__UTF8_TOO_SHORT, SV__UTF8_TOO_SHORT, SV__UTF8_TOO_SHORT, SV__UTF8_TOO_SHORT,
+	SV__UTF8_TOO_SHORT, SV__UTF8_TOO_SHORT, SV__UTF8_TOO_SHORT, SV__UTF8_TOO_SHORT,
+	SV__UTF8_TOO_LONG | SV__UTF8_OVERLONG_2 | SV__UTF8_TWO_CONTS | SV__UTF8_OVERLONG_3 | SV__UTF8_TOO_LARGE_1000 |
+		SV__UTF8_OVERLONG_4,
+	SV__UTF8_TOO_LONG | SV__UTF8_OVERLONG_2 | SV__UTF8_TWO_CONTS | SV__UTF8_OVERLONG_3 | SV__UTF8_TOO_LARGE,
+	SV__UTF8_TOO_LONG | SV__UTF8_OVERLONG_2 | SV__UTF8_TWO_CONTS | SV__UTF8_SURROGATE | SV__UTF8_TOO_LARGE,
+	SV__UTF8_TOO_LONG | SV__UTF8_OVERLONG_2 | SV__UTF8_TWO_CONTS | SV__UTF8_SURROGATE | SV__UTF8_TOO_LARGE,
+	SV__UTF8_TOO_SHORT, SV__UTF8_TOO_SHORT, SV__UTF8_TOO_SHORT, SV__UTF8_TOO_SHORT,
+};
+
+/* Bytes at or above these in the last three positions of a block start a
+sequence that continues into the next block. */
+static const unsigned char sv__utf8_incomplete[16] = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+};
+
+static size_t sv__utf8_resume(const char *data, size_t len, size_t i)
+{
+	/*Finishes a SIMD scan that stopped at i (bytes before i raised no error)
+	with the scalar loop, for the tail and for exact error offsets. Only the
+	sequence holding byte i - 1 can still be wrong, and it starts at the last
+	non-continuation byte among the three before i.*/
+	size_t from = i;
+	for (size_t k = 1; k <= 3 && k <= i; k++)
+	{
+		if ((data[i - k] & 0xC0) != 0x80)
+		{
+			from = i - k;
+			break;
+		}
+	}
+	return from + sv__utf8_valid_scalar(data + from, len - from);
+}
+
+SV__TARGET("ssse3")
+static inline __m128i sv__utf8_check_m128(__m128i input, __m128i prev_input, __m128i t1h, __m128i t1l, __m128i t2h)
+{
+	const __m128i nibble = _mm_set1_epi8(0x0F);
+	__m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+	__m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+	__m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+	__m128i special = _mm_and_si128(
+		_mm_and_si128(_mm_shuffle_epi8(t1h, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+					  _mm_shuffle_epi8(t1l, _mm_and_si128(prev1, nibble))),
+		_mm_shuffle_epi8(t2h, _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+	__m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80))),
+								  _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80))));
+	return _mm_xor_si128(_mm_and_si128(must23, _mm_set1_epi8((char)0x80)), special);
+}
+
+SV__TARGET("ssse3")
+static size_t sv__utf8_valid_ssse3(const char *data, size_t len)
+{
+	const __m128i t1h = _mm_loadu_si128((const __m128i *)sv__utf8_byte_1_high);
+	const __m128i t1l = _mm_loadu_si128((const __m128i *)sv__utf8_byte_1_low);
+	const __m128i t2h = _mm_loadu_si128((const __m128i *)sv__utf8_byte_2_high);
+	const __m128i max = _mm_loadu_si128((const __m128i *)sv__utf8_incomplete);
+	__m128i prev = _mm_setzero_si128(), incomplete = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 64 <= len; i += 64)
+	{
+		__m128i a = _mm_loadu_si128((const __m128i *)(data + i));
+		__m128i b = _mm_loadu_si128((const __m128i *)(data + i + 16));
+		__m128i c = _mm_loadu_si128((const __m128i *)(data + i + 32));
+		__m128i d = _mm_loadu_si128((const __m128i *)(data + i + 48));
+		__m128i error = incomplete;
+		if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))))
+		{
+			error = _mm_or_si128(sv__utf8_check_m128(a, prev, t1h, t1l, t2h), sv__utf8_check_m128(b, a, t1h, t1l, t2h));
+			error = _mm_or_si128(error, sv__utf8_check_m128(c, b, t1h, t1l, t2h));
+			error = _mm_or_si128(error, sv__utf8_check_m128(d, c, t1h, t1l, t2h));
+			incomplete = _mm_subs_epu8(d, max);
+			prev = d;
+		}
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xFFFF)
+			break;
+	}
+	return sv__utf8_resume(data, len, i);
+}
+
+SV__TARGET("avx2")
+static inline __m256i sv__utf8_check_m256(__m256i input, __m256i prev_input, __m256i t1h, __m256i t1l, __m256i t2h)
+{
+	const __m256i nibble = _mm256_set1_epi8(0x0F);
+	__m256i shifted = _mm256_permute2x128_si256(prev_input, input, 0x21);
+	__m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+	__m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+	__m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+	__m256i special = _mm256_and_si256(
+		_mm256_and_si256(_mm256_shuffle_epi8(t1h, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+						 _mm256_shuffle_epi8(t1l, _mm256_and_si256(prev1, nibble))),
+		_mm256_shuffle_epi8(t2h, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+	__m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80))),
+									 _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80))));
+	return _mm256_xor_si256(_mm256_and_si256(must23, _mm256_set1_epi8((char)0x80)), special);
+}
+
+SV__TARGET("avx2")
+static size_t sv__utf8_valid_avx2(const char *data, size_t len)
+{
+	const __m256i t1h = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)sv__utf8_byte_1_high));
+	const __m256i t1l = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)sv__utf8_byte_1_low));
+	const __m256i t2h = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)sv__utf8_byte_2_high));
+	const __m256i max = _mm256_inserti128_si256(_mm256_set1_epi8((char)0xFF),
+												_mm_loadu_si128((const __m128i *)sv__utf8_incomplete), 1);
+	__m256i prev = _mm256_setzero_si256(), incomplete = _mm256_setzero_si256();
+	size_t i = 0;
+	for (; i + 64 <= len; i += 64)
+	{
+		__m256i a = _mm256_loadu_si256((const __m256i *)(data + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *)(data + i + 32));
+		__m256i error = incomplete;
+		if (_mm256_movemask_epi8(_mm256_or_si256(a, b)))
+		{
+			error = _mm256_or_si256(sv__utf8_check_m256(a, prev, t1h, t1l, t2h), sv__utf8_check_m256(b, a, t1h, t1l, t2h));
+			incomplete = _mm256_subs_epu8(b, max);
+			prev = b;
+		}
+		if (!_mm256_testz_si256(error, error))
+			break;
+	}
+	return sv__utf8_resume(data, len, i);
+}
+
+SV__TARGET("avx512f,avx512bw")
+static size_t sv__utf8_valid_avx512(const char *data, size_t len)
+{
+	const __m512i t1h = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)sv__utf8_byte_1_high));
+	const __m512i t1l = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)sv__utf8_byte_1_low));
+	const __m512i t2h = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)sv__utf8_byte_2_high));
+	const __m512i max = _mm512_inserti32x4(_mm512_set1_epi8((char)0xFF),
+										   _mm_loadu_si128((const __m128i *)sv__utf8_incomplete), 3);
+	const __m512i nibble = _mm512_set1_epi8(0x0F);
+	__m512i prev = _mm512_setzero_si512(), incomplete = _mm512_setzero_si512();
+	size_t i = 0;
+	for (; i + 64 <= len; i += 64)
+	{
+		__m512i input = _mm512_loadu_si512((const void *)(data + i));
+		__m512i error = incomplete;
+		if (_mm512_movepi8_mask(input))
+		{
+			// Lane k of shifted is lane k - 1 of input (lane 3 of prev for k == 0),
+			// so the per-lane alignr sees the bytes just before each lane.
+			__m512i shifted = _mm512_alignr_epi32(input, prev, 12);
+			__m512i prev1 = _mm512_alignr_epi8(input, shifted, 15);
+			__m512i prev2 = _mm512_alignr_epi8(input, shifted, 14);
+			__m512i prev3 = _mm512_alignr_epi8(input, shifted, 13);
+			__m512i special = _mm512_and_si512(
+				_mm512_and_si512(_mm512_shuffle_epi8(t1h, _mm512_and_si512(_mm512_srli_epi16(prev1, 4), nibble)),
+								 _mm512_shuffle_epi8(t1l, _mm512_and_si512(prev1, nibble))),
+				_mm512_shuffle_epi8(t2h, _mm512_and_si512(_mm512_srli_epi16(input, 4), nibble)));
+			__m512i must23 = _mm512_or_si512(_mm512_subs_epu8(prev2, _mm512_set1_epi8((char)(0xE0 - 0x80))),
+											 _mm512_subs_epu8(prev3, _mm512_set1_epi8((char)(0xF0 - 0x80))));
+			error = _mm512_xor_si512(_mm512_and_si512(must23, _mm512_set1_epi8((char)0x80)), special);
+			incomplete = _mm512_subs_epu8(input, max);
+			prev = input;
+		}
+		if (_mm512_test_epi8_mask(error, error))
+			break;
+	}
+	return sv__utf8_resume(data, len, i);
+}
+#endif
+
+typedef struct sv__kernel_table
+{
+	const char *(*find_char)(const char *data, size_t len, char n);
+	const char *(*rfind_char)(const char *data, size_t len, char n);
+	const char *(*find_any)(const char *data, size_t len, const sv_charset *set);
+	const char *(*rfind_any)(const char *data, size_t len, const sv_charset *set);
+	uint64_t (*eq_mask64)(const char *data, char n);
+	uint64_t (*csv_mask64)(const char *data, char delim, uint64_t *quotes);
+	uint64_t (*prefix_xor)(uint64_t x);
+	const char *(*find_sv)(const char *data, size_t len, const char *needle, size_t needle_len);
+	const char *(*rfind_sv)(const char *data, size_t len, const char *needle, size_t needle_len);
+	bool (*equal_icase)(const char *a, const char *b, size_t len);
+	const char *(*find_sv_icase)(const char *data, size_t len, const char *needle, size_t needle_len);
+	void (*flip_case)(const char *in, size_t len, char *out, unsigned char first);
+	void (*translate)(const char *in, size_t len, char *out, const unsigned char *map);
+	size_t (*squeeze)(const char *in, size_t len, char *out, const sv_charset *set, char replacement);
+	const char *(*find_packed)(const char *data, size_t len, const sv_searcher *searcher);
+	size_t (*utf8_valid)(const char *data, size_t len);
+} sv__kernel_table;
+
+static sv__kernel_table sv__kernels = {
+	.find_packed = sv__find_packed_scalar,
+	.eq_mask64 = sv__eq_mask64_scalar,
+	.csv_mask64 = sv__csv_mask64_scalar,
+	.prefix_xor = sv__prefix_xor_scalar,
+	.find_sv = sv__find_sv_scalar,
+	.rfind_sv = sv__rfind_sv_scalar,
+	.equal_icase = sv__equal_icase_scalar,
+	.find_sv_icase = sv__find_sv_icase_scalar,
+	.flip_case = sv__flip_case_scalar,
+	.translate = sv__translate_scalar,
+	.squeeze = sv__squeeze_scalar,
+	.utf8_valid = sv__utf8_valid_scalar,
+	.find_char = sv__find_char_scalar,
+	.rfind_char = sv__rfind_char_scalar,
+	.find_any = sv__find_any_scalar,
+	.rfind_any = sv__rfind_any_scalar,
+};
+static sv_simd_level sv__simd_level = SV_SIMD_SCALAR;
+
+SVDEF sv_simd_level sv_simd_detect(void)
+{
+	/*Best kernel set the running CPU supports.*/
+#ifdef SV_X86_DISPATCH
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+		return SV_SIMD_AVX512;
+	if (__builtin_cpu_supports("avx2"))
+		return SV_SIMD_AVX2;
+	if (__builtin_cpu_supports("sse2"))
+		return SV_SIMD_SSE2;
+#endif
+	return SV_SIMD_SCALAR;
+}
+
+SVDEF sv_simd_level sv_simd_get(void)
+{
+	return sv__simd_level;
+}
+
+SVDEF sv_simd_level sv_simd_set(sv_simd_level level)
+{
+	/*Switches every kernel to the given level, clamped to what the CPU supports.
+	Called once at startup; tests and benchmarks use it to pin lower levels.
+	Not thread safe: do not call while other threads are using the library.*/
+	sv_simd_level supported = sv_simd_detect();
+	if (level > supported)
+		level = supported;
+
+	sv__kernel_table k = {
+		.find_packed = sv__find_packed_scalar,
+		.eq_mask64 = sv__eq_mask64_scalar,
+		.csv_mask64 = sv__csv_mask64_scalar,
+		.prefix_xor = sv__prefix_xor_scalar,
+		.find_sv = sv__find_sv_scalar,
+		.rfind_sv = sv__rfind_sv_scalar,
+		.equal_icase = sv__equal_icase_scalar,
+		.find_sv_icase = sv__find_sv_icase_scalar,
+		.flip_case = sv__flip_case_scalar,
+		.translate = sv__translate_scalar,
+		.squeeze = sv__squeeze_scalar,
+		.utf8_valid = sv__utf8_valid_scalar,
+		.find_char = sv__find_char_scalar,
+		.rfind_char = sv__rfind_char_scalar,
+		.find_any = sv__find_any_scalar,
+		.rfind_any = sv__rfind_any_scalar,
+	};
+#ifdef SV_X86_DISPATCH
+	if (level >= SV_SIMD_SSE2)
+	{
+		k.eq_mask64 = sv__eq_mask64_sse2;
+		k.csv_mask64 = sv__csv_mask64_sse2;
+		if (__builtin_cpu_supports("pclmul"))
+			k.prefix_xor = sv__prefix_xor_clmul;
+		k.find_sv = sv__find_sv_sse2;
+		k.find_packed = sv__find_packed_sse2;
+		k.rfind_sv = sv__rfind_sv_sse2;
+		k.equal_icase = sv__equal_icase_sse2;
+		k.find_sv_icase = sv__find_sv_icase_sse2;
+		k.flip_case = sv__flip_case_sse2;
+		k.translate = sv__translate_sse2;
+		k.find_char = sv__find_char_sse2;
+		k.rfind_char = sv__rfind_char_sse2;
+		// pshufb is SSSE3; the rare SSE2-only CPU keeps the scalar set lookup.
+		if (__builtin_cpu_supports("ssse3"))
+		{
+			k.find_any = sv__find_any_ssse3;
+			k.rfind_any = sv__rfind_any_ssse3;
+			k.squeeze = sv__squeeze_ssse3;
+			k.utf8_valid = sv__utf8_valid_ssse3;
+		}
+	}
+	if (level >= SV_SIMD_AVX2)
+	{
+		k.eq_mask64 = sv__eq_mask64_avx2;
+		k.csv_mask64 = sv__csv_mask64_avx2;
+		k.find_sv = sv__find_sv_avx2;
+		k.find_packed = sv__find_packed_avx2;
+		k.rfind_sv = sv__rfind_sv_avx2;
+		k.equal_icase = sv__equal_icase_avx2;
+		k.find_sv_icase = sv__find_sv_icase_avx2;
+		k.flip_case = sv__flip_case_avx2;
+		k.translate = sv__translate_avx2;
+		k.squeeze = sv__squeeze_avx2;
+		k.utf8_valid = sv__utf8_valid_avx2;
+		k.find_char = sv__find_char_avx2;
+		k.rfind_char = sv__rfind_char_avx2;
+		k.find_any = sv__find_any_avx2;
+		k.rfind_any = sv__rfind_any_avx2;
+	}
+	if (level >= SV_SIMD_AVX512)
+	{
+		k.eq_mask64 = sv__eq_mask64_avx512;
+		k.equal_icase = sv__equal_icase_avx512;
+		k.flip_case = sv__flip_case_avx512;
+		k.utf8_valid = sv__utf8_valid_avx512;
+		if (__builtin_cpu_supports("avx512vbmi"))
+			k.translate = sv__translate_avx512vbmi;
+		if (__builtin_cpu_supports("avx512vbmi2"))
+			k.squeeze = sv__squeeze_avx512vbmi2;
+		k.csv_mask64 = sv__csv_mask64_avx512;
+		k.find_char = sv__find_char_avx512;
+		k.rfind_char = sv__rfind_char_avx512;
+		k.find_any = sv__find_any_avx512;
+		k.rfind_any = sv__rfind_any_avx512;
+	}
+#endif
+	sv__kernels = k;
+	sv__simd_level = level;
+	return level;
+}
+
+#ifdef SV_X86_DISPATCH
+__attribute__((constructor)) static void sv__simd_init(void)
+{
+	sv_simd_set(SV_SIMD_AVX512);
+}
+#endif
+
+SVDEF char *read_file_cstr(char *filename)
+{
+	/*Read whole file and returns string C style NULL terminated.
+	Also enshures that new line and return are added at the end of the file.
+	The string is malloc-ed and need to be freed after.*/
+	FILE *f = fopen(filename, "rb");
+	if (f == NULL)
+	{
+		printf("Could not open file!");
+		exit(1);
+	}
+	fseek(f, 0, SEEK_END);
+	long fsize = ftell(f);
+	fseek(f, 0, SEEK_SET); /* same as rewind(f); */
+
+	char *string = malloc((fsize + 3) * sizeof(char));
+	fread(string, fsize, 1, f);
+	fclose(f);
+
+	// Guarantee that the file ends with carrage return, newline. Null termination. BS.
+	if ((string[fsize - 1] != '\n') && (string[fsize - 2] != '\r'))
+	{
+		string[fsize] = 13;
+		string[fsize + 1] = 10;
+		string[fsize + 2] = 0;
+	}
+	else
+	{
+		string[fsize] = 0;
+		string[fsize + 1] = 0;
+		string[fsize + 2] = 0;
+	}
+	return string;
+}
+
+SVDEF StringView sv_from_cstr(char *cstr)
+{ /*Maybe not needed...*/
+	size_t len = strlen(cstr);
+	StringView sv = {.data = cstr, .len = len};
+	return sv;
+}
+
+SVDEF StringView sv_construct(char *cstr, size_t len)
+{
+	StringView sv;
+	sv.len = len;
+	sv.data = cstr;
+	return sv;
+}
+
+SVDEF StringView sv_split_left(StringView *sv, char delim)
+{
+	if (sv->len <= 0)
+		return StringViewNull;
+	const char *hit = sv__kernels.find_char(sv->data, sv->len, delim);
+	if (hit == NULL)
+		return *sv;
+
+	size_t n = hit - sv->data;
+	StringView piece = {.data = sv->data, .len = n};
+
+	sv->data = sv->data + n + 1;
+	sv->len = sv->len - n - 1;
+	return piece;
+}
+
+SVDEF StringView sv_split_right(StringView *sv, char delim)
+{
+	if (sv->len <= 0)
+		return StringViewNull;
+	const char *hit = sv__kernels.rfind_char(sv->data, sv->len, delim);
+	if (hit == NULL)
+		return StringViewNull;
+
+	size_t n = hit - sv->data;
+	StringView piece = {.data = sv->data + n + 1, .len = sv->len - n - 1};
+
+	sv->len = n;
+	return piece;
+}
+
+SVDEF StringView sv_cut_left(StringView *sv, size_t num)
+{
+	if ((sv->len <= 0) | (num <= 0))
+		return StringViewNull;
+
+	StringView piece;
+	if (num > sv->len)
+	{
+		piece.data = sv->data;
+		piece.len = sv->len;
+		*sv = StringViewNull;
+	}
+	else
+	{
+		piece.data = sv->data;
+		piece.len = num;
+
+		sv->data = sv->data + num;
+		sv->len = sv->len - num;
+	}
+	return piece;
+}
+
+SVDEF StringView sv_cut_right(StringView *sv, size_t num)
+{
+	if ((sv->len <= 0) | (num <= 0))
+		return StringViewNull;
+
+	StringView piece;
+	if (num > sv->len)
+	{
+		piece.data = sv->data;
+		piece.len = sv->len;
+		*sv = StringViewNull;
+	}
+	else
+	{
+		piece.data = sv->data + sv->len - num;
+		piece.len = num;
+		sv->data = sv->data;
+		sv->len = sv->len - num;
+	}
+	return piece;
+}
+
+SVDEF int sv_find_left_char(StringView *sv, char n)
+{
+	const char *hit = sv__kernels.find_char(sv->data, sv->len, n);
+	if (hit == NULL)
+		return -1;
+	return hit - sv->data;
+}
+
+SVDEF int sv_find_right_char(StringView *sv, char n)
+{
+	const char *hit = sv__kernels.rfind_char(sv->data, sv->len, n);
+	if (hit == NULL)
+		return -1;
+	return hit - sv->data;
+}
+
+SVDEF int sv_find_left_predicate(StringView *sv, bool (*predicate)(char))
+{
+	{
+		for (int i = 0; i < sv->len; i++)
+			if ((*predicate)(sv->data[i]))
+				return i;
+		return -1;
+	}
+}
+
+SVDEF bool sv_whitespace_predicate(char n)
+{
+	return sv__charset_test(&sv__class_sets[SV_CLASS_SPACE], n);
+}
+
+SVDEF int sv_strip_left(StringView *sv)
+{
+	int num_spaces = sv_starts_with_class(sv, &sv__class_sets[SV_CLASS_SPACE]);
+	sv_cut_left(sv, num_spaces);
+	return num_spaces;
+}
+
+SVDEF int sv_strip_right(StringView *sv)
+{
+	int num_spaces = sv_ends_with_class(sv, &sv__class_sets[SV_CLASS_SPACE]);
+	sv_cut_right(sv, num_spaces);
+	return num_spaces;
+}
+
+SVDEF bool sv_starts_with(StringView sv, StringView sv_other)
+{
+	if (sv.len < sv_other.len)
+		return false;
+	int res = memcmp(sv.data, sv_other.data, sv_other.len);
+	return (bool)(res == 0);
+}
+
+SVDEF int sv_starts_with_predicate(StringView *sv, bool (*predicate)(char))
+{
+	int count = 0;
+	for (size_t i = 0; i < sv->len && predicate(sv->data[i]); i++)
+		count += 1;
+	return count;
+}
+
+SVDEF bool sv_ends_with(StringView sv, StringView sv_other)
+{
+	if (sv.len < sv_other.len)
+		return false;
+	int diff = sv.len - sv_other.len;
+	int res = memcmp(sv.data + diff, sv_other.data, sv_other.len);
+	return (bool)res == 0;
+}
+
+SVDEF int sv_ends_with_predicate(StringView *sv, bool (*predicate)(char))
+{
+	int count = 0;
+	for (size_t i = sv->len; i > 0 && predicate(sv->data[i - 1]); i--)
+		count += 1;
+	return count;
+}
+
+SVDEF bool sv_compare(StringView sv, StringView sv_other)
+{
+	/*Compares two string views.*/
 	return (sv.len == sv_other.len) &&
 		   ((sv.data == sv_other.data) || (memcmp(sv.data, sv_other.data, sv.len) == 0));
 }
 
+SVDEF int sv_map_file(const char *filename, int flags, sv_mapped_file *file)
+{
+	/*Maps the whole file read-only and returns it as file->view, without copying.
+	Returns 0 or an errno value; file is zeroed on failure. An empty file maps to
+	an empty view. Release with sv_unmap_file.*/
+	(void)flags;
+	file->view = StringViewNull;
+	file->addr = NULL;
+	file->size = 0;
+#ifdef SV_POSIX
+	int open_flags = O_RDONLY;
+#ifdef O_CLOEXEC
+	open_flags |= O_CLOEXEC;
+#endif
+	int fd = open(filename, open_flags);
+	if (fd < 0)
+		return errno;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		int err = errno;
+		close(fd);
+		return err;
+	}
+	if (!S_ISREG(st.st_mode))
+	{
+		close(fd);
+		return EINVAL;
+	}
+	if ((uint64_t)st.st_size > SIZE_MAX)
+	{
+		close(fd);
+		return EFBIG;
+	}
+	if (st.st_size == 0)
+	{
+		close(fd);
+		return 0;
+	}
+
+	size_t size = st.st_size;
+	int map_flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+	if (flags & SV_MAP_POPULATE)
+		map_flags |= MAP_POPULATE;
+#endif
+	void *addr = mmap(NULL, size, PROT_READ, map_flags, fd, 0);
+	int err = errno;
+	close(fd); // the mapping keeps its own reference to the file
+	if (addr == MAP_FAILED)
+		return err;
+
+#ifdef MADV_SEQUENTIAL
+	if (flags & SV_MAP_SEQUENTIAL)
+		madvise(addr, size, MADV_SEQUENTIAL);
+#endif
+#ifdef MADV_WILLNEED
+	if (flags & SV_MAP_WILLNEED)
+		madvise(addr, size, MADV_WILLNEED);
+#endif
+#ifdef MADV_HUGEPAGE
+	if (flags & SV_MAP_HUGEPAGES)
+		madvise(addr, size, MADV_HUGEPAGE);
+#endif
+
+	file->addr = addr;
+	file->size = size;
+	file->view.data = addr;
+	file->view.len = size;
+	return 0;
+#else
+	(void)filename;
+	return ENOSYS;
+#endif
+}
+
+SVDEF int sv_unmap_file(sv_mapped_file *file)
+{
+	/*Unmaps a file mapped by sv_map_file. Views into it become invalid.*/
+	int err = 0;
+#ifdef SV_POSIX
+	if (file->addr != NULL && munmap(file->addr, file->size) != 0)
+		err = errno;
+#endif
+	file->view = StringViewNull;
+	file->addr = NULL;
+	file->size = 0;
+	return err;
+}
+
+SVDEF int sv_reader_init(sv_reader *reader, int fd, size_t capacity)
+{
+	/*Does not take ownership of fd. Returns 0 or ENOMEM.*/
+	if (capacity < 64)
+		capacity = 64;
+	reader->fd = fd;
+	reader->buffer = malloc(capacity);
+	reader->capacity = reader->buffer ? capacity : 0;
+	reader->start = 0;
+	reader->end = 0;
+	reader->scanned = 0;
+	reader->eof = false;
+	reader->error = reader->buffer ? 0 : ENOMEM;
+	return reader->error;
+}
+
+SVDEF void sv_reader_free(sv_reader *reader)
+{
+	free(reader->buffer);
+	reader->buffer = NULL;
+	reader->capacity = 0;
+	reader->start = 0;
+	reader->end = 0;
+}
+
+SVDEF bool sv_reader_refill(sv_reader *reader)
+{
+	/*Keeps the unconsumed bytes and appends at least one more byte from fd.
+	Returns false at end of input or on error (reader->error is set).*/
+	if (reader->eof || reader->error)
+		return false;
+
+	if (reader->start > 0)
+	{
+		memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+		reader->end -= reader->start;
+		reader->start = 0;
+	}
+	if (reader->end == reader->capacity)
+	{
+		char *grown = realloc(reader->buffer, reader->capacity * 2);
+		if (grown == NULL)
+		{
+			reader->error = ENOMEM;
+			return false;
+		}
+		reader->buffer = grown;
+		reader->capacity *= 2;
+	}
+
+#ifdef SV_POSIX
+	for (;;)
+	{
+		ssize_t got = read(reader->fd, reader->buffer + reader->end, reader->capacity - reader->end);
+		if (got > 0)
+		{
+			reader->end += got;
+			return true;
+		}
+		if (got == 0)
+		{
+			reader->eof = true;
+			return false;
+		}
+		if (errno != EINTR)
+		{
+			reader->error = errno;
+			return false;
+		}
+	}
+#else
+	reader->error = ENOSYS;
+	return false;
+#endif
+}
+
+SVDEF StringView sv_reader_peek(const sv_reader *reader)
+{
+	/*Bytes read but not consumed yet.*/
+	StringView sv = {.data = reader->buffer + reader->start, .len = reader->end - reader->start};
+	return sv;
+}
+
+SVDEF void sv_reader_consume(sv_reader *reader, size_t num)
+{
+	if (num > reader->end - reader->start)
+		num = reader->end - reader->start;
+	reader->start += num;
+	reader->scanned = reader->scanned > num ? reader->scanned - num : 0;
+}
+
+SVDEF StringView sv_reader_next(sv_reader *reader, char delim)
+{
+	/*Returns the next record without its delimiter. The last record does not
+	need a trailing delimiter. At end of input, or on error, returns a view with
+	data == NULL; an empty record has non-NULL data.*/
+	for (;;)
+	{
+		const char *from = reader->buffer + reader->start;
+		size_t avail = reader->end - reader->start;
+		const char *hit = sv__kernels.find_char(from + reader->scanned, avail - reader->scanned, delim);
+		if (hit != NULL)
+		{
+			StringView record = {.data = from, .len = hit - from};
+			reader->start += record.len + 1;
+			reader->scanned = 0;
+			return record;
+		}
+		reader->scanned = avail;
+
+		if (!sv_reader_refill(reader))
+		{
+			if (reader->error || avail == 0)
+				return StringViewNull;
+			StringView record = {.data = reader->buffer + reader->start, .len = avail};
+			reader->start = reader->end;
+			reader->scanned = 0;
+			return record;
+		}
+	}
+}
+
+SVDEF sv_charset sv_charset_from_cstr(const char *chars)
+{
+	sv_charset set = {{0}};
+	for (; *chars; chars++)
+		sv_charset_add(&set, *chars);
+	return set;
+}
+
+SVDEF sv_charset sv_charset_from_sv(StringView chars)
+{
+	sv_charset set = {{0}};
+	for (size_t i = 0; i < chars.len; i++)
+		sv_charset_add(&set, chars.data[i]);
+	return set;
+}
+
+SVDEF void sv_charset_add(sv_charset *set, char c)
+{
+	unsigned char b = c;
+	set->rows[((b >> 7) << 4) | (b & 15)] |= 1 << ((b >> 4) & 7);
+}
+
+SVDEF bool sv_charset_has(const sv_charset *set, char c)
+{
+	return sv__charset_test(set, c);
+}
+
+SVDEF int sv_find_left_any(StringView *sv, const sv_charset *set)
+{
+	const char *hit = sv__kernels.find_any(sv->data, sv->len, set);
+	if (hit == NULL)
+		return -1;
+	return hit - sv->data;
+}
+
+SVDEF int sv_find_right_any(StringView *sv, const sv_charset *set)
+{
+	const char *hit = sv__kernels.rfind_any(sv->data, sv->len, set);
+	if (hit == NULL)
+		return -1;
+	return hit - sv->data;
+}
+
+SVDEF StringView sv_split_left_any(StringView *sv, const sv_charset *set)
+{
+	/*Same as sv_split_left, but splits on the first byte that is in set.*/
+	if (sv->len <= 0)
+		return StringViewNull;
+	const char *hit = sv__kernels.find_any(sv->data, sv->len, set);
+	if (hit == NULL)
+		return *sv;
+
+	size_t n = hit - sv->data;
+	StringView piece = {.data = sv->data, .len = n};
+
+	sv->data = sv->data + n + 1;
+	sv->len = sv->len - n - 1;
+	return piece;
+}
+
+SVDEF StringView sv_split_right_any(StringView *sv, const sv_charset *set)
+{
+	/*Same as sv_split_right, but splits on the last byte that is in set.*/
+	if (sv->len <= 0)
+		return StringViewNull;
+	const char *hit = sv__kernels.rfind_any(sv->data, sv->len, set);
+	if (hit == NULL)
+		return StringViewNull;
+
+	size_t n = hit - sv->data;
+	StringView piece = {.data = sv->data + n + 1, .len = sv->len - n - 1};
+
+	sv->len = n;
+	return piece;
+}
+
+SVDEF const sv_charset *sv_charset_class(int cls)
+{
+	/*Returns the builtin table for an SV_CLASS_* value, NULL when out of range.*/
+	if (cls < 0 || cls >= SV_CLASS_COUNT)
+		return NULL;
+	return &sv__class_sets[cls];
+}
+
+SVDEF sv_charset sv_charset_complement(const sv_charset *set)
+{
+	sv_charset out;
+	for (size_t i = 0; i < sizeof(out.rows); i++)
+		out.rows[i] = ~set->rows[i];
+	return out;
+}
+
+SVDEF sv_charset sv_charset_from_predicate(bool (*predicate)(char))
+{
+	/*Evaluates predicate once per byte value, so arbitrary logic can be
+	turned into a table for the _class functions.*/
+	sv_charset set = {{0}};
+	for (int b = 0; b < 256; b++)
+		if (predicate((char)b))
+			sv_charset_add(&set, (char)b);
+	return set;
+}
+
+SVDEF int sv_find_left_class(StringView *sv, const sv_charset *set)
+{
+	return sv_find_left_any(sv, set);
+}
+
+SVDEF int sv_starts_with_class(StringView *sv, const sv_charset *set)
+{
+	/*Returns how many leading bytes are in set.*/
+	sv_charset rest = sv_charset_complement(set);
+	const char *hit = sv__kernels.find_any(sv->data, sv->len, &rest);
+	if (hit == NULL)
+		return sv->len;
+	return hit - sv->data;
+}
+
+SVDEF int sv_ends_with_class(StringView *sv, const sv_charset *set)
+{
+	/*Returns how many trailing bytes are in set.*/
+	sv_charset rest = sv_charset_complement(set);
+	const char *hit = sv__kernels.rfind_any(sv->data, sv->len, &rest);
+	if (hit == NULL)
+		return sv->len;
+	return sv->data + sv->len - hit - 1;
+}
+
+SVDEF int sv_line_index_build(sv_line_index *index, StringView text)
+{
+	/*Records the start of every line in one pass over text, 64 bytes at a time.
+	Returns 0, or ENOMEM with index left empty.*/
+	index->text = text;
+	index->line_starts = NULL;
+	index->line_count = 0;
+	if (text.len == 0)
+		return 0;
+
+	size_t count = 0;
+	size_t capacity = text.len / 64 + 64;
+	size_t *starts = malloc(capacity * sizeof(size_t));
+	if (starts == NULL)
+		return ENOMEM;
+	starts[count++] = 0;
+
+	size_t i = 0;
+	for (; i + 64 <= text.len; i += 64)
+	{
+		if (count + 64 > capacity)
+		{
+			capacity *= 2;
+			size_t *grown = realloc(starts, capacity * sizeof(size_t));
+			if (grown == NULL)
+			{
+				free(starts);
+				return ENOMEM;
+			}
+			starts = grown;
+		}
+		uint64_t newlines = sv__kernels.eq_mask64(text.data + i, '\n');
+		while (newlines)
+		{
+			starts[count++] = i + __builtin_ctzll(newlines) + 1;
+			newlines &= newlines - 1;
+		}
+	}
+	if (count + 64 > capacity)
+	{
+		capacity += 64;
+		size_t *grown = realloc(starts, capacity * sizeof(size_t));
+		if (grown == NULL)
+		{
+			free(starts);
+			return ENOMEM;
+		}
+		starts = grown;
+	}
+	for (; i < text.len; i++)
+	{
+		if (text.data[i] == '\n')
+			starts[count++] = i + 1;
+	}
+	// A newline at the very end terminates the last line rather than opening an empty one.
+	if (starts[count - 1] == text.len)
+		count--;
+
+	index->line_starts = starts;
+	index->line_count = count;
+	return 0;
+}
+
+SVDEF void sv_line_index_free(sv_line_index *index)
+{
+	free(index->line_starts);
+	index->line_starts = NULL;
+	index->line_count = 0;
+}
+
+SVDEF StringView sv_line_index_line(const sv_line_index *index, size_t line)
+{
+	/*Returns the line without its "\n" or "\r\n", or StringViewNull past the last line.*/
+	if (line >= index->line_count)
+		return StringViewNull;
+	size_t start = index->line_starts[line];
+	size_t end = line + 1 < index->line_count ? index->line_starts[line + 1] : index->text.len;
+	if (end > start && index->text.data[end - 1] == '\n')
+		end--;
+	if (end > start && index->text.data[end - 1] == '\r')
+		end--;
+	StringView piece = {.data = index->text.data + start, .len = end - start};
+	return piece;
+}
+
+SVDEF bool sv_line_index_locate(const sv_line_index *index, const char *ptr, sv_line_pos *pos)
+{
+	/*Finds the line and column of ptr with a binary search over the line starts.
+	Returns false when ptr is outside the indexed text (one past the end is inside).*/
+	if (ptr < index->text.data || ptr > index->text.data + index->text.len)
+		return false;
+	size_t offset = ptr - index->text.data;
+	if (index->line_count == 0)
+	{
+		pos->line = 0;
+		pos->column = 0;
+		return true;
+	}
+
+	size_t lo = 0, hi = index->line_count;
+	while (hi - lo > 1)
+	{
+		size_t mid = lo + (hi - lo) / 2;
+		if (index->line_starts[mid] <= offset)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	pos->line = lo;
+	pos->column = offset - index->line_starts[lo];
+	return true;
+}
+
+typedef struct sv__parallel_job
+{
+	StringView buffer;
+	char delim;
+	size_t chunk_size;
+	size_t chunk_count;
+	sv_record_callback callback;
+	const sv_parallel_hooks *hooks;
+	void *ctx;
+#ifdef SV_POSIX
+	atomic_size_t next_chunk;
+	pthread_mutex_t reduce_lock;
+#else
+	size_t next_chunk;
+#endif
+} sv__parallel_job;
+
+static size_t sv__parallel_cut(const sv__parallel_job *job, size_t chunk)
+{
+	/*Start of the first record that begins at or after the nominal chunk start.*/
+	if (chunk == 0)
+		return 0;
+	size_t nominal = chunk * job->chunk_size;
+	if (nominal >= job->buffer.len)
+		return job->buffer.len;
+	const char *from = job->buffer.data + nominal - 1;
+	const char *hit = sv__kernels.find_char(from, job->buffer.len - nominal + 1, job->delim);
+	return hit ? (size_t)(hit - job->buffer.data) + 1 : job->buffer.len;
+}
+
+static void *sv__parallel_worker(void *arg)
+{
+	sv__parallel_job *job = arg;
+	void *local = NULL;
+	if (job->hooks && job->hooks->thread_init)
+		local = job->hooks->thread_init(job->ctx);
+
+	for (;;)
+	{
+		// Chunks are claimed from a shared counter, so fast threads keep taking
+		// work from slow ones until the buffer is exhausted.
+#ifdef SV_POSIX
+		size_t chunk = atomic_fetch_add_explicit(&job->next_chunk, 1, memory_order_relaxed);
+#else
+		size_t chunk = job->next_chunk++;
+#endif
+		if (chunk >= job->chunk_count)
+			break;
+		size_t start = sv__parallel_cut(job, chunk);
+		size_t end = sv__parallel_cut(job, chunk + 1);
+		StringView sv = {.data = job->buffer.data + start, .len = end - start};
+		while (sv.len)
+		{
+			const char *hit = sv__kernels.find_char(sv.data, sv.len, job->delim);
+			if (hit == NULL)
+			{
+				job->callback(sv, local, job->ctx);
+				break;
+			}
+			StringView record = {.data = sv.data, .len = hit - sv.data};
+			job->callback(record, local, job->ctx);
+			sv.len -= record.len + 1;
+			sv.data = hit + 1;
+		}
+	}
+
+	if (job->hooks && job->hooks->thread_reduce)
+	{
+#ifdef SV_POSIX
+		pthread_mutex_lock(&job->reduce_lock);
+		job->hooks->thread_reduce(local, job->ctx);
+		pthread_mutex_unlock(&job->reduce_lock);
+#else
+		job->hooks->thread_reduce(local, job->ctx);
+#endif
+	}
+	return NULL;
+}
+
+SVDEF int sv_parallel_for_each_record(StringView buffer, char delim, size_t nthreads,
+									  sv_record_callback callback, void *ctx)
+{
+	return sv_parallel_for_each_record_reduce(buffer, delim, nthreads, callback, NULL, ctx);
+}
+
+SVDEF int sv_parallel_for_each_record_reduce(StringView buffer, char delim, size_t nthreads,
+											 sv_record_callback callback, const sv_parallel_hooks *hooks, void *ctx)
+{
+	/*nthreads == 0 uses one thread per online CPU. The calling thread works too.
+	Returns 0, or EINVAL when callback is NULL.*/
+	if (callback == NULL)
+		return EINVAL;
+#ifdef SV_POSIX
+	if (nthreads == 0)
+	{
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		nthreads = cpus > 0 ? (size_t)cpus : 1;
+	}
+#else
+	nthreads = 1;
+#endif
+
+	// Many more chunks than threads so uneven record sizes even out, but not so
+	// small that the boundary scans and the shared counter start to show.
+	const size_t min_chunk = 64 * 1024;
+	size_t chunk_count = nthreads * 16;
+	if (buffer.len / chunk_count < min_chunk)
+		chunk_count = buffer.len / min_chunk + 1;
+	if (nthreads > chunk_count)
+		nthreads = chunk_count;
+
+	sv__parallel_job job = {
+		.buffer = buffer,
+		.delim = delim,
+		.chunk_size = buffer.len / chunk_count + 1,
+		.chunk_count = chunk_count,
+		.callback = callback,
+		.hooks = hooks,
+		.ctx = ctx,
+	};
+#ifdef SV_POSIX
+	atomic_init(&job.next_chunk, 0);
+	pthread_mutex_init(&job.reduce_lock, NULL);
+
+	pthread_t *threads = nthreads > 1 ? malloc((nthreads - 1) * sizeof(pthread_t)) : NULL;
+	size_t started = 0;
+	if (threads != NULL)
+	{
+		// If a thread cannot be created the remaining ones simply take more chunks.
+		while (started < nthreads - 1 && pthread_create(&threads[started], NULL, sv__parallel_worker, &job) == 0)
+			started++;
+	}
+	sv__parallel_worker(&job);
+	for (size_t i = 0; i < started; i++)
+		pthread_join(threads[i], NULL);
+	free(threads);
+	pthread_mutex_destroy(&job.reduce_lock);
+#else
+	job.next_chunk = 0;
+	sv__parallel_worker(&job);
+#endif
+	return 0;
+}
+
+SVDEF int sv_find_left_sv(StringView *sv, StringView needle)
+{
+	/*Index of the first occurrence of needle, -1 if there is none.
+	An empty needle is found at 0.*/
+	if (needle.len == 0)
+		return 0;
+	if (needle.len > sv->len)
+		return -1;
+	const char *hit = needle.len == 1 ? sv__kernels.find_char(sv->data, sv->len, needle.data[0])
+									  : sv__kernels.find_sv(sv->data, sv->len, needle.data, needle.len);
+	if (hit == NULL)
+		return -1;
+	return hit - sv->data;
+}
+
+SVDEF int sv_find_right_sv(StringView *sv, StringView needle)
+{
+	/*Index of the last occurrence of needle, -1 if there is none.
+	An empty needle is found at sv->len.*/
+	if (needle.len == 0)
+		return sv->len;
+	if (needle.len > sv->len)
+		return -1;
+	const char *hit = needle.len == 1 ? sv__kernels.rfind_char(sv->data, sv->len, needle.data[0])
+									  : sv__kernels.rfind_sv(sv->data, sv->len, needle.data, needle.len);
+	if (hit == NULL)
+		return -1;
+	return hit - sv->data;
+}
+
+SVDEF int sv_find_left_sv_icase(StringView *sv, StringView needle)
+{
+	/*sv_find_left_sv with ASCII case folded. A one-letter needle is a two-byte
+	set lookup.*/
+	if (needle.len == 0)
+		return 0;
+	if (needle.len > sv->len)
+		return -1;
+	const char *hit;
+	if (needle.len == 1)
+	{
+		unsigned char c = sv__fold(needle.data[0]);
+		sv_charset set = {0};
+		sv_charset_add(&set, c);
+		sv_charset_add(&set, (unsigned char)(c - 'a') < 26 ? c ^ 0x20 : c);
+		hit = sv__kernels.find_any(sv->data, sv->len, &set);
+	}
+	else
+		hit = sv__kernels.find_sv_icase(sv->data, sv->len, needle.data, needle.len);
+	if (hit == NULL)
+		return -1;
+	return hit - sv->data;
+}
+
+SVDEF StringView sv_split_left_sv(StringView *sv, StringView delim)
+{
+	/*Same as sv_split_left, but the delimiter is a string ("\r\n", "::", ...).
+	An empty delimiter is never found.*/
+	if (sv->len <= 0)
+		return StringViewNull;
+	if (delim.len == 0 || delim.len > sv->len)
+		return *sv;
+	const char *hit = delim.len == 1 ? sv__kernels.find_char(sv->data, sv->len, delim.data[0])
+									 : sv__kernels.find_sv(sv->data, sv->len, delim.data, delim.len);
+	if (hit == NULL)
+		return *sv;
+
+	size_t n = hit - sv->data;
+	StringView piece = {.data = sv->data, .len = n};
+
+	sv->data = sv->data + n + delim.len;
+	sv->len = sv->len - n - delim.len;
+	return piece;
+}
+
+SVDEF void sv_searcher_init(sv_searcher *searcher, StringView needle)
+{
+	memset(searcher, 0, sizeof(*searcher));
+	searcher->needle = needle;
+	if (needle.len == 0)
+	{
+		searcher->kind = SV__SEARCH_EMPTY;
+	}
+	else if (needle.len == 1)
+	{
+		searcher->kind = SV__SEARCH_BYTE;
+	}
+	else if (needle.len <= 16)
+	{
+		searcher->kind = SV__SEARCH_PACKED;
+		memcpy(searcher->packed, needle.data, needle.len);
+		searcher->packed_mask = (1u << needle.len) - 1;
+	}
+	else
+	{
+		searcher->kind = SV__SEARCH_LONG;
+		// Horspool: shift by the distance from the last occurrence of the byte
+		// under the needle's last position to the end of the needle.
+		for (int c = 0; c < 256; c++)
+			searcher->shift[c] = needle.len;
+		for (size_t i = 0; i + 1 < needle.len; i++)
+			searcher->shift[(unsigned char)needle.data[i]] = needle.len - 1 - i;
+
+		sv__twoway tw;
+		sv__twoway_prepare(&tw, needle.data, needle.len, false, false);
+		searcher->twoway_ell = tw.ell;
+		searcher->twoway_period = tw.period;
+		searcher->twoway_periodic = tw.periodic;
+	}
+}
+
+static const char *sv__searcher_next(const sv_searcher *searcher, const char *data, size_t len)
+{
+	const char *needle = searcher->needle.data;
+	size_t needle_len = searcher->needle.len;
+	if (needle_len > len)
+		return NULL;
+
+	switch (searcher->kind)
+	{
+	case SV__SEARCH_EMPTY:
+		return data;
+	case SV__SEARCH_BYTE:
+		return sv__kernels.find_char(data, len, needle[0]);
+	case SV__SEARCH_PACKED:
+		return sv__kernels.find_packed(data, len, searcher);
+	}
+
+	size_t last = needle_len - 1, verified = 0, i = 0;
+	while (i <= len - needle_len)
+	{
+		unsigned char c = data[i + last];
+		if (c == (unsigned char)needle[last] && memcmp(data + i, needle, last) == 0)
+			return data + i;
+		if (c == (unsigned char)needle[last] && sv__find_sv_over_budget(verified += needle_len, i + needle_len))
+		{
+			sv__twoway tw = {
+				.needle = (const unsigned char *)needle,
+				.len = needle_len,
+				.ell = searcher->twoway_ell,
+				.period = searcher->twoway_period,
+				.periodic = searcher->twoway_periodic,
+			};
+			size_t pos = sv__twoway_search(&tw, data + i, len - i);
+			return pos == SIZE_MAX ? NULL : data + i + pos;
+		}
+		i += searcher->shift[c];
+	}
+	return NULL;
+}
+
+SVDEF int sv_searcher_find(const sv_searcher *searcher, StringView haystack)
+{
+	/*Index of the first occurrence of the needle, -1 if there is none.*/
+	const char *hit = sv__searcher_next(searcher, haystack.data, haystack.len);
+	if (hit == NULL)
+		return -1;
+	return hit - haystack.data;
+}
+
+SVDEF size_t sv_searcher_count(const sv_searcher *searcher, StringView haystack)
+{
+	/*Number of non-overlapping occurrences. An empty needle counts as none.*/
+	if (searcher->needle.len == 0)
+		return 0;
+	size_t count = 0;
+	const char *data = haystack.data;
+	size_t len = haystack.len;
+	const char *hit;
+	while ((hit = sv__searcher_next(searcher, data, len)) != NULL)
+	{
+		count++;
+		len -= hit + searcher->needle.len - data;
+		data = hit + searcher->needle.len;
+	}
+	return count;
+}
+
+#define SV__NO_OUTPUT UINT32_MAX
+
+static uint32_t sv__trie_child(const uint32_t *first_child, const uint32_t *next_sibling,
+							   const unsigned char *label, uint32_t node, unsigned char c)
+{
+	for (uint32_t child = first_child[node]; child; child = next_sibling[child])
+	{
+		if (label[child] == c)
+			return child;
+	}
+	return 0;
+}
+
+SVDEF int sv_multimatch_build(sv_multimatch *mm, const StringView *patterns, size_t count)
+{
+	/*Returns 0, ENOMEM, or EOVERFLOW when the patterns need more than 2^32 states.*/
+	memset(mm, 0, sizeof(*mm));
+	size_t max_states = 1;
+	for (size_t i = 0; i < count; i++)
+		max_states += patterns[i].len;
+	if (max_states >= UINT32_MAX || count >= UINT32_MAX)
+		return EOVERFLOW;
+
+	// Build the trie with child/sibling lists, then compact it.
+	uint32_t *first_child = calloc(max_states, sizeof(uint32_t));
+	uint32_t *next_sibling = calloc(max_states, sizeof(uint32_t));
+	unsigned char *label = calloc(max_states, 1);
+	uint32_t *queue = malloc(max_states * sizeof(uint32_t));
+	mm->fail = calloc(max_states, sizeof(uint32_t));
+	mm->depth = calloc(max_states, sizeof(uint32_t));
+	mm->output = malloc(max_states * sizeof(uint32_t));
+	mm->output_link = calloc(max_states, sizeof(uint32_t));
+	int err = 0;
+	if (!first_child || !next_sibling || !label || !queue || !mm->fail || !mm->depth || !mm->output || !mm->output_link)
+	{
+		err = ENOMEM;
+		goto done;
+	}
+
+	uint32_t states = 1;
+	mm->output[0] = SV__NO_OUTPUT;
+	for (size_t p = 0; p < count; p++)
+	{
+		if (patterns[p].len == 0)
+			continue;
+		uint32_t node = 0;
+		for (size_t i = 0; i < patterns[p].len; i++)
+		{
+			unsigned char c = patterns[p].data[i];
+			uint32_t child = sv__trie_child(first_child, next_sibling, label, node, c);
+			if (child == 0)
+			{
+				child = states++;
+				label[child] = c;
+				mm->depth[child] = mm->depth[node] + 1;
+				mm->output[child] = SV__NO_OUTPUT;
+				next_sibling[child] = first_child[node];
+				first_child[node] = child;
+			}
+			node = child;
+		}
+		if (mm->output[node] == SV__NO_OUTPUT)
+			mm->output[node] = p;
+	}
+
+	mm->edge_start = malloc(states * sizeof(uint32_t));
+	mm->edge_count = malloc(states * sizeof(uint16_t));
+	mm->edge_labels = malloc(states);
+	mm->edge_targets = malloc(states * sizeof(uint32_t));
+	if (!mm->edge_start || !mm->edge_count || !mm->edge_labels || !mm->edge_targets)
+	{
+		err = ENOMEM;
+		goto done;
+	}
+
+	// Breadth-first: failure links point to shallower states, which are done by then.
+	size_t head = 0, tail = 0, edges = 0;
+	queue[tail++] = 0;
+	while (head < tail)
+	{
+		uint32_t node = queue[head++];
+		mm->edge_start[node] = edges;
+		mm->edge_count[node] = 0;
+		for (uint32_t child = first_child[node]; child; child = next_sibling[child])
+		{
+			queue[tail++] = child;
+			if (node == 0)
+			{
+				mm->root[label[child]] = child;
+			}
+			else
+			{
+				// Insertion sort keeps each state's labels ordered.
+				size_t at = edges++;
+				while (at > mm->edge_start[node] && mm->edge_labels[at - 1] > label[child])
+				{
+					mm->edge_labels[at] = mm->edge_labels[at - 1];
+					mm->edge_targets[at] = mm->edge_targets[at - 1];
+					at--;
+				}
+				mm->edge_labels[at] = label[child];
+				mm->edge_targets[at] = child;
+				mm->edge_count[node]++;
+
+				uint32_t f = mm->fail[node];
+				uint32_t next;
+				while ((next = sv__trie_child(first_child, next_sibling, label, f, label[child])) == 0 && f != 0)
+					f = mm->fail[f];
+				mm->fail[child] = next;
+			}
+			uint32_t f = mm->fail[child];
+			mm->output_link[child] = mm->output[f] != SV__NO_OUTPUT ? f : mm->output_link[f];
+		}
+	}
+
+	mm->state_count = states;
+	mm->pattern_count = count;
+
+done:
+	free(first_child);
+	free(next_sibling);
+	free(label);
+	free(queue);
+	if (err)
+		sv_multimatch_free(mm);
+	return err;
+}
+
+SVDEF void sv_multimatch_free(sv_multimatch *mm)
+{
+	free(mm->edge_start);
+	free(mm->edge_count);
+	free(mm->edge_labels);
+	free(mm->edge_targets);
+	free(mm->fail);
+	free(mm->depth);
+	free(mm->output);
+	free(mm->output_link);
+	memset(mm, 0, sizeof(*mm));
+}
+
+static inline uint32_t sv__multimatch_step(const sv_multimatch *mm, uint32_t state, unsigned char c)
+{
+	for (;;)
+	{
+		if (state == 0)
+			return mm->root[c];
+		const unsigned char *labels = mm->edge_labels + mm->edge_start[state];
+		for (uint32_t i = 0, n = mm->edge_count[state]; i < n && labels[i] <= c; i++)
+		{
+			if (labels[i] == c)
+				return mm->edge_targets[mm->edge_start[state] + i];
+		}
+		state = mm->fail[state];
+	}
+}
+
+SVDEF size_t sv_multimatch_scan(const sv_multimatch *mm, StringView haystack, int mode,
+								sv_match_callback callback, void *ctx)
+{
+	/*Reports matches to callback (which may be NULL to just count them) and
+	returns how many were reported.*/
+	const unsigned char *data = (const unsigned char *)haystack.data;
+	size_t reported = 0;
+	if (mm->state_count == 0)
+		return 0;
+
+	if (mode == SV_MATCH_ALL)
+	{
+		uint32_t state = 0;
+		for (size_t i = 0; i < haystack.len; i++)
+		{
+			state = sv__multimatch_step(mm, state, data[i]);
+			uint32_t s = mm->output[state] != SV__NO_OUTPUT ? state : mm->output_link[state];
+			for (; s != 0; s = mm->output_link[s])
+			{
+				sv_match match = {.pattern = mm->output[s], .offset = i + 1 - mm->depth[s]};
+				reported++;
+				if (callback && !callback(match, ctx))
+					return reported;
+			}
+		}
+		return reported;
+	}
+
+	// Leftmost-longest: keep the best match seen so far until the automaton's
+	// live window has moved past its start, then emit it and restart after it.
+	size_t pos = 0;
+	while (pos < haystack.len)
+	{
+		uint32_t state = 0, best = 0;
+		size_t best_start = SIZE_MAX;
+		for (size_t i = pos; i < haystack.len; i++)
+		{
+			state = sv__multimatch_step(mm, state, data[i]);
+			uint32_t s = mm->output[state] != SV__NO_OUTPUT ? state : mm->output_link[state];
+			for (; s != 0; s = mm->output_link[s])
+			{
+				size_t start = i + 1 - mm->depth[s];
+				if (start < best_start || (start == best_start && mm->depth[s] > mm->depth[best]))
+				{
+					best = s;
+					best_start = start;
+				}
+			}
+			if (best != 0 && i + 1 - mm->depth[state] > best_start)
+				break;
+		}
+		if (best == 0)
+			break;
+
+		sv_match match = {.pattern = mm->output[best], .offset = best_start};
+		reported++;
+		if (callback && !callback(match, ctx))
+			return reported;
+		pos = best_start + mm->depth[best];
+	}
+	return reported;
+}
+
+static const char sv__digit_pairs[201] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+static const uint64_t sv__pow10[20] = {
+	1ULL,
+	10ULL,
+	100ULL,
+	1000ULL,
+	10000ULL,
+	100000ULL,
+	1000000ULL,
+	10000000ULL,
+	100000000ULL,
+	1000000000ULL,
+	10000000000ULL,
+	100000000000ULL,
+	1000000000000ULL,
+	10000000000000ULL,
+	100000000000000ULL,
+	1000000000000000ULL,
+	10000000000000000ULL,
+	100000000000000000ULL,
+	1000000000000000000ULL,
+	10000000000000000000ULL,
+};
+
+static inline size_t sv__digit_count(uint64_t value)
+{
+	/*Decimal digits of value: log2 scaled by 1233 / 4096 ~ log10(2) gives the
+	count or one more, and a single compare settles which.*/
+	size_t guess = ((64 - __builtin_clzll(value | 1)) * 1233) >> 12;
+	return guess + (value >= sv__pow10[guess]) + (value == 0);
+}
+
+static inline size_t sv__format_u64(char *out, uint64_t value)
+{
+	/*Writes the digits of value (no terminator) and returns how many. Two
+	digits per division, filled from the back.*/
+	size_t n = sv__digit_count(value);
+	char *p = out + n;
+	while (value >= 100)
+	{
+		size_t pair = (value % 100) * 2;
+		value /= 100;
+		p -= 2;
+		memcpy(p, sv__digit_pairs + pair, 2);
+	}
+	if (value >= 10)
+		memcpy(p - 2, sv__digit_pairs + value * 2, 2);
+	else
+		p[-1] = '0' + value;
+	return n;
+}
+
+static inline char *sv__builder_data(sv_builder *builder)
+{
+	return builder->heap ? builder->heap : builder->small;
+}
+
+SVDEF void sv_builder_init(sv_builder *builder)
+{
+	memset(builder, 0, sizeof(*builder));
+}
+
+SVDEF void sv_builder_free(sv_builder *builder)
+{
+	free(builder->heap);
+	memset(builder, 0, sizeof(*builder));
+}
+
+SVDEF void sv_builder_clear(sv_builder *builder)
+{
+	/*Empties the builder and clears error, keeping the buffer.*/
+	builder->len = 0;
+	builder->error = 0;
+	sv__builder_data(builder)[0] = '\0';
+}
+
+SVDEF int sv_builder_reserve(sv_builder *builder, size_t extra)
+{
+	/*Makes room for extra more bytes (plus the terminator) so that many bytes
+	of appends do not reallocate. Returns 0 or ENOMEM (also stored in error).*/
+	if (builder->error)
+		return builder->error;
+	size_t capacity = builder->heap ? builder->capacity : sizeof(builder->small);
+	if (extra < capacity - builder->len)
+		return 0;
+	if (extra > SIZE_MAX / 2 - builder->len)
+		return builder->error = ENOMEM;
+
+	size_t needed = builder->len + extra + 1;
+	if (needed < 2 * capacity)
+		needed = 2 * capacity;
+	char *grown = realloc(builder->heap, needed);
+	if (grown == NULL)
+		return builder->error = ENOMEM;
+	if (builder->heap == NULL)
+		memcpy(grown, builder->small, builder->len + 1);
+	builder->heap = grown;
+	builder->capacity = needed;
+	return 0;
+}
+
+SVDEF void sv_builder_append_sv(sv_builder *builder, StringView sv)
+{
+	if (sv_builder_reserve(builder, sv.len))
+		return;
+	char *data = sv__builder_data(builder);
+	if (sv.len)
+		memcpy(data + builder->len, sv.data, sv.len);
+	builder->len += sv.len;
+	data[builder->len] = '\0';
+}
+
+SVDEF void sv_builder_append_char(sv_builder *builder, char c)
+{
+	if (sv_builder_reserve(builder, 1))
+		return;
+	char *data = sv__builder_data(builder);
+	data[builder->len++] = c;
+	data[builder->len] = '\0';
+}
+
+SVDEF void sv_builder_append_repeat(sv_builder *builder, char c, size_t count)
+{
+	if (sv_builder_reserve(builder, count))
+		return;
+	char *data = sv__builder_data(builder);
+	memset(data + builder->len, c, count);
+	builder->len += count;
+	data[builder->len] = '\0';
+}
+
+SVDEF void sv_builder_append_u64(sv_builder *builder, uint64_t value)
+{
+	/*Decimal digits written straight into the buffer, no stdio.*/
+	if (sv_builder_reserve(builder, 20))
+		return;
+	char *data = sv__builder_data(builder);
+	builder->len += sv__format_u64(data + builder->len, value);
+	data[builder->len] = '\0';
+}
+
+SVDEF void sv_builder_append_i64(sv_builder *builder, int64_t value)
+{
+	if (sv_builder_reserve(builder, 21))
+		return;
+	char *data = sv__builder_data(builder);
+	uint64_t magnitude = value;
+	if (value < 0)
+	{
+		data[builder->len++] = '-';
+		magnitude = 0 - magnitude;
+	}
+	builder->len += sv__format_u64(data + builder->len, magnitude);
+	data[builder->len] = '\0';
+}
+
+SVDEF StringView sv_builder_view(const sv_builder *builder)
+{
+	/*The contents, without copying. Valid until the next append, clear or free.*/
+	StringView sv = {.data = builder->heap ? builder->heap : builder->small, .len = builder->len};
+	return sv;
+}
+
+static inline uint64_t sv__load_be64(const char *p)
+{
+	uint64_t v;
+	memcpy(&v, p, 8);
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ != __ORDER_BIG_ENDIAN__
+	v = __builtin_bswap64(v);
+#endif
+	return v;
+}
+
+static inline uint64_t sv__load_le64(const char *p)
+{
+	uint64_t v;
+	memcpy(&v, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	v = __builtin_bswap64(v);
+#endif
+	return v;
+}
+
+static inline uint64_t sv__nondigit_mask(uint64_t word)
+{
+	/*High bit of every byte of word (first byte lowest) that is not '0'..'9'.
+	The adds stay inside each byte, so bytes do not disturb each other.*/
+	const uint64_t high = 0x8080808080808080ULL, low7 = word & ~high;
+	uint64_t at_least_0 = low7 + 0x5050505050505050ULL;	/* 0x80 - '0' */
+	uint64_t above_9 = low7 + 0x4646464646464646ULL;	/* 0x80 - ('9' + 1) */
+	return ~(~word & at_least_0 & ~above_9) & high;
+}
+
+static inline uint32_t sv__parse_8digits(uint64_t word)
+{
+	/*Value of eight ASCII digits, first digit in the lowest byte: pairs, then
+	quads, then the whole, each step one multiply.*/
+	word -= 0x3030303030303030ULL;
+	word = word * 10 + (word >> 8);
+	word = ((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)) +
+			((word >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32))) >>
+		   32;
+	return (uint32_t)word;
+}
+
+static size_t sv__digit_run(const char *p, size_t len)
+{
+	size_t i = 0;
+	for (; i + 8 <= len; i += 8)
+	{
+		uint64_t nondigit = sv__nondigit_mask(sv__load_le64(p + i));
+		if (nondigit)
+			return i + (__builtin_ctzll(nondigit) >> 3);
+	}
+	while (i < len && (unsigned char)(p[i] - '0') < 10)
+		i++;
+	return i;
+}
+
+static uint64_t sv__parse_digits(const char *p, size_t n, size_t avail)
+{
+	/*Value of n <= 19 digits at p, with avail >= n bytes readable. Eight digits
+	per step; a short tail with eight readable bytes is shifted to the top of
+	one word and padded with '0' so it takes one step too.*/
+	uint64_t value = 0;
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+		value = value * 100000000 + sv__parse_8digits(sv__load_le64(p + i));
+	size_t tail = n - i;
+	if (tail && i + 8 <= avail)
+	{
+		uint64_t word = sv__load_le64(p + i) << (8 * (8 - tail));
+		word |= 0x3030303030303030ULL >> (8 * tail);
+		return value * sv__pow10[tail] + sv__parse_8digits(word);
+	}
+	for (; i < n; i++)
+		value = value * 10 + (p[i] - '0');
+	return value;
+}
+
+static int sv__parse_magnitude(const char *p, size_t avail, uint64_t max, uint64_t *value, size_t *consumed)
+{
+	size_t n = sv__digit_run(p, avail);
+	if (consumed)
+		*consumed = n;
+	*value = 0;
+	if (n == 0)
+		return EINVAL;
+	while (n > 1 && *p == '0')
+	{
+		p++;
+		n--;
+		avail--;
+	}
+	if (n > 20)
+	{
+		*value = max;
+		return ERANGE;
+	}
+	uint64_t v;
+	if (n == 20)
+	{
+		// Only the twentieth digit can take a u64 past its limit.
+		v = sv__parse_digits(p, 19, avail);
+		unsigned last = p[19] - '0';
+		if (v > UINT64_MAX / 10 || (v == UINT64_MAX / 10 && last > UINT64_MAX % 10))
+		{
+			*value = max;
+			return ERANGE;
+		}
+		v = v * 10 + last;
+	}
+	else
+	{
+		v = sv__parse_digits(p, n, avail);
+	}
+	if (v > max)
+	{
+		*value = max;
+		return ERANGE;
+	}
+	*value = v;
+	return 0;
+}
+
+SVDEF int sv_parse_u64(StringView sv, uint64_t *value, size_t *consumed)
+{
+	return sv__parse_magnitude(sv.data, sv.len, UINT64_MAX, value, consumed);
+}
+
+SVDEF int sv_parse_u32(StringView sv, uint32_t *value, size_t *consumed)
+{
+	uint64_t v;
+	int err = sv__parse_magnitude(sv.data, sv.len, UINT32_MAX, &v, consumed);
+	*value = v;
+	return err;
+}
+
+SVDEF int sv_parse_i64(StringView sv, int64_t *value, size_t *consumed)
+{
+	size_t sign = sv.len && (sv.data[0] == '-' || sv.data[0] == '+');
+	bool negative = sign && sv.data[0] == '-';
+	uint64_t magnitude;
+	int err = sv__parse_magnitude(sv.data + sign, sv.len - sign, negative ? (uint64_t)INT64_MAX + 1 : INT64_MAX,
+								  &magnitude, consumed);
+	if (consumed && err != EINVAL)
+		*consumed += sign;
+	if (!negative)
+		*value = magnitude;
+	else
+		*value = magnitude > (uint64_t)INT64_MAX ? INT64_MIN : -(int64_t)magnitude;
+	return err;
+}
+
+#if defined(__GNUC__)
+#define SV__PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define SV__PREFETCH(addr) ((void)(addr))
+#endif
+
+static const uint64_t sv__hash_secret[4] = {0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL,
+											0x589965cc75374cc3ULL};
+
+static inline void sv__mum(uint64_t *a, uint64_t *b)
+{
+	/*Full 64x64 -> 128 bit product, low half to a, high half to b.*/
+#ifdef __SIZEOF_INT128__
+	__uint128_t r = (__uint128_t)*a * *b;
+	*a = (uint64_t)r;
+	*b = (uint64_t)(r >> 64);
+#else
+	uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32), c = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+	c += lo < t;
+	*a = lo;
+	*b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t sv__mix(uint64_t a, uint64_t b)
+{
+	sv__mum(&a, &b);
+	return a ^ b;
+}
+
+static inline uint64_t sv__read64(const char *p)
+{
+	uint64_t v;
+	memcpy(&v, p, 8);
+	return v;
+}
+
+static inline uint64_t sv__read32(const char *p)
+{
+	uint32_t v;
+	memcpy(&v, p, 4);
+	return v;
+}
+
+SVDEF uint64_t sv_hash_seeded(StringView sv, uint64_t seed)
+{
+	const char *p = sv.data;
+	size_t len = sv.len;
+	const uint64_t *s = sv__hash_secret;
+	uint64_t a, b;
+	seed ^= sv__mix(seed ^ s[0], s[1]);
+	if (len <= 16)
+	{
+		if (len >= 4)
+		{
+			// Two overlapping pairs of 4-byte reads cover any length from 4 to 16.
+			size_t mid = (len >> 3) << 2;
+			a = (sv__read32(p) << 32) | sv__read32(p + mid);
+			b = (sv__read32(p + len - 4) << 32) | sv__read32(p + len - 4 - mid);
+		}
+		else if (len > 0)
+		{
+			a = ((uint64_t)(unsigned char)p[0] << 16) | ((uint64_t)(unsigned char)p[len >> 1] << 8) |
+				(unsigned char)p[len - 1];
+			b = 0;
+		}
+		else
+		{
+			a = b = 0;
+		}
+	}
+	else
+	{
+		size_t i = len;
+		if (i > 48)
+		{
+			uint64_t lane1 = seed, lane2 = seed;
+			do
+			{
+				seed = sv__mix(sv__read64(p) ^ s[1], sv__read64(p + 8) ^ seed);
+				lane1 = sv__mix(sv__read64(p + 16) ^ s[2], sv__read64(p + 24) ^ lane1);
+				lane2 = sv__mix(sv__read64(p + 32) ^ s[3], sv__read64(p + 40) ^ lane2);
+				p += 48;
+				i -= 48;
+			} while (i > 48);
+			seed ^= lane1 ^ lane2;
+		}
+		while (i > 16)
+		{
+			seed = sv__mix(sv__read64(p) ^ s[1], sv__read64(p + 8) ^ seed);
+			p += 16;
+			i -= 16;
+		}
+		a = sv__read64(p + i - 16);
+		b = sv__read64(p + i - 8);
+	}
+	a ^= s[1];
+	b ^= seed;
+	sv__mum(&a, &b);
+	return sv__mix(a ^ s[0] ^ len, b ^ s[1]);
+}
+
+SVDEF uint64_t sv_hash(StringView sv)
+{
+	return sv_hash_seeded(sv, 0);
+}
+
+/* Float parsing. The digits are read into a 64-bit mantissa w and a power of
+ten q. Small exact cases are one IEEE multiply or divide (Clinger). The rest go
+through Eisel-Lemire: w times a 128-bit truncation of 5^q gives the binary
+mantissa, and the rare inputs it cannot round with certainty fall back to an
+exact decimal-shifting conversion. */
+typedef struct sv__float_format
+{
+	int mantissa_bits;
+	int min_exponent;
+	int infinite_power;
+	int smallest_power_of_ten;
+	int largest_power_of_ten;
+	int min_round_to_even;
+	int max_round_to_even;
+	int sign_bit;
+} sv__float_format;
+
+static const sv__float_format sv__double_format = {52, -1023, 0x7FF, -342, 308, -4, 23, 63};
+static const sv__float_format sv__float_format32 = {23, -127, 0xFF, -65, 38, -17, 10, 31};
+
+#define SV__SMALLEST_POWER_OF_FIVE -342
+
+/* 5^q for q in [-342, 308], normalized to 128 bits with the top bit set and
+truncated (negative powers rounded up), high word first. */
+static const uint64_t sv__pow5_128[1302] = {
+	0xeef453d6923bd65aULL, 0x113faa2906a13b3fULL, 0x9558b4661b6565f8ULL, 0x4ac7ca59a424c507ULL,
+	0xbaaee17fa23ebf76ULL, 0x5d79bcf00d2df649ULL, 0xe95a99df8ace6f53ULL, 0xf4d82c2c107973dcULL,
+	0x91d8a02bb6c10594ULL, 0x79071b9b8a4be869ULL, 0xb64ec836a47146f9ULL, 0x9748e2826cdee284ULL,
+	0xe3e27a444d8d98b7ULL, 0xfd1b1b2308169b25ULL, 0x8e6d8c6ab0787f72ULL, 0xfe30f0f5e50e20f7ULL,
+	0xb208ef855c969f4fULL, 0xbdbd2d335e51a935ULL, 0xde8b2b66b3bc4723ULL, 0xad2c788035e61382ULL,
+	0x8b16fb203055ac76ULL, 0x4c3bcb5021afcc31ULL, 0xaddcb9e83c6b1793ULL, 0xdf4abe242a1bbf3dULL,
+	0xd953e8624b85dd78ULL, 0xd71d6dad34a2af0dULL, 0x87d4713d6f33aa6bULL, 0x8672648c40e5ad68ULL,
+	0xa9c98d8ccb009506ULL, 0x680efdaf511f18c2ULL, 0xd43bf0effdc0ba48ULL, 0x0212bd1b2566def2ULL,
+	0x84a57695fe98746dULL, 0x014bb630f7604b57ULL, 0xa5ced43b7e3e9188ULL, 0x419ea3bd35385e2dULL,
+	0xcf42894a5dce35eaULL, 0x52064cac828675b9ULL, 0x818995ce7aa0e1b2ULL, 0x7343efebd1940993ULL,
+	0xa1ebfb4219491a1fULL, 0x1014ebe6c5f90bf8ULL, 0xca66fa129f9b60a6ULL, 0xd41a26e077774ef6ULL,
+	0xfd00b897478238d0ULL, 0x8920b098955522b4ULL, 0x9e20735e8cb16382ULL, 0x55b46e5f5d5535b0ULL,
+	0xc5a890362fddbc62ULL, 0xeb2189f734aa831dULL, 0xf712b443bbd52b7bULL, 0xa5e9ec7501d523e4ULL,
+	0x9a6bb0aa55653b2dULL, 0x47b233c92125366eULL, 0xc1069cd4eabe89f8ULL, 0x999ec0bb696e840aULL,
+	0xf148440a256e2c76ULL, 0xc00670ea43ca250dULL, 0x96cd2a865764dbcaULL, 0x380406926a5e5728ULL,
+	0xbc807527ed3e12bcULL, 0xc605083704f5ecf2ULL, 0xeba09271e88d976bULL, 0xf7864a44c633682eULL,
+	0x93445b8731587ea3ULL, 0x7ab3ee6afbe0211dULL, 0xb8157268fdae9e4cULL, 0x5960ea05bad82964ULL,
+	0xe61acf033d1a45dfULL, 0x6fb92487298e33bdULL, 0x8fd0c16206306babULL, 0xa5d3b6d479f8e056ULL,
+	0xb3c4f1ba87bc8696ULL, 0x8f48a4899877186cULL, 0xe0b62e2929aba83cULL, 0x331acdabfe94de87ULL,
+	0x8c71dcd9ba0b4925ULL, 0x9ff0c08b7f1d0b14ULL, 0xaf8e5410288e1b6fULL, 0x07ecf0ae5ee44dd9ULL,
+	0xdb71e91432b1a24aULL, 0xc9e82cd9f69d6150ULL, 0x892731ac9faf056eULL, 0xbe311c083a225cd2ULL,
+	0xab70fe17c79ac6caULL, 0x6dbd630a48aaf406ULL, 0xd64d3d9db981787dULL, 0x092cbbccdad5b108ULL,
+	0x85f0468293f0eb4eULL, 0x25bbf56008c58ea5ULL, 0xa76c582338ed2621ULL, 0xaf2af2b80af6f24eULL,
+	0xd1476e2c07286faaULL, 0x1af5af660db4aee1ULL, 0x82cca4db847945caULL, 0x50d98d9fc890ed4dULL,
+	0xa37fce126597973cULL, 0xe50ff107bab528a0ULL, 0xcc5fc196fefd7d0cULL, 0x1e53ed49a96272c8ULL,
+	0xff77b1fcbebcdc4fULL, 0x25e8e89c13bb0f7aULL, 0x9faacf3df73609b1ULL, 0x77b191618c54e9acULL,
+	0xc795830d75038c1dULL, 0xd59df5b9ef6a2417ULL, 0xf97ae3d0d2446f25ULL, 0x4b0573286b44ad1dULL,
+	0x9becce62836ac577ULL, 0x4ee367f9430aec32ULL, 0xc2e801fb244576d5ULL, 0x229c41f793cda73fULL,
+	0xf3a20279ed56d48aULL, 0x6b43527578c1110fULL, 0x9845418c345644d6ULL, 0x830a13896b78aaa9ULL,
+	0xbe5691ef416bd60cULL, 0x23cc986bc656d553ULL, 0xedec366b11c6cb8fULL, 0x2cbfbe86b7ec8aa8ULL,
+	0x94b3a202eb1c3f39ULL, 0x7bf7d71432f3d6a9ULL, 0xb9e08a83a5e34f07ULL, 0xdaf5ccd93fb0cc53ULL,
+	0xe858ad248f5c22c9ULL, 0xd1b3400f8f9cff68ULL, 0x91376c36d99995beULL, 0x23100809b9c21fa1ULL,
+	0xb58547448ffffb2dULL, 0xabd40a0c2832a78aULL, 0xe2e69915b3fff9f9ULL, 0x16c90c8f323f516cULL,
+	0x8dd01fad907ffc3bULL, 0xae3da7d97f6792e3ULL, 0xb1442798f49ffb4aULL, 0x99cd11cfdf41779cULL,
+	0xdd95317f31c7fa1dULL, 0x40405643d711d583ULL, 0x8a7d3eef7f1cfc52ULL, 0x482835ea666b2572ULL,
+	0xad1c8eab5ee43b66ULL, 0xda3243650005eecfULL, 0xd863b256369d4a40ULL, 0x90bed43e40076a82ULL,
+	0x873e4f75e2224e68ULL, 0x5a7744a6e804a291ULL, 0xa90de3535aaae202ULL, 0x711515d0a205cb36ULL,
+	0xd3515c2831559a83ULL, 0x0d5a5b44ca873e03ULL, 0x8412d9991ed58091ULL, 0xe858790afe9486c2ULL,
+	0xa5178fff668ae0b6ULL, 0x626e974dbe39a872ULL, 0xce5d73ff402d98e3ULL, 0xfb0a3d212dc8128fULL,
+	0x80fa687f881c7f8eULL, 0x7ce66634bc9d0b99ULL, 0xa139029f6a239f72ULL, 0x1c1fffc1ebc44e80ULL,
+	0xc987434744ac874eULL, 0xa327ffb266b56220ULL, 0xfbe9141915d7a922ULL, 0x4bf1ff9f0062baa8ULL,
+	0x9d71ac8fada6c9b5ULL, 0x6f773fc3603db4a9ULL, 0xc4ce17b399107c22ULL, 0xcb550fb4384d21d3ULL,
+	0xf6019da07f549b2bULL, 0x7e2a53a146606a48ULL, 0x99c102844f94e0fbULL, 0x2eda7444cbfc426dULL,
+	0xc0314325637a1939ULL, 0xfa911155fefb5308ULL, 0xf03d93eebc589f88ULL, 0x793555ab7eba27caULL,
+	0x96267c7535b763b5ULL, 0x4bc1558b2f3458deULL, 0xbbb01b9283253ca2ULL, 0x9eb1aaedfb016f16ULL,
+	0xea9c227723ee8bcbULL, 0x465e15a979c1cadcULL, 0x92a1958a7675175fULL, 0x0bfacd89ec191ec9ULL,
+	0xb749faed14125d36ULL, 0xcef980ec671f667bULL, 0xe51c79a85916f484ULL, 0x82b7e12780e7401aULL,
+	0x8f31cc0937ae58d2ULL, 0xd1b2ecb8b0908810ULL, 0xb2fe3f0b8599ef07ULL, 0x861fa7e6dcb4aa15ULL,
+	0xdfbdcece67006ac9ULL, 0x67a791e093e1d49aULL, 0x8bd6a141006042bdULL, 0xe0c8bb2c5c6d24e0ULL,
+	0xaecc49914078536dULL, 0x58fae9f773886e18ULL, 0xda7f5bf590966848ULL, 0xaf39a475506a899eULL,
+	0x888f99797a5e012dULL, 0x6d8406c952429603ULL, 0xaab37fd7d8f58178ULL, 0xc8e5087ba6d33b83ULL,
+	0xd5605fcdcf32e1d6ULL, 0xfb1e4a9a90880a64ULL, 0x855c3be0a17fcd26ULL, 0x5cf2eea09a55067fULL,
+	0xa6b34ad8c9dfc06fULL, 0xf42faa48c0ea481eULL, 0xd0601d8efc57b08bULL, 0xf13b94daf124da26ULL,
+	0x823c12795db6ce57ULL, 0x76c53d08d6b70858ULL, 0xa2cb1717b52481edULL, 0x54768c4b0c64ca6eULL,
+	0xcb7ddcdda26da268ULL, 0xa9942f5dcf7dfd09ULL, 0xfe5d54150b090b02ULL, 0xd3f93b35435d7c4cULL,
+	0x9efa548d26e5a6e1ULL, 0xc47bc5014a1a6dafULL, 0xc6b8e9b0709f109aULL, 0x359ab6419ca1091bULL,
+	0xf867241c8cc6d4c0ULL, 0xc30163d203c94b62ULL, 0x9b407691d7fc44f8ULL, 0x79e0de63425dcf1dULL,
+	0xc21094364dfb5636ULL, 0x985915fc12f542e4ULL, 0xf294b943e17a2bc4ULL, 0x3e6f5b7b17b2939dULL,
+	0x979cf3ca6cec5b5aULL, 0xa705992ceecf9c42ULL, 0xbd8430bd08277231ULL, 0x50c6ff782a838353ULL,
+	0xece53cec4a314ebdULL, 0xa4f8bf5635246428ULL, 0x940f4613ae5ed136ULL, 0x871b7795e136be99ULL,
+	0xb913179899f68584ULL, 0x28e2557b59846e3fULL, 0xe757dd7ec07426e5ULL, 0x331aeada2fe589cfULL,
+	0x9096ea6f3848984fULL, 0x3ff0d2c85def7621ULL, 0xb4bca50b065abe63ULL, 0x0fed077a756b53a9ULL,
+	0xe1ebce4dc7f16dfbULL, 0xd3e8495912c62894ULL, 0x8d3360f09cf6e4bdULL, 0x64712dd7abbbd95cULL,
+	0xb080392cc4349decULL, 0xbd8d794d96aacfb3ULL, 0xdca04777f541c567ULL, 0xecf0d7a0fc5583a0ULL,
+	0x89e42caaf9491b60ULL, 0xf41686c49db57244ULL, 0xac5d37d5b79b6239ULL, 0x311c2875c522ced5ULL,
+	0xd77485cb25823ac7ULL, 0x7d633293366b828bULL, 0x86a8d39ef77164bcULL, 0xae5dff9c02033197ULL,
+	0xa8530886b54dbdebULL, 0xd9f57f830283fdfcULL, 0xd267caa862a12d66ULL, 0xd072df63c324fd7bULL,
+	0x8380dea93da4bc60ULL, 0x4247cb9e59f71e6dULL, 0xa46116538d0deb78ULL, 0x52d9be85f074e608ULL,
+	0xcd795be870516656ULL, 0x67902e276c921f8bULL, 0x806bd9714632dff6ULL, 0x00ba1cd8a3db53b6ULL,
+	0xa086cfcd97bf97f3ULL, 0x80e8a40eccd228a4ULL, 0xc8a883c0fdaf7df0ULL, 0x6122cd128006b2cdULL,
+	0xfad2a4b13d1b5d6cULL, 0x796b805720085f81ULL, 0x9cc3a6eec6311a63ULL, 0xcbe3303674053bb0ULL,
+	0xc3f490aa77bd60fcULL, 0xbedbfc4411068a9cULL, 0xf4f1b4d515acb93bULL, 0xee92fb5515482d44ULL,
+	0x991711052d8bf3c5ULL, 0x751bdd152d4d1c4aULL, 0xbf5cd54678eef0b6ULL, 0xd262d45a78a0635dULL,
+	0xef340a98172aace4ULL, 0x86fb897116c87c34ULL, 0x9580869f0e7aac0eULL, 0xd45d35e6ae3d4da0ULL,
+	0xbae0a846d2195712ULL, 0x8974836059cca109ULL, 0xe998d258869facd7ULL, 0x2bd1a438703fc94bULL,
+	0x91ff83775423cc06ULL, 0x7b6306a34627ddcfULL, 0xb67f6455292cbf08ULL, 0x1a3bc84c17b1d542ULL,
+	0xe41f3d6a7377eecaULL, 0x20caba5f1d9e4a93ULL, 0x8e938662882af53eULL, 0x547eb47b7282ee9cULL,
+	0xb23867fb2a35b28dULL, 0xe99e619a4f23aa43ULL, 0xdec681f9f4c31f31ULL, 0x6405fa00e2ec94d4ULL,
+	0x8b3c113c38f9f37eULL, 0xde83bc408dd3dd04ULL, 0xae0b158b4738705eULL, 0x9624ab50b148d445ULL,
+	0xd98ddaee19068c76ULL, 0x3badd624dd9b0957ULL, 0x87f8a8d4cfa417c9ULL, 0xe54ca5d70a80e5d6ULL,
+	0xa9f6d30a038d1dbcULL, 0x5e9fcf4ccd211f4cULL, 0xd47487cc8470652bULL, 0x7647c3200069671fULL,
+	0x84c8d4dfd2c63f3bULL, 0x29ecd9f40041e073ULL, 0xa5fb0a17c777cf09ULL, 0xf468107100525890ULL,
+	0xcf79cc9db955c2ccULL, 0x7182148d4066eeb4ULL, 0x81ac1fe293d599bfULL, 0xc6f14cd848405530ULL,
+	0xa21727db38cb002fULL, 0xb8ada00e5a506a7cULL, 0xca9cf1d206fdc03bULL, 0xa6d90811f0e4851cULL,
+	0xfd442e4688bd304aULL, 0x908f4a166d1da663ULL, 0x9e4a9cec15763e2eULL, 0x9a598e4e043287feULL,
+	0xc5dd44271ad3cdbaULL, 0x40eff1e1853f29fdULL, 0xf7549530e188c128ULL, 0xd12bee59e68ef47cULL,
+	0x9a94dd3e8cf578b9ULL, 0x82bb74f8301958ceULL, 0xc13a148e3032d6e7ULL, 0xe36a52363c1faf01ULL,
+	0xf18899b1bc3f8ca1ULL, 0xdc44e6c3cb279ac1ULL, 0x96f5600f15a7b7e5ULL, 0x29ab103a5ef8c0b9ULL,
+	0xbcb2b812db11a5deULL, 0x7415d448f6b6f0e7ULL, 0xebdf661791d60f56ULL, 0x111b495b3464ad21ULL,
+	0x936b9fcebb25c995ULL, 0xcab10dd900beec34ULL, 0xb84687c269ef3bfbULL, 0x3d5d514f40eea742ULL,
+	0xe65829b3046b0afaULL, 0x0cb4a5a3112a5112ULL, 0x8ff71a0fe2c2e6dcULL, 0x47f0e785eaba72abULL,
+	0xb3f4e093db73a093ULL, 0x59ed216765690f56ULL, 0xe0f218b8d25088b8ULL, 0x306869c13ec3532cULL,
+	0x8c974f7383725573ULL, 0x1e414218c73a13fbULL, 0xafbd2350644eeacfULL, 0xe5d1929ef90898faULL,
+	0xdbac6c247d62a583ULL, 0xdf45f746b74abf39ULL, 0x894bc396ce5da772ULL, 0x6b8bba8c328eb783ULL,
+	0xab9eb47c81f5114fULL, 0x066ea92f3f326564ULL, 0xd686619ba27255a2ULL, 0xc80a537b0efefebdULL,
+	0x8613fd0145877585ULL, 0xbd06742ce95f5f36ULL, 0xa798fc4196e952e7ULL, 0x2c48113823b73704ULL,
+	0xd17f3b51fca3a7a0ULL, 0xf75a15862ca504c5ULL, 0x82ef85133de648c4ULL, 0x9a984d73dbe722fbULL,
+	0xa3ab66580d5fdaf5ULL, 0xc13e60d0d2e0ebbaULL, 0xcc963fee10b7d1b3ULL, 0x318df905079926a8ULL,
+	0xffbbcfe994e5c61fULL, 0xfdf17746497f7052ULL, 0x9fd561f1fd0f9bd3ULL, 0xfeb6ea8bedefa633ULL,
+	0xc7caba6e7c5382c8ULL, 0xfe64a52ee96b8fc0ULL, 0xf9bd690a1b68637bULL, 0x3dfdce7aa3c673b0ULL,
+	0x9c1661a651213e2dULL, 0x06bea10ca65c084eULL, 0xc31bfa0fe5698db8ULL, 0x486e494fcff30a62ULL,
+	0xf3e2f893dec3f126ULL, 0x5a89dba3c3efccfaULL, 0x986ddb5c6b3a76b7ULL, 0xf89629465a75e01cULL,
+	0xbe89523386091465ULL, 0xf6bbb397f1135823ULL, 0xee2ba6c0678b597fULL, 0x746aa07ded582e2cULL,
+	0x94db483840b717efULL, 0xa8c2a44eb4571cdcULL, 0xba121a4650e4ddebULL, 0x92f34d62616ce413ULL,
+	0xe896a0d7e51e1566ULL, 0x77b020baf9c81d17ULL, 0x915e2486ef32cd60ULL, 0x0ace1474dc1d122eULL,
+	0xb5b5ada8aaff80b8ULL, 0x0d819992132456baULL, 0xe3231912d5bf60e6ULL, 0x10e1fff697ed6c69ULL,
+	0x8df5efabc5979c8fULL, 0xca8d3ffa1ef463c1ULL, 0xb1736b96b6fd83b3ULL, 0xbd308ff8a6b17cb2ULL,
+	0xddd0467c64bce4a0ULL, 0xac7cb3f6d05ddbdeULL, 0x8aa22c0dbef60ee4ULL, 0x6bcdf07a423aa96bULL,
+	0xad4ab7112eb3929dULL, 0x86c16c98d2c953c6ULL, 0xd89d64d57a607744ULL, 0xe871c7bf077ba8b7ULL,
+	0x87625f056c7c4a8bULL, 0x11471cd764ad4972ULL, 0xa93af6c6c79b5d2dULL, 0xd598e40d3dd89bcfULL,
+	0xd389b47879823479ULL, 0x4aff1d108d4ec2c3ULL, 0x843610cb4bf160cbULL, 0xcedf722a585139baULL,
+	0xa54394fe1eedb8feULL, 0xc2974eb4ee658828ULL, 0xce947a3da6a9273eULL, 0x733d226229feea32ULL,
+	0x811ccc668829b887ULL, 0x0806357d5a3f525fULL, 0xa163ff802a3426a8ULL, 0xca07c2dcb0cf26f7ULL,
+	0xc9bcff6034c13052ULL, 0xfc89b393dd02f0b5ULL, 0xfc2c3f3841f17c67ULL, 0xbbac2078d443ace2ULL,
+	0x9d9ba7832936edc0ULL, 0xd54b944b84aa4c0dULL, 0xc5029163f384a931ULL, 0x0a9e795e65d4df11ULL,
+	0xf64335bcf065d37dULL, 0x4d4617b5ff4a16d5ULL, 0x99ea0196163fa42eULL, 0x504bced1bf8e4e45ULL,
+	0xc06481fb9bcf8d39ULL, 0xe45ec2862f71e1d6ULL, 0xf07da27a82c37088ULL, 0x5d767327bb4e5a4cULL,
+	0x964e858c91ba2655ULL, 0x3a6a07f8d510f86fULL, 0xbbe226efb628afeaULL, 0x890489f70a55368bULL,
+	0xeadab0aba3b2dbe5ULL, 0x2b45ac74ccea842eULL, 0x92c8ae6b464fc96fULL, 0x3b0b8bc90012929dULL,
+	0xb77ada0617e3bbcbULL, 0x09ce6ebb40173744ULL, 0xe55990879ddcaabdULL, 0xcc420a6a101d0515ULL,
+	0x8f57fa54c2a9eab6ULL, 0x9fa946824a12232dULL, 0xb32df8e9f3546564ULL, 0x47939822dc96abf9ULL,
+	0xdff9772470297ebdULL, 0x59787e2b93bc56f7ULL, 0x8bfbea76c619ef36ULL, 0x57eb4edb3c55b65aULL,
+	0xaefae51477a06b03ULL, 0xede622920b6b23f1ULL, 0xdab99e59958885c4ULL, 0xe95fab368e45ecedULL,
+	0x88b402f7fd75539bULL, 0x11dbcb0218ebb414ULL, 0xaae103b5fcd2a881ULL, 0xd652bdc29f26a119ULL,
+	0xd59944a37c0752a2ULL, 0x4be76d3346f0495fULL, 0x857fcae62d8493a5ULL, 0x6f70a4400c562ddbULL,
+	0xa6dfbd9fb8e5b88eULL, 0xcb4ccd500f6bb952ULL, 0xd097ad07a71f26b2ULL, 0x7e2000a41346a7a7ULL,
+	0x825ecc24c873782fULL, 0x8ed400668c0c28c8ULL, 0xa2f67f2dfa90563bULL, 0x728900802f0f32faULL,
+	0xcbb41ef979346bcaULL, 0x4f2b40a03ad2ffb9ULL, 0xfea126b7d78186bcULL, 0xe2f610c84987bfa8ULL,
+	0x9f24b832e6b0f436ULL, 0x0dd9ca7d2df4d7c9ULL, 0xc6ede63fa05d3143ULL, 0x91503d1c79720dbbULL,
+	0xf8a95fcf88747d94ULL, 0x75a44c6397ce912aULL, 0x9b69dbe1b548ce7cULL, 0xc986afbe3ee11abaULL,
+	0xc24452da229b021bULL, 0xfbe85badce996168ULL, 0xf2d56790ab41c2a2ULL, 0xfae27299423fb9c3ULL,
+	0x97c560ba6b0919a5ULL, 0xdccd879fc967d41aULL, 0xbdb6b8e905cb600fULL, 0x5400e987bbc1c920ULL,
+	0xed246723473e3813ULL, 0x290123e9aab23b68ULL, 0x9436c0760c86e30bULL, 0xf9a0b6720aaf6521ULL,
+	0xb94470938fa89bceULL, 0xf808e40e8d5b3e69ULL, 0xe7958cb87392c2c2ULL, 0xb60b1d1230b20e04ULL,
+	0x90bd77f3483bb9b9ULL, 0xb1c6f22b5e6f48c2ULL, 0xb4ecd5f01a4aa828ULL, 0x1e38aeb6360b1af3ULL,
+	0xe2280b6c20dd5232ULL, 0x25c6da63c38de1b0ULL, 0x8d590723948a535fULL, 0x579c487e5a38ad0eULL,
+	0xb0af48ec79ace837ULL, 0x2d835a9df0c6d851ULL, 0xdcdb1b2798182244ULL, 0xf8e431456cf88e65ULL,
+	0x8a08f0f8bf0f156bULL, 0x1b8e9ecb641b58ffULL, 0xac8b2d36eed2dac5ULL, 0xe272467e3d222f3fULL,
+	0xd7adf884aa879177ULL, 0x5b0ed81dcc6abb0fULL, 0x86ccbb52ea94baeaULL, 0x98e947129fc2b4e9ULL,
+	0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL, 0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL,
+	0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL, 0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL,
+	0xcdb02555653131b6ULL, 0x3792f412cb06794dULL, 0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL,
+	0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL, 0xc8de047564d20a8bULL, 0xf245825a5a445275ULL,
+	0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL, 0x9ced737bb6c4183dULL, 0x55464dd69685606bULL,
+	0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL, 0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL,
+	0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL, 0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL,
+	0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL, 0x95a8637627989aadULL, 0xdde7001379a44aa8ULL,
+	0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL, 0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL,
+	0x9226712162ab070dULL, 0xcab3961304ca70e8ULL, 0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL,
+	0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL, 0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL,
+	0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL, 0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL,
+	0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL, 0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL,
+	0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL, 0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL,
+	0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL, 0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL,
+	0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL, 0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL,
+	0xcfb11ead453994baULL, 0x67de18eda5814af2ULL, 0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL,
+	0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL, 0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL,
+	0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL, 0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL,
+	0xc612062576589ddaULL, 0x95364afe032a819eULL, 0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL,
+	0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL, 0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL,
+	0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL, 0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL,
+	0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL, 0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL,
+	0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL, 0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL,
+	0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL, 0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL,
+	0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL, 0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL,
+	0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL, 0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL,
+	0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL, 0x89705f4136b4a597ULL, 0x31680a88f8953031ULL,
+	0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL, 0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL,
+	0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL, 0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL,
+	0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL, 0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL,
+	0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL, 0xccccccccccccccccULL, 0xcccccccccccccccdULL,
+	0x8000000000000000ULL, 0x0000000000000000ULL, 0xa000000000000000ULL, 0x0000000000000000ULL,
+	0xc800000000000000ULL, 0x0000000000000000ULL, 0xfa00000000000000ULL, 0x0000000000000000ULL,
+	0x9c40000000000000ULL, 0x0000000000000000ULL, 0xc350000000000000ULL, 0x0000000000000000ULL,
+	0xf424000000000000ULL, 0x0000000000000000ULL, 0x9896800000000000ULL, 0x0000000000000000ULL,
+	0xbebc200000000000ULL, 0x0000000000000000ULL, 0xee6b280000000000ULL, 0x0000000000000000ULL,
+	0x9502f90000000000ULL, 0x0000000000000000ULL, 0xba43b74000000000ULL, 0x0000000000000000ULL,
+	0xe8d4a51000000000ULL, 0x0000000000000000ULL, 0x9184e72a00000000ULL, 0x0000000000000000ULL,
+	0xb5e620f480000000ULL, 0x0000000000000000ULL, 0xe35fa931a0000000ULL, 0x0000000000000000ULL,
+	0x8e1bc9bf04000000ULL, 0x0000000000000000ULL, 0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL,
+	0xde0b6b3a76400000ULL, 0x0000000000000000ULL, 0x8ac7230489e80000ULL, 0x0000000000000000ULL,
+	0xad78ebc5ac620000ULL, 0x0000000000000000ULL, 0xd8d726b7177a8000ULL, 0x0000000000000000ULL,
+	0x878678326eac9000ULL, 0x0000000000000000ULL, 0xa968163f0a57b400ULL, 0x0000000000000000ULL,
+	0xd3c21bcecceda100ULL, 0x0000000000000000ULL, 0x84595161401484a0ULL, 0x0000000000000000ULL,
+	0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL, 0xcecb8f27f4200f3aULL, 0x0000000000000000ULL,
+	0x813f3978f8940984ULL, 0x4000000000000000ULL, 0xa18f07d736b90be5ULL, 0x5000000000000000ULL,
+	0xc9f2c9cd04674edeULL, 0xa400000000000000ULL, 0xfc6f7c4045812296ULL, 0x4d00000000000000ULL,
+	0x9dc5ada82b70b59dULL, 0xf020000000000000ULL, 0xc5371912364ce305ULL, 0x6c28000000000000ULL,
+	0xf684df56c3e01bc6ULL, 0xc732000000000000ULL, 0x9a130b963a6c115cULL, 0x3c7f400000000000ULL,
+	0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL, 0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL,
+	0x96769950b50d88f4ULL, 0x1314448000000000ULL, 0xbc143fa4e250eb31ULL, 0x17d955a000000000ULL,
+	0xeb194f8e1ae525fdULL, 0x5dcfab0800000000ULL, 0x92efd1b8d0cf37beULL, 0x5aa1cae500000000ULL,
+	0xb7abc627050305adULL, 0xf14a3d9e40000000ULL, 0xe596b7b0c643c719ULL, 0x6d9ccd05d0000000ULL,
+	0x8f7e32ce7bea5c6fULL, 0xe4820023a2000000ULL, 0xb35dbf821ae4f38bULL, 0xdda2802c8a800000ULL,
+	0xe0352f62a19e306eULL, 0xd50b2037ad200000ULL, 0x8c213d9da502de45ULL, 0x4526f422cc340000ULL,
+	0xaf298d050e4395d6ULL, 0x9670b12b7f410000ULL, 0xdaf3f04651d47b4cULL, 0x3c0cdd765f114000ULL,
+	0x88d8762bf324cd0fULL, 0xa5880a69fb6ac800ULL, 0xab0e93b6efee0053ULL, 0x8eea0d047a457a00ULL,
+	0xd5d238a4abe98068ULL, 0x72a4904598d6d880ULL, 0x85a36366eb71f041ULL, 0x47a6da2b7f864750ULL,
+	0xa70c3c40a64e6c51ULL, 0x999090b65f67d924ULL, 0xd0cf4b50cfe20765ULL, 0xfff4b4e3f741cf6dULL,
+	0x82818f1281ed449fULL, 0xbff8f10e7a8921a4ULL, 0xa321f2d7226895c7ULL, 0xaff72d52192b6a0dULL,
+	0xcbea6f8ceb02bb39ULL, 0x9bf4f8a69f764490ULL, 0xfee50b7025c36a08ULL, 0x02f236d04753d5b4ULL,
+	0x9f4f2726179a2245ULL, 0x01d762422c946590ULL, 0xc722f0ef9d80aad6ULL, 0x424d3ad2b7b97ef5ULL,
+	0xf8ebad2b84e0d58bULL, 0xd2e0898765a7deb2ULL, 0x9b934c3b330c8577ULL, 0x63cc55f49f88eb2fULL,
+	0xc2781f49ffcfa6d5ULL, 0x3cbf6b71c76b25fbULL, 0xf316271c7fc3908aULL, 0x8bef464e3945ef7aULL,
+	0x97edd871cfda3a56ULL, 0x97758bf0e3cbb5acULL, 0xbde94e8e43d0c8ecULL, 0x3d52eeed1cbea317ULL,
+	0xed63a231d4c4fb27ULL, 0x4ca7aaa863ee4bddULL, 0x945e455f24fb1cf8ULL, 0x8fe8caa93e74ef6aULL,
+	0xb975d6b6ee39e436ULL, 0xb3e2fd538e122b44ULL, 0xe7d34c64a9c85d44ULL, 0x60dbbca87196b616ULL,
+	0x90e40fbeea1d3a4aULL, 0xbc8955e946fe31cdULL, 0xb51d13aea4a488ddULL, 0x6babab6398bdbe41ULL,
+	0xe264589a4dcdab14ULL, 0xc696963c7eed2dd1ULL, 0x8d7eb76070a08aecULL, 0xfc1e1de5cf543ca2ULL,
+	0xb0de65388cc8ada8ULL, 0x3b25a55f43294bcbULL, 0xdd15fe86affad912ULL, 0x49ef0eb713f39ebeULL,
+	0x8a2dbf142dfcc7abULL, 0x6e3569326c784337ULL, 0xacb92ed9397bf996ULL, 0x49c2c37f07965404ULL,
+	0xd7e77a8f87daf7fbULL, 0xdc33745ec97be906ULL, 0x86f0ac99b4e8dafdULL, 0x69a028bb3ded71a3ULL,
+	0xa8acd7c0222311bcULL, 0xc40832ea0d68ce0cULL, 0xd2d80db02aabd62bULL, 0xf50a3fa490c30190ULL,
+	0x83c7088e1aab65dbULL, 0x792667c6da79e0faULL, 0xa4b8cab1a1563f52ULL, 0x577001b891185938ULL,
+	0xcde6fd5e09abcf26ULL, 0xed4c0226b55e6f86ULL, 0x80b05e5ac60b6178ULL, 0x544f8158315b05b4ULL,
+	0xa0dc75f1778e39d6ULL, 0x696361ae3db1c721ULL, 0xc913936dd571c84cULL, 0x03bc3a19cd1e38e9ULL,
+	0xfb5878494ace3a5fULL, 0x04ab48a04065c723ULL, 0x9d174b2dcec0e47bULL, 0x62eb0d64283f9c76ULL,
+	0xc45d1df942711d9aULL, 0x3ba5d0bd324f8394ULL, 0xf5746577930d6500ULL, 0xca8f44ec7ee36479ULL,
+	0x9968bf6abbe85f20ULL, 0x7e998b13cf4e1ecbULL, 0xbfc2ef456ae276e8ULL, 0x9e3fedd8c321a67eULL,
+	0xefb3ab16c59b14a2ULL, 0xc5cfe94ef3ea101eULL, 0x95d04aee3b80ece5ULL, 0xbba1f1d158724a12ULL,
+	0xbb445da9ca61281fULL, 0x2a8a6e45ae8edc97ULL, 0xea1575143cf97226ULL, 0xf52d09d71a3293bdULL,
+	0x924d692ca61be758ULL, 0x593c2626705f9c56ULL, 0xb6e0c377cfa2e12eULL, 0x6f8b2fb00c77836cULL,
+	0xe498f455c38b997aULL, 0x0b6dfb9c0f956447ULL, 0x8edf98b59a373fecULL, 0x4724bd4189bd5eacULL,
+	0xb2977ee300c50fe7ULL, 0x58edec91ec2cb657ULL, 0xdf3d5e9bc0f653e1ULL, 0x2f2967b66737e3edULL,
+	0x8b865b215899f46cULL, 0xbd79e0d20082ee74ULL, 0xae67f1e9aec07187ULL, 0xecd8590680a3aa11ULL,
+	0xda01ee641a708de9ULL, 0xe80e6f4820cc9495ULL, 0x884134fe908658b2ULL, 0x3109058d147fdcddULL,
+	0xaa51823e34a7eedeULL, 0xbd4b46f0599fd415ULL, 0xd4e5e2cdc1d1ea96ULL, 0x6c9e18ac7007c91aULL,
+	0x850fadc09923329eULL, 0x03e2cf6bc604ddb0ULL, 0xa6539930bf6bff45ULL, 0x84db8346b786151cULL,
+	0xcfe87f7cef46ff16ULL, 0xe612641865679a63ULL, 0x81f14fae158c5f6eULL, 0x4fcb7e8f3f60c07eULL,
+	0xa26da3999aef7749ULL, 0xe3be5e330f38f09dULL, 0xcb090c8001ab551cULL, 0x5cadf5bfd3072cc5ULL,
+	0xfdcb4fa002162a63ULL, 0x73d9732fc7c8f7f6ULL, 0x9e9f11c4014dda7eULL, 0x2867e7fddcdd9afaULL,
+	0xc646d63501a1511dULL, 0xb281e1fd541501b8ULL, 0xf7d88bc24209a565ULL, 0x1f225a7ca91a4226ULL,
+	0x9ae757596946075fULL, 0x3375788de9b06958ULL, 0xc1a12d2fc3978937ULL, 0x0052d6b1641c83aeULL,
+	0xf209787bb47d6b84ULL, 0xc0678c5dbd23a49aULL, 0x9745eb4d50ce6332ULL, 0xf840b7ba963646e0ULL,
+	0xbd176620a501fbffULL, 0xb650e5a93bc3d898ULL, 0xec5d3fa8ce427affULL, 0xa3e51f138ab4cebeULL,
+	0x93ba47c980e98cdfULL, 0xc66f336c36b10137ULL, 0xb8a8d9bbe123f017ULL, 0xb80b0047445d4184ULL,
+	0xe6d3102ad96cec1dULL, 0xa60dc059157491e5ULL, 0x9043ea1ac7e41392ULL, 0x87c89837ad68db2fULL,
+	0xb454e4a179dd1877ULL, 0x29babe4598c311fbULL, 0xe16a1dc9d8545e94ULL, 0xf4296dd6fef3d67aULL,
+	0x8ce2529e2734bb1dULL, 0x1899e4a65f58660cULL, 0xb01ae745b101e9e4ULL, 0x5ec05dcff72e7f8fULL,
+	0xdc21a1171d42645dULL, 0x76707543f4fa1f73ULL, 0x899504ae72497ebaULL, 0x6a06494a791c53a8ULL,
+	0xabfa45da0edbde69ULL, 0x0487db9d17636892ULL, 0xd6f8d7509292d603ULL, 0x45a9d2845d3c42b6ULL,
+	0x865b86925b9bc5c2ULL, 0x0b8a2392ba45a9b2ULL, 0xa7f26836f282b732ULL, 0x8e6cac7768d7141eULL,
+	0xd1ef0244af2364ffULL, 0x3207d795430cd926ULL, 0x8335616aed761f1fULL, 0x7f44e6bd49e807b8ULL,
+	0xa402b9c5a8d3a6e7ULL, 0x5f16206c9c6209a6ULL, 0xcd036837130890a1ULL, 0x36dba887c37a8c0fULL,
+	0x802221226be55a64ULL, 0xc2494954da2c9789ULL, 0xa02aa96b06deb0fdULL, 0xf2db9baa10b7bd6cULL,
+	0xc83553c5c8965d3dULL, 0x6f92829494e5acc7ULL, 0xfa42a8b73abbf48cULL, 0xcb772339ba1f17f9ULL,
+	0x9c69a97284b578d7ULL, 0xff2a760414536efbULL, 0xc38413cf25e2d70dULL, 0xfef5138519684abaULL,
+	0xf46518c2ef5b8cd1ULL, 0x7eb258665fc25d69ULL, 0x98bf2f79d5993802ULL, 0xef2f773ffbd97a61ULL,
+	0xbeeefb584aff8603ULL, 0xaafb550ffacfd8faULL, 0xeeaaba2e5dbf6784ULL, 0x95ba2a53f983cf38ULL,
+	0x952ab45cfa97a0b2ULL, 0xdd945a747bf26183ULL, 0xba756174393d88dfULL, 0x94f971119aeef9e4ULL,
+	0xe912b9d1478ceb17ULL, 0x7a37cd5601aab85dULL, 0x91abb422ccb812eeULL, 0xac62e055c10ab33aULL,
+	0xb616a12b7fe617aaULL, 0x577b986b314d6009ULL, 0xe39c49765fdf9d94ULL, 0xed5a7e85fda0b80bULL,
+	0x8e41ade9fbebc27dULL, 0x14588f13be847307ULL, 0xb1d219647ae6b31cULL, 0x596eb2d8ae258fc8ULL,
+	0xde469fbd99a05fe3ULL, 0x6fca5f8ed9aef3bbULL, 0x8aec23d680043beeULL, 0x25de7bb9480d5854ULL,
+	0xada72ccc20054ae9ULL, 0xaf561aa79a10ae6aULL, 0xd910f7ff28069da4ULL, 0x1b2ba1518094da04ULL,
+	0x87aa9aff79042286ULL, 0x90fb44d2f05d0842ULL, 0xa99541bf57452b28ULL, 0x353a1607ac744a53ULL,
+	0xd3fa922f2d1675f2ULL, 0x42889b8997915ce8ULL, 0x847c9b5d7c2e09b7ULL, 0x69956135febada11ULL,
+	0xa59bc234db398c25ULL, 0x43fab9837e699095ULL, 0xcf02b2c21207ef2eULL, 0x94f967e45e03f4bbULL,
+	0x8161afb94b44f57dULL, 0x1d1be0eebac278f5ULL, 0xa1ba1ba79e1632dcULL, 0x6462d92a69731732ULL,
+	0xca28a291859bbf93ULL, 0x7d7b8f7503cfdcfeULL, 0xfcb2cb35e702af78ULL, 0x5cda735244c3d43eULL,
+	0x9defbf01b061adabULL, 0x3a0888136afa64a7ULL, 0xc56baec21c7a1916ULL, 0x088aaa1845b8fdd0ULL,
+	0xf6c69a72a3989f5bULL, 0x8aad549e57273d45ULL, 0x9a3c2087a63f6399ULL, 0x36ac54e2f678864bULL,
+	0xc0cb28a98fcf3c7fULL, 0x84576a1bb416a7ddULL, 0xf0fdf2d3f3c30b9fULL, 0x656d44a2a11c51d5ULL,
+	0x969eb7c47859e743ULL, 0x9f644ae5a4b1b325ULL, 0xbc4665b596706114ULL, 0x873d5d9f0dde1feeULL,
+	0xeb57ff22fc0c7959ULL, 0xa90cb506d155a7eaULL, 0x9316ff75dd87cbd8ULL, 0x09a7f12442d588f2ULL,
+	0xb7dcbf5354e9beceULL, 0x0c11ed6d538aeb2fULL, 0xe5d3ef282a242e81ULL, 0x8f1668c8a86da5faULL,
+	0x8fa475791a569d10ULL, 0xf96e017d694487bcULL, 0xb38d92d760ec4455ULL, 0x37c981dcc395a9acULL,
+	0xe070f78d3927556aULL, 0x85bbe253f47b1417ULL, 0x8c469ab843b89562ULL, 0x93956d7478ccec8eULL,
+	0xaf58416654a6babbULL, 0x387ac8d1970027b2ULL, 0xdb2e51bfe9d0696aULL, 0x06997b05fcc0319eULL,
+	0x88fcf317f22241e2ULL, 0x441fece3bdf81f03ULL, 0xab3c2fddeeaad25aULL, 0xd527e81cad7626c3ULL,
+	0xd60b3bd56a5586f1ULL, 0x8a71e223d8d3b074ULL, 0x85c7056562757456ULL, 0xf6872d5667844e49ULL,
+	0xa738c6bebb12d16cULL, 0xb428f8ac016561dbULL, 0xd106f86e69d785c7ULL, 0xe13336d701beba52ULL,
+	0x82a45b450226b39cULL, 0xecc0024661173473ULL, 0xa34d721642b06084ULL, 0x27f002d7f95d0190ULL,
+	0xcc20ce9bd35c78a5ULL, 0x31ec038df7b441f4ULL, 0xff290242c83396ceULL, 0x7e67047175a15271ULL,
+	0x9f79a169bd203e41ULL, 0x0f0062c6e984d386ULL, 0xc75809c42c684dd1ULL, 0x52c07b78a3e60868ULL,
+	0xf92e0c3537826145ULL, 0xa7709a56ccdf8a82ULL, 0x9bbcc7a142b17ccbULL, 0x88a66076400bb691ULL,
+	0xc2abf989935ddbfeULL, 0x6acff893d00ea435ULL, 0xf356f7ebf83552feULL, 0x0583f6b8c4124d43ULL,
+	0x98165af37b2153deULL, 0xc3727a337a8b704aULL, 0xbe1bf1b059e9a8d6ULL, 0x744f18c0592e4c5cULL,
+	0xeda2ee1c7064130cULL, 0x1162def06f79df73ULL, 0x9485d4d1c63e8be7ULL, 0x8addcb5645ac2ba8ULL,
+	0xb9a74a0637ce2ee1ULL, 0x6d953e2bd7173692ULL, 0xe8111c87c5c1ba99ULL, 0xc8fa8db6ccdd0437ULL,
+	0x910ab1d4db9914a0ULL, 0x1d9c9892400a22a2ULL, 0xb54d5e4a127f59c8ULL, 0x2503beb6d00cab4bULL,
+	0xe2a0b5dc971f303aULL, 0x2e44ae64840fd61dULL, 0x8da471a9de737e24ULL, 0x5ceaecfed289e5d2ULL,
+	0xb10d8e1456105dadULL, 0x7425a83e872c5f47ULL, 0xdd50f1996b947518ULL, 0xd12f124e28f77719ULL,
+	0x8a5296ffe33cc92fULL, 0x82bd6b70d99aaa6fULL, 0xace73cbfdc0bfb7bULL, 0x636cc64d1001550bULL,
+	0xd8210befd30efa5aULL, 0x3c47f7e05401aa4eULL, 0x8714a775e3e95c78ULL, 0x65acfaec34810a71ULL,
+	0xa8d9d1535ce3b396ULL, 0x7f1839a741a14d0dULL, 0xd31045a8341ca07cULL, 0x1ede48111209a050ULL,
+	0x83ea2b892091e44dULL, 0x934aed0aab460432ULL, 0xa4e4b66b68b65d60ULL, 0xf81da84d5617853fULL,
+	0xce1de40642e3f4b9ULL, 0x36251260ab9d668eULL, 0x80d2ae83e9ce78f3ULL, 0xc1d72b7c6b426019ULL,
+	0xa1075a24e4421730ULL, 0xb24cf65b8612f81fULL, 0xc94930ae1d529cfcULL, 0xdee033f26797b627ULL,
+	0xfb9b7cd9a4a7443cULL, 0x169840ef017da3b1ULL, 0x9d412e0806e88aa5ULL, 0x8e1f289560ee864eULL,
+	0xc491798a08a2ad4eULL, 0xf1a6f2bab92a27e2ULL, 0xf5b5d7ec8acb58a2ULL, 0xae10af696774b1dbULL,
+	0x9991a6f3d6bf1765ULL, 0xacca6da1e0a8ef29ULL, 0xbff610b0cc6edd3fULL, 0x17fd090a58d32af3ULL,
+	0xeff394dcff8a948eULL, 0xddfc4b4cef07f5b0ULL, 0x95f83d0a1fb69cd9ULL, 0x4abdaf101564f98eULL,
+	0xbb764c4ca7a4440fULL, 0x9d6d1ad41abe37f1ULL, 0xea53df5fd18d5513ULL, 0x84c86189216dc5edULL,
+	0x92746b9be2f8552cULL, 0x32fd3cf5b4e49bb4ULL, 0xb7118682dbb66a77ULL, 0x3fbc8c33221dc2a1ULL,
+	0xe4d5e82392a40515ULL, 0x0fabaf3feaa5334aULL, 0x8f05b1163ba6832dULL, 0x29cb4d87f2a7400eULL,
+	0xb2c71d5bca9023f8ULL, 0x743e20e9ef511012ULL, 0xdf78e4b2bd342cf6ULL, 0x914da9246b255416ULL,
+	0x8bab8eefb6409c1aULL, 0x1ad089b6c2f7548eULL, 0xae9672aba3d0c320ULL, 0xa184ac2473b529b1ULL,
+	0xda3c0f568cc4f3e8ULL, 0xc9e5d72d90a2741eULL, 0x8865899617fb1871ULL, 0x7e2fa67c7a658892ULL,
+	0xaa7eebfb9df9de8dULL, 0xddbb901b98feeab7ULL, 0xd51ea6fa85785631ULL, 0x552a74227f3ea565ULL,
+	0x8533285c936b35deULL, 0xd53a88958f87275fULL, 0xa67ff273b8460356ULL, 0x8a892abaf368f137ULL,
+	0xd01fef10a657842cULL, 0x2d2b7569b0432d85ULL, 0x8213f56a67f6b29bULL, 0x9c3b29620e29fc73ULL,
+	0xa298f2c501f45f42ULL, 0x8349f3ba91b47b8fULL, 0xcb3f2f7642717713ULL, 0x241c70a936219a73ULL,
+	0xfe0efb53d30dd4d7ULL, 0xed238cd383aa0110ULL, 0x9ec95d1463e8a506ULL, 0xf4363804324a40aaULL,
+	0xc67bb4597ce2ce48ULL, 0xb143c6053edcd0d5ULL, 0xf81aa16fdc1b81daULL, 0xdd94b7868e94050aULL,
+	0x9b10a4e5e9913128ULL, 0xca7cf2b4191c8326ULL, 0xc1d4ce1f63f57d72ULL, 0xfd1c2f611f63a3f0ULL,
+	0xf24a01a73cf2dccfULL, 0xbc633b39673c8cecULL, 0x976e41088617ca01ULL, 0xd5be0503e085d813ULL,
+	0xbd49d14aa79dbc82ULL, 0x4b2d8644d8a74e18ULL, 0xec9c459d51852ba2ULL, 0xddf8e7d60ed1219eULL,
+	0x93e1ab8252f33b45ULL, 0xcabb90e5c942b503ULL, 0xb8da1662e7b00a17ULL, 0x3d6a751f3b936243ULL,
+	0xe7109bfba19c0c9dULL, 0x0cc512670a783ad4ULL, 0x906a617d450187e2ULL, 0x27fb2b80668b24c5ULL,
+	0xb484f9dc9641e9daULL, 0xb1f9f660802dedf6ULL, 0xe1a63853bbd26451ULL, 0x5e7873f8a0396973ULL,
+	0x8d07e33455637eb2ULL, 0xdb0b487b6423e1e8ULL, 0xb049dc016abc5e5fULL, 0x91ce1a9a3d2cda62ULL,
+	0xdc5c5301c56b75f7ULL, 0x7641a140cc7810fbULL, 0x89b9b3e11b6329baULL, 0xa9e904c87fcb0a9dULL,
+	0xac2820d9623bf429ULL, 0x546345fa9fbdcd44ULL, 0xd732290fbacaf133ULL, 0xa97c177947ad4095ULL,
+	0x867f59a9d4bed6c0ULL, 0x49ed8eabcccc485dULL, 0xa81f301449ee8c70ULL, 0x5c68f256bfff5a74ULL,
+	0xd226fc195c6a2f8cULL, 0x73832eec6fff3111ULL, 0x83585d8fd9c25db7ULL, 0xc831fd53c5ff7eabULL,
+	0xa42e74f3d032f525ULL, 0xba3e7ca8b77f5e55ULL, 0xcd3a1230c43fb26fULL, 0x28ce1bd2e55f35ebULL,
+	0x80444b5e7aa7cf85ULL, 0x7980d163cf5b81b3ULL, 0xa0555e361951c366ULL, 0xd7e105bcc332621fULL,
+	0xc86ab5c39fa63440ULL, 0x8dd9472bf3fefaa7ULL, 0xfa856334878fc150ULL, 0xb14f98f6f0feb951ULL,
+	0x9c935e00d4b9d8d2ULL, 0x6ed1bf9a569f33d3ULL, 0xc3b8358109e84f07ULL, 0x0a862f80ec4700c8ULL,
+	0xf4a642e14c6262c8ULL, 0xcd27bb612758c0faULL, 0x98e7e9cccfbd7dbdULL, 0x8038d51cb897789cULL,
+	0xbf21e44003acdd2cULL, 0xe0470a63e6bd56c3ULL, 0xeeea5d5004981478ULL, 0x1858ccfce06cac74ULL,
+	0x95527a5202df0ccbULL, 0x0f37801e0c43ebc8ULL, 0xbaa718e68396cffdULL, 0xd30560258f54e6baULL,
+	0xe950df20247c83fdULL, 0x47c6b82ef32a2069ULL, 0x91d28b7416cdd27eULL, 0x4cdc331d57fa5441ULL,
+	0xb6472e511c81471dULL, 0xe0133fe4adf8e952ULL, 0xe3d8f9e563a198e5ULL, 0x58180fddd97723a6ULL,
+	0x8e679c2f5e44ff8fULL, 0x570f09eaa7ea7648ULL,
+};
+
+static bool sv__eisel_lemire(const sv__float_format *f, int64_t q, uint64_t w, uint64_t *bits)
+{
+	/*Exponent and mantissa bits (no sign) of w * 10^q, or false when the
+	truncated product cannot decide the rounding.*/
+	if (w == 0 || q < f->smallest_power_of_ten)
+	{
+		*bits = 0;
+		return true;
+	}
+	if (q > f->largest_power_of_ten)
+	{
+		*bits = (uint64_t)f->infinite_power << f->mantissa_bits;
+		return true;
+	}
+	int lz = __builtin_clzll(w);
+	w <<= lz;
+
+	// Only mantissa_bits + 3 high bits matter; the second 64-bit product is
+	// needed when the first leaves them undecided.
+	size_t index = 2 * (q - SV__SMALLEST_POWER_OF_FIVE);
+	uint64_t precision_mask = UINT64_MAX >> (f->mantissa_bits + 3);
+	uint64_t low = w, high = sv__pow5_128[index];
+	sv__mum(&low, &high);
+	if ((high & precision_mask) == precision_mask)
+	{
+		uint64_t low2 = w, high2 = sv__pow5_128[index + 1];
+		sv__mum(&low2, &high2);
+		low += high2;
+		if (high2 > low)
+			high++;
+	}
+	if (low == UINT64_MAX && (q < -27 || q > 55))
+		return false;
+
+	int upperbit = high >> 63;
+	int shift = upperbit + 64 - f->mantissa_bits - 3;
+	uint64_t mantissa = high >> shift;
+	int64_t power2 = (((152170 + 65536) * q) >> 16) + 63 + upperbit - lz - f->min_exponent;
+
+	if (power2 <= 0)
+	{
+		// Subnormal: shift down to the fixed exponent and round once.
+		if (-power2 + 1 >= 64)
+		{
+			*bits = 0;
+			return true;
+		}
+		mantissa >>= -power2 + 1;
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		power2 = mantissa < (1ULL << f->mantissa_bits) ? 0 : 1;
+		*bits = (mantissa & ((1ULL << f->mantissa_bits) - 1)) | ((uint64_t)power2 << f->mantissa_bits);
+		return true;
+	}
+
+	// An exact halfway product must round to even rather than up.
+	if (low <= 1 && q >= f->min_round_to_even && q <= f->max_round_to_even && (mantissa & 3) == 1 &&
+		(mantissa << shift) == high)
+		mantissa &= ~1ULL;
+	mantissa += mantissa & 1;
+	mantissa >>= 1;
+	if (mantissa >= (2ULL << f->mantissa_bits))
+	{
+		mantissa = 1ULL << f->mantissa_bits;
+		power2++;
+	}
+	mantissa &= ~(1ULL << f->mantissa_bits);
+	if (power2 >= f->infinite_power)
+	{
+		power2 = f->infinite_power;
+		mantissa = 0;
+	}
+	*bits = mantissa | ((uint64_t)power2 << f->mantissa_bits);
+	return true;
+}
+
+/* Exact fallback: the decimal digits are scaled by powers of two in place
+(simple decimal conversion, as in Go's strconv) until the binary exponent is
+known, then rounded once. Digits past the buffer only matter as "nonzero". */
+#define SV__DECIMAL_DIGITS 800
+
+typedef struct sv__decimal
+{
+	int num_digits;
+	int decimal_point;
+	bool truncated;
+	unsigned char digits[SV__DECIMAL_DIGITS];
+} sv__decimal;
+
+static void sv__decimal_trim(sv__decimal *d)
+{
+	while (d->num_digits > 0 && d->digits[d->num_digits - 1] == 0)
+		d->num_digits--;
+	if (d->num_digits == 0)
+		d->decimal_point = 0;
+}
+
+static void sv__decimal_left_shift(sv__decimal *d, int k)
+{
+	/*Multiplies by 2^k, k <= 60. A dry run of the carries first gives the
+	number of new leading digits, so the digits can be rewritten in place from
+	the back.*/
+	uint64_t n = 0;
+	for (int r = d->num_digits - 1; r >= 0; r--)
+		n = (((uint64_t)d->digits[r] << k) + n) / 10;
+	int delta = 0;
+	for (; n > 0; n /= 10)
+		delta++;
+
+	int w = d->num_digits + delta;
+	for (int r = d->num_digits - 1; r >= 0 || n > 0; r--)
+	{
+		if (r >= 0)
+			n += (uint64_t)d->digits[r] << k;
+		uint64_t quo = n / 10, rem = n - 10 * quo;
+		if (--w < SV__DECIMAL_DIGITS)
+			d->digits[w] = rem;
+		else if (rem != 0)
+			d->truncated = true;
+		n = quo;
+	}
+	d->num_digits += delta;
+	if (d->num_digits > SV__DECIMAL_DIGITS)
+		d->num_digits = SV__DECIMAL_DIGITS;
+	d->decimal_point += delta;
+	sv__decimal_trim(d);
+}
+
+static void sv__decimal_right_shift(sv__decimal *d, int k)
+{
+	/*Divides by 2^k, k <= 60.*/
+	int r = 0, w = 0;
+	uint64_t n = 0;
+	for (; (n >> k) == 0; r++)
+	{
+		if (r >= d->num_digits)
+		{
+			if (n == 0)
+			{
+				d->num_digits = 0;
+				d->decimal_point = 0;
+				return;
+			}
+			while ((n >> k) == 0)
+			{
+				n *= 10;
+				r++;
+			}
+			break;
+		}
+		n = n * 10 + d->digits[r];
+	}
+	d->decimal_point -= r - 1;
+
+	uint64_t mask = (1ULL << k) - 1;
+	for (; r < d->num_digits; r++)
+	{
+		d->digits[w++] = n >> k;
+		n = (n & mask) * 10 + d->digits[r];
+	}
+	while (n > 0)
+	{
+		uint64_t digit = n >> k;
+		n &= mask;
+		if (w < SV__DECIMAL_DIGITS)
+			d->digits[w++] = digit;
+		else if (digit > 0)
+			d->truncated = true;
+		n *= 10;
+	}
+	d->num_digits = w;
+	sv__decimal_trim(d);
+}
+
+static void sv__decimal_shift(sv__decimal *d, int shift)
+{
+	for (; shift > 60; shift -= 60)
+		sv__decimal_left_shift(d, 60);
+	for (; shift < -60; shift += 60)
+		sv__decimal_right_shift(d, 60);
+	if (shift > 0)
+		sv__decimal_left_shift(d, shift);
+	else if (shift < 0)
+		sv__decimal_right_shift(d, -shift);
+}
+
+static uint64_t sv__decimal_rounded_integer(const sv__decimal *d)
+{
+	/*Integer part, rounded half to even on the first dropped digit.*/
+	uint64_t n = 0;
+	int i = 0;
+	for (; i < d->decimal_point && i < d->num_digits; i++)
+		n = n * 10 + d->digits[i];
+	for (; i < d->decimal_point; i++)
+		n *= 10;
+	int at = d->decimal_point;
+	if (at >= 0 && at < d->num_digits)
+	{
+		if (d->digits[at] == 5 && at + 1 == d->num_digits)
+			n += d->truncated || (at > 0 && (d->digits[at - 1] & 1));
+		else
+			n += d->digits[at] >= 5;
+	}
+	return n;
+}
+
+static uint64_t sv__decimal_to_bits(sv__decimal *d, const sv__float_format *f)
+{
+	static const int powtab[9] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+	const uint64_t infinity = (uint64_t)f->infinite_power << f->mantissa_bits;
+	const int bias = f->min_exponent;
+	if (d->num_digits == 0 || d->decimal_point < -330)
+		return 0;
+	if (d->decimal_point > 310)
+		return infinity;
+
+	// Scale into [0.5, 1), keeping count of the power of two taken out.
+	int exp = 0;
+	while (d->decimal_point > 0)
+	{
+		int n = d->decimal_point >= 9 ? 27 : powtab[d->decimal_point];
+		sv__decimal_shift(d, -n);
+		exp += n;
+	}
+	while (d->decimal_point < 0 || (d->decimal_point == 0 && d->digits[0] < 5))
+	{
+		int n = -d->decimal_point >= 9 ? 27 : powtab[-d->decimal_point];
+		sv__decimal_shift(d, n);
+		exp -= n;
+	}
+	exp--;
+	if (exp < bias + 1)
+	{
+		sv__decimal_shift(d, -(bias + 1 - exp));
+		exp = bias + 1;
+	}
+	if (exp - bias >= f->infinite_power)
+		return infinity;
+
+	sv__decimal_shift(d, 1 + f->mantissa_bits);
+	uint64_t mantissa = sv__decimal_rounded_integer(d);
+	if (mantissa == (2ULL << f->mantissa_bits))
+	{
+		mantissa >>= 1;
+		if (++exp - bias >= f->infinite_power)
+			return infinity;
+	}
+	if (!(mantissa & (1ULL << f->mantissa_bits)))
+		exp = bias;
+	return (mantissa & ((1ULL << f->mantissa_bits) - 1)) | ((uint64_t)((exp - bias) & f->infinite_power) << f->mantissa_bits);
+}
+
+typedef struct sv__float_digits
+{
+	uint64_t w;
+	int64_t q;
+	int64_t exp10; /* the explicit exponent */
+	const char *int_digits;
+	size_t int_len;
+	const char *frac_digits;
+	size_t frac_len;
+	bool negative;
+	bool truncated; /* nonzero digits after the first 19 significant ones */
+	int special;	/* 1 for inf, 2 for nan */
+} sv__float_digits;
+
+static bool sv__match_word(const char *p, size_t len, const char *word)
+{
+	/*Case-insensitive match of word (lower case) at p.*/
+	size_t n = strlen(word);
+	if (len < n)
+		return false;
+	for (size_t i = 0; i < n; i++)
+	{
+		if ((p[i] | 0x20) != word[i])
+			return false;
+	}
+	return true;
+}
+
+static int sv__scan_float(StringView sv, sv__float_digits *digits, size_t *consumed)
+{
+	/*[+-] digits [. digits] [e [+-] digits], or inf, infinity, nan. An exponent
+	marker without digits is not consumed.*/
+	const char *p = sv.data;
+	size_t at = 0;
+	memset(digits, 0, sizeof(*digits));
+	if (consumed)
+		*consumed = 0;
+	if (sv.len && (p[0] == '-' || p[0] == '+'))
+	{
+		digits->negative = p[0] == '-';
+		at = 1;
+	}
+	digits->int_digits = p + at;
+	digits->int_len = sv__digit_run(p + at, sv.len - at);
+	at += digits->int_len;
+	if (at < sv.len && p[at] == '.')
+	{
+		digits->frac_digits = p + at + 1;
+		digits->frac_len = sv__digit_run(p + at + 1, sv.len - at - 1);
+		if (digits->int_len + digits->frac_len)
+			at += 1 + digits->frac_len;
+	}
+
+	if (digits->int_len + digits->frac_len == 0)
+	{
+		size_t len = sv.len - at;
+		if (sv__match_word(p + at, len, "infinity"))
+			at += 8;
+		else if (sv__match_word(p + at, len, "inf"))
+			at += 3;
+		else if (sv__match_word(p + at, len, "nan"))
+			at += 3;
+		else
+			return EINVAL;
+		digits->special = (p[at - 1] | 0x20) == 'n' && (p[at - 2] | 0x20) == 'a' ? 2 : 1;
+		if (consumed)
+			*consumed = at;
+		return 0;
+	}
+
+	if (at < sv.len && (p[at] | 0x20) == 'e')
+	{
+		size_t e = at + 1;
+		bool negative = false;
+		if (e < sv.len && (p[e] == '-' || p[e] == '+'))
+			negative = p[e++] == '-';
+		size_t len = sv__digit_run(p + e, sv.len - e);
+		if (len)
+		{
+			// Clamped far beyond any representable exponent.
+			for (size_t i = 0; i < len; i++)
+			{
+				if (digits->exp10 < 100000000)
+					digits->exp10 = digits->exp10 * 10 + (p[e + i] - '0');
+			}
+			if (negative)
+				digits->exp10 = -digits->exp10;
+			at = e + len;
+		}
+	}
+	if (consumed)
+		*consumed = at;
+
+	if (digits->int_len + digits->frac_len <= 19)
+	{
+		size_t int_avail = sv.len - (digits->int_digits - p);
+		uint64_t w = sv__parse_digits(digits->int_digits, digits->int_len, int_avail);
+		if (digits->frac_len)
+		{
+			size_t frac_avail = sv.len - (digits->frac_digits - p);
+			w = w * sv__pow10[digits->frac_len] + sv__parse_digits(digits->frac_digits, digits->frac_len, frac_avail);
+		}
+		digits->w = w;
+		digits->q = digits->exp10 - (int64_t)digits->frac_len;
+		return 0;
+	}
+
+	uint64_t w = 0;
+	int64_t q = digits->exp10;
+	size_t significant = 0;
+	for (size_t i = 0; i < digits->int_len; i++)
+	{
+		unsigned c = digits->int_digits[i] - '0';
+		if (significant == 0 && c == 0)
+			continue;
+		if (significant < 19)
+		{
+			w = w * 10 + c;
+			significant++;
+		}
+		else
+		{
+			q++;
+			digits->truncated |= c != 0;
+		}
+	}
+	for (size_t i = 0; i < digits->frac_len; i++)
+	{
+		unsigned c = digits->frac_digits[i] - '0';
+		if (significant == 0 && c == 0)
+		{
+			q--;
+			continue;
+		}
+		if (significant < 19)
+		{
+			w = w * 10 + c;
+			significant++;
+			q--;
+		}
+		else
+		{
+			digits->truncated |= c != 0;
+		}
+	}
+	digits->w = w;
+	digits->q = q;
+	return 0;
+}
+
+static uint64_t sv__float_bits_slow(const sv__float_digits *digits, const sv__float_format *f)
+{
+	sv__decimal d = {0};
+	int64_t point = 0;
+	for (size_t i = 0; i < digits->int_len; i++)
+	{
+		unsigned char c = digits->int_digits[i] - '0';
+		if (c == 0 && d.num_digits == 0)
+			continue;
+		if (d.num_digits < SV__DECIMAL_DIGITS)
+			d.digits[d.num_digits++] = c;
+		else if (c != 0)
+			d.truncated = true;
+		point++;
+	}
+	for (size_t i = 0; i < digits->frac_len; i++)
+	{
+		unsigned char c = digits->frac_digits[i] - '0';
+		if (c == 0 && d.num_digits == 0)
+		{
+			point--;
+			continue;
+		}
+		if (d.num_digits < SV__DECIMAL_DIGITS)
+			d.digits[d.num_digits++] = c;
+		else if (c != 0)
+			d.truncated = true;
+	}
+	point += digits->exp10;
+	d.decimal_point = point > 100000 ? 100000 : point < -100000 ? -100000 : point;
+	sv__decimal_trim(&d);
+	return sv__decimal_to_bits(&d, f);
+}
+
+static int sv__float_bits(const sv__float_digits *digits, const sv__float_format *f, uint64_t *bits)
+{
+	/*Bits of the scanned number (sign included); ERANGE when a finite input
+	overflows to infinity or a nonzero one underflows to zero.*/
+	const uint64_t infinity = (uint64_t)f->infinite_power << f->mantissa_bits;
+	const uint64_t sign = (uint64_t)digits->negative << f->sign_bit;
+	if (digits->special)
+	{
+		*bits = sign | infinity | (digits->special == 2 ? 1ULL << (f->mantissa_bits - 1) : 0);
+		return 0;
+	}
+	uint64_t magnitude, upper;
+	bool exact = sv__eisel_lemire(f, digits->q, digits->w, &magnitude);
+	// With digits cut off the value lies between w and w + 1; both must round alike.
+	if (exact && digits->truncated)
+		exact = sv__eisel_lemire(f, digits->q, digits->w + 1, &upper) && upper == magnitude;
+	if (!exact)
+		magnitude = sv__float_bits_slow(digits, f);
+	*bits = sign | magnitude;
+	if (magnitude == infinity || (magnitude == 0 && digits->w != 0))
+		return ERANGE;
+	return 0;
+}
+
+SVDEF int sv_parse_double(StringView sv, double *value, size_t *consumed)
+{
+	/*Correctly rounded (to nearest, ties to even).*/
+	sv__float_digits digits;
+	*value = 0;
+	if (sv__scan_float(sv, &digits, consumed))
+		return EINVAL;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+	// Clinger: w and 10^|q| are both exact doubles, so one operation rounds correctly.
+	static const double exact[23] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+									 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+	if (!digits.special && !digits.truncated && digits.w <= (1ULL << 53) && digits.q >= -22 && digits.q <= 22)
+	{
+		double d = (double)digits.w;
+		d = digits.q < 0 ? d / exact[-digits.q] : d * exact[digits.q];
+		*value = digits.negative ? -d : d;
+		return 0;
+	}
+#endif
+	uint64_t bits;
+	int err = sv__float_bits(&digits, &sv__double_format, &bits);
+	memcpy(value, &bits, sizeof(bits));
+	return err;
+}
+
+SVDEF int sv_parse_float(StringView sv, float *value, size_t *consumed)
+{
+	sv__float_digits digits;
+	*value = 0;
+	if (sv__scan_float(sv, &digits, consumed))
+		return EINVAL;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+	static const float exact[11] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+	if (!digits.special && !digits.truncated && digits.w <= (1ULL << 24) && digits.q >= -10 && digits.q <= 10)
+	{
+		float d = (float)digits.w;
+		d = digits.q < 0 ? d / exact[-digits.q] : d * exact[digits.q];
+		*value = digits.negative ? -d : d;
+		return 0;
+	}
+#endif
+	uint64_t bits;
+	int err = sv__float_bits(&digits, &sv__float_format32, &bits);
+	uint32_t narrow = (uint32_t)bits;
+	memcpy(value, &narrow, sizeof(narrow));
+	return err;
+}
+
+SVDEF StringView sv_format_u64(char *buffer, uint64_t value)
+{
+	StringView sv = {.data = buffer, .len = sv__format_u64(buffer, value)};
+	return sv;
+}
+
+SVDEF StringView sv_format_i64(char *buffer, int64_t value)
+{
+	uint64_t magnitude = value;
+	size_t sign = value < 0;
+	if (sign)
+	{
+		buffer[0] = '-';
+		magnitude = 0 - magnitude;
+	}
+	StringView sv = {.data = buffer, .len = sign + sv__format_u64(buffer + sign, magnitude)};
+	return sv;
+}
+
+#define SV__RYU_POW5_INV_BITCOUNT 125
+#define SV__RYU_POW5_BITCOUNT 125
+
+/* floor(2^(bitlength(5^i) - 1 + 125) / 5^i) + 1 for i in [0, 342), low word first. */
+static const uint64_t sv__ryu_pow5_inv[684] = {
+	0x0000000000000001ULL, 0x2000000000000000ULL, 0x999999999999999aULL, 0x1999999999999999ULL,
+	0x47ae147ae147ae15ULL, 0x147ae147ae147ae1ULL, 0x6c8b4395810624deULL, 0x10624dd2f1a9fbe7ULL,
+	0x7a786c226809d496ULL, 0x1a36e2eb1c432ca5ULL, 0x61f9f01b866e43abULL, 0x14f8b588e368f084ULL,
+	0xb4c7f34938583622ULL, 0x10c6f7a0b5ed8d36ULL, 0x87a6520ec08d236aULL, 0x1ad7f29abcaf4857ULL,
+	0x9fb841a566d74f88ULL, 0x15798ee2308c39dfULL, 0xe62d01511f12a607ULL, 0x112e0be826d694b2ULL,
+	0xd6ae6881cb5109a4ULL, 0x1b7cdfd9d7bdbab7ULL, 0xdef1ed34a2a73aeaULL, 0x15fd7fe17964955fULL,
+	0x7f27f0f6e885c8bbULL, 0x119799812dea1119ULL, 0x650cb4be40d60df8ULL, 0x1c25c268497681c2ULL,
+	0xea70909833de7193ULL, 0x16849b86a12b9b01ULL, 0x21f3a6e0297ec143ULL, 0x1203af9ee756159bULL,
+	0x6985d7cd0f313537ULL, 0x1cd2b297d889bc2bULL, 0x2137dfd73f5a90f9ULL, 0x170ef54646d49689ULL,
+	0xe75fe645cc4873faULL, 0x12725dd1d243aba0ULL, 0xa5663d3c7a0d865dULL, 0x1d83c94fb6d2ac34ULL,
+	0x511e976394d79eb1ULL, 0x179ca10c9242235dULL, 0xda7edf82dd794bc1ULL, 0x12e3b40a0e9b4f7dULL,
+	0x2a6498d1625bac68ULL, 0x1e392010175ee596ULL, 0xeeb6e0a781e2f053ULL, 0x182db34012b25144ULL,
+	0x58924d52ce4f26a9ULL, 0x1357c299a88ea76aULL, 0x27507bb7b07ea441ULL, 0x1ef2d0f5da7dd8aaULL,
+	0x52a6c95fc0655034ULL, 0x18c240c4aecb13bbULL, 0x0eebd44c99eaa690ULL, 0x13ce9a36f23c0fc9ULL,
+	0xb17953adc3110a80ULL, 0x1fb0f6be50601941ULL, 0xc12ddc8b02740867ULL, 0x195a5efea6b34767ULL,
+	0x3424b06f3529a052ULL, 0x14484bfeebc29f86ULL, 0x901d59f290ee19dbULL, 0x1039d66589687f9eULL,
+	0x4cfbc31db4b0295fULL, 0x19f623d5a8a73297ULL, 0x3d9635b15d59bab2ULL, 0x14c4e977ba1f5bacULL,
+	0x97ab5e277de16228ULL, 0x109d8792fb4c4956ULL, 0xf2abc9d8c9689d0dULL, 0x1a95a5b7f87a0ef0ULL,
+	0x5bbca17a3aba173eULL, 0x154484932d2e725aULL, 0xafca1ac82efb45cbULL, 0x11039d428a8b8eaeULL,
+	0xb2dcf7a6b1920945ULL, 0x1b38fb9daa78e44aULL, 0xf57d92ebc141a104ULL, 0x15c72fb1552d836eULL,
+	0xc46475896767b403ULL, 0x116c262777579c58ULL, 0x6d6d88dbd8a5ecd2ULL, 0x1be03d0bf225c6f4ULL,
+	0x8abe071646eb23dbULL, 0x164cfda3281e38c3ULL, 0x6efe6c11d255b649ULL, 0x11d7314f534b609cULL,
+	0xb197134fb6ef8a0eULL, 0x1c8b821885456760ULL, 0x27ac0f72f8bfa1a5ULL, 0x16d601ad376ab91aULL,
+	0xb95672c260994e1eULL, 0x1244ce242c5560e1ULL, 0xf5571e03cdc21695ULL, 0x1d3ae36d13bbce35ULL,
+	0x2aac18030b01ababULL, 0x17624f8a762fd82bULL, 0xbbbce0026f348956ULL, 0x12b50c6ec4f31355ULL,
+	0x92c7ccd0b1eda889ULL, 0x1dee7a4ad4b81eefULL, 0xdbd30a408e57ba07ULL, 0x17f1fb6f10934bf2ULL,
+	0x7ca8d50071dfc806ULL, 0x1327fc58da0f6ff5ULL, 0xfaa7bb33e9660cd6ULL, 0x1ea6608e29b24cbbULL,
+	0x9552fc298784d711ULL, 0x18851a0b548ea3c9ULL, 0xaaa8c9bad2d0ac0eULL, 0x139dae6f76d88307ULL,
+	0xdddadc5e1e1aace3ULL, 0x1f62b0b257c0d1a5ULL, 0x7e48b04b4b488a4fULL, 0x191bc08eac9a4151ULL,
+	0xcb6d59d5d5d3a1d9ULL, 0x141633a556e1cddaULL, 0x3c577b1177dc817bULL, 0x1011c2eaabe7d7e2ULL,
+	0xc6f25e825960cf2aULL, 0x19b604aaaca62636ULL, 0x6bf518684780a5bbULL, 0x14919d5556eb51c5ULL,
+	0x232a79ed06008496ULL, 0x10747ddddf22a7d1ULL, 0xd1dd8fe1a3340756ULL, 0x1a53fc9631d10c81ULL,
+	0xa7e4731ae8f66c45ULL, 0x150ffd44f4a73d34ULL, 0x531d28e253f8569eULL, 0x10d9976a5d52975dULL,
+	0xeb61db03b98d5762ULL, 0x1af5bf109550f22eULL, 0xbc4e48cfc7a445e8ULL, 0x159165a6ddda5b58ULL,
+	0x6371d3d96c836b20ULL, 0x11411e1f17e1e2adULL, 0x9f1c8628ad9f11cdULL, 0x1b9b6364f3030448ULL,
+	0xe5b06b53be18db0bULL, 0x1615e91d8f359d06ULL, 0xeaf3890fcb4715a2ULL, 0x11ab20e472914a6bULL,
+	0x44b8db4c7871bc37ULL, 0x1c45016d841baa46ULL, 0x03c715d6c6c1635fULL, 0x169d9abe03495505ULL,
+	0x3638de456bcde919ULL, 0x1217aefe69077737ULL, 0x56c163a2461641c1ULL, 0x1cf2b1970e725858ULL,
+	0xdf011c81d1ab67ceULL, 0x17288e1271f51379ULL, 0x7f3416ce4155eca5ULL, 0x1286d80ec190dc61ULL,
+	0x6520247d3556476eULL, 0x1da48ce468e7c702ULL, 0xea801d30f7783925ULL, 0x17b6d71d20b96c01ULL,
+	0xbb99b0f3f92cfa84ULL, 0x12f8ac174d612334ULL, 0x5f5c4e532847f739ULL, 0x1e5aacf215683854ULL,
+	0x7f7d0b75b9d32c2eULL, 0x18488a5b44536043ULL, 0x9930d5f7c7dc2358ULL, 0x136d3b7c36a919cfULL,
+	0x8eb4898c72f9d226ULL, 0x1f152bf9f10e8fb2ULL, 0x722a07a38f2e41b8ULL, 0x18ddbcc7f40ba628ULL,
+	0xc1bb394fa5be9afaULL, 0x13e497065cd61e86ULL, 0x9c5ec2190930f7f6ULL, 0x1fd424d6faf030d7ULL,
+	0x49e56814075a5ff8ULL, 0x197683df2f268d79ULL, 0x6e51201005e1e660ULL, 0x145ecfe5bf520ac7ULL,
+	0xf1da800cd181851aULL, 0x104bd984990e6f05ULL, 0x4fc400148268d4f5ULL, 0x1a12f5a0f4e3e4d6ULL,
+	0xd96999aa01ed772bULL, 0x14dbf7b3f71cb711ULL, 0xadee1488018ac5bcULL, 0x10aff95cc5b09274ULL,
+	0x497ceda668de092cULL, 0x1ab328946f80ea54ULL, 0x3aca57b853e4d424ULL, 0x155c2076bf9a5510ULL,
+	0x623b7960431d7683ULL, 0x1116805effaeaa73ULL, 0x9d2bf566d1c8bd9eULL, 0x1b5733cb32b110b8ULL,
+	0x7dbcc452416d647fULL, 0x15df5ca28ef40d60ULL, 0xcafd69db678ab6ccULL, 0x117f7d4ed8c33de6ULL,
+	0xab2f0fc572778adfULL, 0x1bff2ee48e052fd7ULL, 0x88f273045b92d580ULL, 0x1665bf1d3e6a8cacULL,
+	0xd3f528d049424466ULL, 0x11eaff4a98553d56ULL, 0xb988414d4203a0a3ULL, 0x1cab3210f3bb9557ULL,
+	0x6139cdd76802e6e9ULL, 0x16ef5b40c2fc7779ULL, 0xe761717920025254ULL, 0x125915cd68c9f92dULL,
+	0xa568b58e999d5086ULL, 0x1d5b561574765b7cULL, 0x5120913ee14aa6d2ULL, 0x177c44ddf6c515fdULL,
+	0xa74d40ff1aa21f0eULL, 0x12c9d0b1923744caULL, 0x0baece64f769cb4aULL, 0x1e0fb44f50586e11ULL,
+	0x3c8bd850c5ee3c3bULL, 0x180c903f7379f1a7ULL, 0xca0979da37f1c9c9ULL, 0x133d4032c2c7f485ULL,
+	0xa9a8c2f6bfe942dbULL, 0x1ec866b79e0cba6fULL, 0x2153cf2bccba9be3ULL, 0x18a0522c7e709526ULL,
+	0x1aa9728970954982ULL, 0x13b374f06526ddb8ULL, 0xf775840f1a88759dULL, 0x1f8587e7083e2f8cULL,
+	0x5f9136727ba05e17ULL, 0x19379fec0698260aULL, 0x1940f85b9619e4dfULL, 0x142c7ff0054684d5ULL,
+	0xe100c6afab47ea4cULL, 0x1023998cd1053710ULL, 0xce67a44c453fdd47ULL, 0x19d28f47b4d524e7ULL,
+	0xd852e9d69dccb106ULL, 0x14a8729fc3ddb71fULL, 0x79dbee454b0a2738ULL, 0x1086c219697e2c19ULL,
+	0x295fe3a211a9d859ULL, 0x1a71368f0f30468fULL, 0xbab31c81a7bb137aULL, 0x15275ed8d8f36ba5ULL,
+	0x6228e39aec95a92fULL, 0x10ec4be0ad8f8951ULL, 0x9d0e38f7e0ef7517ULL, 0x1b13ac9aaf4c0ee8ULL,
+	0xb0d82d931a592a79ULL, 0x15a956e225d67253ULL, 0x8d79be0f4847552eULL, 0x11544581b7dec1dcULL,
+	0x158f967eda0bbb7cULL, 0x1bba08cf8c979c94ULL, 0x77a611ff14d62f97ULL, 0x162e6d72d6dfb076ULL,
+	0xf951a7ff43de8c79ULL, 0x11bebdf578b2f391ULL, 0xc21c3ffed2fdad8eULL, 0x1c6463225ab7ec1cULL,
+	0x01b0333242648ad8ULL, 0x16b6b5b5155ff017ULL, 0x0159c28e9b83a246ULL, 0x122bc490dde659acULL,
+	0xcef604175f3903a3ULL, 0x1d12d41afca3c2acULL, 0x725e69ac4c2d9c83ULL, 0x17424348ca1c9bbdULL,
+	0xf5185489d68ae39cULL, 0x129b69070816e2fdULL, 0xee8d540fbdab05c6ULL, 0x1dc574d80cf16b2fULL,
+	0xbed77672fe226b05ULL, 0x17d12a4670c1228cULL, 0xff12c528cb4ebc04ULL, 0x130dbb6b8d674ed6ULL,
+	0xcb513b74787df9a0ULL, 0x1e7c5f127bd87e24ULL, 0x090dc929f9fe614dULL, 0x18637f41fcad31b7ULL,
+	0xa0d7d42194cb810aULL, 0x1382cc34ca2427c5ULL, 0x67bfb9cf5478ce77ULL, 0x1f37ad21436d0c6fULL,
+	0x1fcc94a5dd2d71f9ULL, 0x18f9574dcf8a7059ULL, 0x7fd6dd517dbdf4c7ULL, 0x13faac3e3fa1f37aULL,
+	0xffbe2ee8c92fee0bULL, 0x1ff779fd329cb8c3ULL, 0x6631bf20a0f324d6ULL, 0x1992c7fdc216fa36ULL,
+	0xb827cc1a1a5c1d78ULL, 0x14756ccb01abfb5eULL, 0x935309ae7b7ce460ULL, 0x105df0a267bcc918ULL,
+	0x1eeb42b0c594a099ULL, 0x1a2fe76a3f9474f4ULL, 0xe58902270476e6e1ULL, 0x14f31f8832dd2a5cULL,
+	0xb7a0ce859d2bebe7ULL, 0x10c27fa028b0eeb0ULL, 0x59014a6f61dfdfd8ULL, 0x1ad0cc33744e4ab4ULL,
+	0xe0cdd525e7e64cadULL, 0x1573d68f903ea229ULL, 0x4d7177518651d6f1ULL, 0x11297872d9cbb4eeULL,
+	0x7be8bee8d6e957e8ULL, 0x1b758d848fac54b0ULL, 0xfcba3253df211320ULL, 0x15f7a46a0c89dd59ULL,
+	0x63c8284318e74280ULL, 0x1192e9ee706e4aaeULL, 0x060d0d3827d86a66ULL, 0x1c1e43171a4a1117ULL,
+	0x6b3da42cecad21ebULL, 0x167e9c127b6e7412ULL, 0x88fe1cf0bd574e56ULL, 0x11fee341fc585cdbULL,
+	0x419694b462254a23ULL, 0x1ccb0536608d615fULL, 0x67abaa29e81dd4e9ULL, 0x1708d0f84d3de77fULL,
+	0xb95621bb2017dd87ULL, 0x126d73f9d764b932ULL, 0xc223692b668c95a5ULL, 0x1d7becc2f23ac1eaULL,
+	0xce82ba891ed6de1dULL, 0x179657025b6234bbULL, 0xa53562074bdf1818ULL, 0x12deac01e2b4f6fcULL,
+	0x3b889cd87964f359ULL, 0x1e3113363787f194ULL, 0xfc6d4a46c783f5e1ULL, 0x18274291c6065adcULL,
+	0x30576e9f06032b1aULL, 0x13529ba7d19eaf17ULL, 0x1a257dcb3cd1de90ULL, 0x1eea92a61c311825ULL,
+	0x481dfe3c30a7e540ULL, 0x18bba884e35a79b7ULL, 0xd34b31c9c0865100ULL, 0x13c9539d82aec7c5ULL,
+	0x5211e942cda3b4cdULL, 0x1fa885c8d117a609ULL, 0x74db21023e1c90a4ULL, 0x19539e3a40dfb807ULL,
+	0xf715b401cb4a0d50ULL, 0x1442e4fb67196005ULL, 0xf8de299b09080aa7ULL, 0x103583fc527ab337ULL,
+	0x8e304291a80cddd7ULL, 0x19ef3993b72ab859ULL, 0x3e8d020e200a4b13ULL, 0x14bf6142f8eef9e1ULL,
+	0x653d9b3e80083c0fULL, 0x10991a9bfa58c7e7ULL, 0x6ec8f864000d2ce4ULL, 0x1a8e90f9908e0ca5ULL,
+	0x8bd3f9e999a423eaULL, 0x153eda614071a3b7ULL, 0x3ca994bae1501cbbULL, 0x10ff151a99f482f9ULL,
+	0xc775bac49bb3612bULL, 0x1b31bb5dc320d18eULL, 0xd2c4956a16291a89ULL, 0x15c162b168e70e0bULL,
+	0xdbd0778811ba7ba1ULL, 0x11678227871f3e6fULL, 0x2c80bf401c5d929bULL, 0x1bd8d03f3e9863e6ULL,
+	0xbd33cc3349e47549ULL, 0x16470cff6546b651ULL, 0xca8fd68f6e505dd4ULL, 0x11d270cc51055ea7ULL,
+	0x4419574be3b3c953ULL, 0x1c83e7ad4e6efdd9ULL, 0x0347790982f63aa9ULL, 0x16cfec8aa52597e1ULL,
+	0xcf6c60d468c4fbbaULL, 0x123ff06eea847980ULL, 0xe57a34870e07f92aULL, 0x1d331a4b10d3f59aULL,
+	0x512e906c0b399422ULL, 0x175c1508da432ae2ULL, 0xda8ba6bcd5c7a9b5ULL, 0x12b010d3e1cf5581ULL,
+	0x90df712e22d90f87ULL, 0x1de6815302e5559cULL, 0xda4c5a8b4f140c6cULL, 0x17eb9aa8cf1dde16ULL,
+	0xaea37ba2a5a9a38aULL, 0x1322e220a5b17e78ULL, 0x7dd25f6aa2a905a9ULL, 0x1e9e369aa2b59727ULL,
+	0x97db7f888220d154ULL, 0x187e92154ef7ac1fULL, 0x797c6606ce80a777ULL, 0x139874ddd8c6234cULL,
+	0x8f2d700ae4010bf1ULL, 0x1f5a549627a36badULL, 0x0c2459a25000d65aULL, 0x191510781fb5efbeULL,
+	0x701d1481d99a4515ULL, 0x1410d9f9b2f7f2feULL, 0xc017439b147b6a77ULL, 0x100d7b2e28c65bfeULL,
+	0xccf205c4ed9243f2ULL, 0x19af2b7d0e0a2ccaULL, 0x0a5b37d0be0e9cc2ULL, 0x148c22ca71a1bd6fULL,
+	0x0848f973cb3ee3ceULL, 0x10701bd527b4978cULL, 0xda0e5bec78649fb0ULL, 0x1a4cf9550c5425acULL,
+	0x7b3eaff060507fc0ULL, 0x150a6110d6a9b7bdULL, 0x95cbbff380406633ULL, 0x10d51a73deee2c97ULL,
+	0xefac665266cd7052ULL, 0x1aee90b964b04758ULL, 0x2623850eb8a459dbULL, 0x158ba6fab6f36c47ULL,
+	0x1e82d0d893b6ae49ULL, 0x113c85955f29236cULL, 0xfd9e1af41f8ab075ULL, 0x1b9408eefea838acULL,
+	0x97b1af29b2d559f7ULL, 0x16100725988693bdULL, 0xac8e25baf5777b2cULL, 0x11a66c1e139edc97ULL,
+	0x7a7d092b2258c513ULL, 0x1c3d79c9b8fe2dbfULL, 0x61fda0ef4ead6a76ULL, 0x169794a160cb57ccULL,
+	0xe7fe1a590bbdeec5ULL, 0x1212dd4de7091309ULL, 0xa6635d5b45fcb13aULL, 0x1ceafbafd80e84dcULL,
+	0x851c4aaf6b308dc8ULL, 0x172262f3133ed0b0ULL, 0xd0e36ef2bc26d7d4ULL, 0x1281e8c275cbda26ULL,
+	0xb49f17eac6a48c86ULL, 0x1d9ca79d894629d7ULL, 0x2a18dfef0550706bULL, 0x17b08617a104ee46ULL,
+	0x54e0b3259dd9f389ULL, 0x12f39e794d9d8b6bULL, 0x87cdeb6f62f65274ULL, 0x1e5297287c2f4578ULL,
+	0xd30b22bf825ea85dULL, 0x18421286c9bf6ac6ULL, 0x0f3c1bcc684bb9e4ULL, 0x13680ed23aff889fULL,
+	0x18602c7a4079296dULL, 0x1f0ce4839198da98ULL, 0x46b356c833942124ULL, 0x18d71d360e13e213ULL,
+	0x388f78a029434db6ULL, 0x13df4a91a4dcb4dcULL, 0x5a7f2766a86baf8aULL, 0x1fcbaa82a1612160ULL,
+	0x153285ebb9efbfa2ULL, 0x196fbb9bb44db44dULL, 0xaa8ed189618c994eULL, 0x145962e2f6a4903dULL,
+	0xeed8a7a11ad6e10cULL, 0x1047824f2bb6d9caULL, 0x7e27729b5e249b45ULL, 0x1a0c03b1df8af611ULL,
+	0xfe85f549181d4904ULL, 0x14d6695b193bf80dULL, 0xcb9e5dd4134aa0d0ULL, 0x10ab877c142ff9a4ULL,
+	0xdf63c9535211014dULL, 0x1aac0bf9b9e65c3aULL, 0x191ca10f74da6771ULL, 0x15566ffafb1eb02fULL,
+	0xadb080d92a4852c1ULL, 0x1111f32f2f4bc025ULL, 0x15e7348eaa0d5134ULL, 0x1b4feb7eb212cd09ULL,
+	0xab1f5d3eee710dc4ULL, 0x15d98932280f0a6dULL, 0xbc1917658b8da49dULL, 0x117ad428200c0857ULL,
+	0x2cf4f23c127c3a94ULL, 0x1bf7b9d9cce00d59ULL, 0xf0c3f4fcdb969543ULL, 0x165fc7e170b33de0ULL,
+	0x5a365d9716121103ULL, 0x11e6398126f5cb1aULL, 0x9056fc24f01ce804ULL, 0x1ca38f350b22de90ULL,
+	0xd9df301d8ce3ecd0ULL, 0x16e93f5da2824ba6ULL, 0xe17f59b13d8323daULL, 0x125432b14ecea2ebULL,
+	0x68cbc2b52f38395cULL, 0x1d53844ee47dd179ULL, 0x53d6355dbf602de3ULL, 0x177603725064a794ULL,
+	0xa9782ab165e68b1cULL, 0x12c4cf8ea6b6ec76ULL, 0x0f26aab56fd744faULL, 0x1e07b27dd78b13f1ULL,
+	0x3f52222abfdf6a62ULL, 0x18062864ac6f4327ULL, 0x65db4e88997f884eULL, 0x1338205089f29c1fULL,
+	0x6fc54a7428cc0d4aULL, 0x1ec033b40fea9365ULL, 0x596aa1f68709a43bULL, 0x1899c2f673220f84ULL,
+	0xadeee7f86c07b696ULL, 0x13ae3591f5b4d936ULL, 0x497e3ff3e00c5756ULL, 0x1f7d228322baf524ULL,
+	0xd464fff64cd6ac45ULL, 0x1930e868e89590e9ULL, 0x4383fff83d7889d1ULL, 0x14272053ed4473eeULL,
+	0xcf9cccc69793a174ULL, 0x101f4d0ff1038ff1ULL, 0x7f6147a425b90252ULL, 0x19cbae7fe805b31cULL,
+	0xcc4dd2e9b7c7350fULL, 0x14a2f1ffecd15c16ULL, 0x3d0b0f215fd290d9ULL, 0x10825b3323dab012ULL,
+	0x61ab4b689950e7c1ULL, 0x1a6a2b85062ab350ULL, 0x4e22a2ba1440b967ULL, 0x1521bc6a6b555c40ULL,
+	0x0b4ee894dd009453ULL, 0x10e7c9eebc4449cdULL, 0x1217da87c800ed51ULL, 0x1b0c764ac6d3a948ULL,
+	0xdb46486ca000bddaULL, 0x15a391d56bdc876cULL, 0x490506bd4ccd64afULL, 0x114fa7ddefe39f8aULL,
+	0xa8080ac87ae23ab1ULL, 0x1bb2a62fe638ff43ULL, 0x5339a239fbe82ef4ULL, 0x162884f31e93ff69ULL,
+	0x75c7b4fb2fecf25dULL, 0x11ba03f5b20fff87ULL, 0x22d92191e647ea2eULL, 0x1c5cd322b67fff3fULL,
+	0xb57a8141850654f2ULL, 0x16b0a8e891ffff65ULL, 0xc4620101373843f5ULL, 0x1226ed86db3332b7ULL,
+	0x3a366801f1f39feeULL, 0x1d0b15a491eb8459ULL, 0xfb5eb99b27f6198bULL, 0x173c115074bc69e0ULL,
+	0x2f7efae2865e7ad6ULL, 0x129674405d6387e7ULL, 0xe597f7d0d6fd9156ULL, 0x1dbd86cd6238d971ULL,
+	0x8479930d78cadaabULL, 0x17cad23de82d7ac1ULL, 0xd06142712d6f1556ULL, 0x1308a831868ac89aULL,
+	0x4d686a4eaf182222ULL, 0x1e74404f3daada91ULL, 0xa453883ef279b4e8ULL, 0x185d003f6488aedaULL,
+	0xe9dc6cff28615d87ULL, 0x137d99cc506d58aeULL, 0xa960ae650d6895a4ULL, 0x1f2f5c7a1a488de4ULL,
+	0xbab3beb73ded4483ULL, 0x18f2b061aea07183ULL, 0x2ef6322c318a9d36ULL, 0x13f559e7bee6c136ULL,
+	0xe4bd1d13827761f0ULL, 0x1feef63f97d79b89ULL, 0x83ca7da9352c4e5aULL, 0x198bf832dfdfafa1ULL,
+	0x9ca1fe20f756a515ULL, 0x146ff9c24cb2f2e7ULL, 0x4a1b31b3f9121daaULL, 0x1059949b708f28b9ULL,
+	0x435eb5ecc1b695ddULL, 0x1a28edc580e50df5ULL, 0x35e55e57015ede4aULL, 0x14ed8b04671da4c4ULL,
+	0xc4b77eac0118b1d5ULL, 0x10be08d0527e1d69ULL, 0xa12597799b5ab622ULL, 0x1ac9a7b3b7302f0fULL,
+	0x4db7ac6149155e81ULL, 0x156e1fc2f8f358d9ULL, 0xd7c6238107444b9bULL, 0x1124e63593f5e0adULL,
+	0x593d059b3ed3ac2bULL, 0x1b6e3d2286563449ULL, 0xe0fd9e15cbdc89bcULL, 0x15f1ca820511c36dULL,
+	0xb3fe18116fe3a163ULL, 0x118e3b9b37416924ULL, 0x866359b57fd29bd1ULL, 0x1c16c5c525357507ULL,
+	0xd1e91491330ee30eULL, 0x16789e3750f790d2ULL, 0x74ba76da8f3f1c0bULL, 0x11fa182c40c60d75ULL,
+	0xedf72490e531c678ULL, 0x1cc359e067a348bbULL, 0x8b2c1d40b75b052dULL, 0x1702ae4d1fb5d3c9ULL,
+	0x6f567dcd5f7c0424ULL, 0x12688b70e62b0fd4ULL, 0x7ef0c94898c66d06ULL, 0x1d74124e3d11b2edULL,
+	0x98c0a106e09ebd9fULL, 0x17900ea4fda7c257ULL, 0x470080d24d4bcae6ULL, 0x12d9a550caec9b79ULL,
+	0xd800ce1d487944a2ULL, 0x1e29088144adc58eULL, 0x1333d8176d2dd082ULL, 0x1820d39a9d57d13fULL,
+	0xa8f646792424a6ceULL, 0x134d76154aaca765ULL, 0x74bd3d8ea03aa47dULL, 0x1ee25688777aa56fULL,
+	0x5d64313ee6955064ULL, 0x18b51206c5fbb78cULL, 0x4ab68dcbebaaa6b7ULL, 0x13c40e6bd1962c70ULL,
+	0x1124161312aaa457ULL, 0x1fa01712e8f0471aULL, 0xda8344dc0eeee9dfULL, 0x194cdf4253f36c14ULL,
+	0xe2029d7cd8bf2180ULL, 0x143d7f6843292343ULL, 0x4e687dfd7a328133ULL, 0x103132b9cf541c36ULL,
+	0x4a40c9959050ceb8ULL, 0x19e851294bb9c6bdULL, 0x0833d477a6a70bc6ULL, 0x14b9da876fc7d231ULL,
+	0xa02976c61eec096bULL, 0x1094aed2bfd30e8dULL, 0x004257a364acdbdfULL, 0x1a877e1dffb81749ULL,
+	0xcd01dfb5ea23e319ULL, 0x153931b1996012a0ULL, 0x70ce4c91881cb5aeULL, 0x10fa8e27ade6754dULL,
+	0x1ae3adb5a69455e2ULL, 0x1b2a7d0c4970bbafULL, 0x7be957c4854377e8ULL, 0x15bb973d078d62f2ULL,
+	0xc987796a0435f987ULL, 0x1162df64060ab58eULL, 0x75a58f1006bcc271ULL, 0x1bd1656cd67788e4ULL,
+	0xf7b7a5a66bca3527ULL, 0x16411df0ab92d3e9ULL, 0x5fc61e1ebca1c41fULL, 0x11cdb18d560f0feeULL,
+	0xffa363646102d365ULL, 0x1c7c4f4889b1b316ULL, 0x32e91c504d9bdc51ULL, 0x16c9d906d48e28dfULL,
+	0x8f20e37371497d0eULL, 0x123b140576d820b2ULL, 0x7e9b0585820f2e7cULL, 0x1d2b533bf159cdeaULL,
+	0xcbaf379e01a5becaULL, 0x1755dc2ff447d7eeULL, 0x0958f94b348498a1ULL, 0x12ab168cc36cacbfULL,
+};
+
+/* 5^i scaled to exactly 125 bits (truncated) for i in [0, 326), low word first. */
+static const uint64_t sv__ryu_pow5[652] = {
+	0x0000000000000000ULL, 0x1000000000000000ULL, 0x0000000000000000ULL, 0x1400000000000000ULL,
+	0x0000000000000000ULL, 0x1900000000000000ULL, 0x0000000000000000ULL, 0x1f40000000000000ULL,
+	0x0000000000000000ULL, 0x1388000000000000ULL, 0x0000000000000000ULL, 0x186a000000000000ULL,
+	0x0000000000000000ULL, 0x1e84800000000000ULL, 0x0000000000000000ULL, 0x1312d00000000000ULL,
+	0x0000000000000000ULL, 0x17d7840000000000ULL, 0x0000000000000000ULL, 0x1dcd650000000000ULL,
+	0x0000000000000000ULL, 0x12a05f2000000000ULL, 0x0000000000000000ULL, 0x174876e800000000ULL,
+	0x0000000000000000ULL, 0x1d1a94a200000000ULL, 0x0000000000000000ULL, 0x12309ce540000000ULL,
+	0x0000000000000000ULL, 0x16bcc41e90000000ULL, 0x0000000000000000ULL, 0x1c6bf52634000000ULL,
+	0x0000000000000000ULL, 0x11c37937e0800000ULL, 0x0000000000000000ULL, 0x16345785d8a00000ULL,
+	0x0000000000000000ULL, 0x1bc16d674ec80000ULL, 0x0000000000000000ULL, 0x1158e460913d0000ULL,
+	0x0000000000000000ULL, 0x15af1d78b58c4000ULL, 0x0000000000000000ULL, 0x1b1ae4d6e2ef5000ULL,
+	0x0000000000000000ULL, 0x10f0cf064dd59200ULL, 0x0000000000000000ULL, 0x152d02c7e14af680ULL,
+	0x0000000000000000ULL, 0x1a784379d99db420ULL, 0x0000000000000000ULL, 0x108b2a2c28029094ULL,
+	0x0000000000000000ULL, 0x14adf4b7320334b9ULL, 0x4000000000000000ULL, 0x19d971e4fe8401e7ULL,
+	0x8800000000000000ULL, 0x1027e72f1f128130ULL, 0xaa00000000000000ULL, 0x1431e0fae6d7217cULL,
+	0xd480000000000000ULL, 0x193e5939a08ce9dbULL, 0xc9a0000000000000ULL, 0x1f8def8808b02452ULL,
+	0xbe04000000000000ULL, 0x13b8b5b5056e16b3ULL, 0xad85000000000000ULL, 0x18a6e32246c99c60ULL,
+	0xd8e6400000000000ULL, 0x1ed09bead87c0378ULL, 0x878fe80000000000ULL, 0x13426172c74d822bULL,
+	0x6973e20000000000ULL, 0x1812f9cf7920e2b6ULL, 0x03d0da8000000000ULL, 0x1e17b84357691b64ULL,
+	0x8262889000000000ULL, 0x12ced32a16a1b11eULL, 0x22fb2ab400000000ULL, 0x178287f49c4a1d66ULL,
+	0xabb9f56100000000ULL, 0x1d6329f1c35ca4bfULL, 0xcb54395ca0000000ULL, 0x125dfa371a19e6f7ULL,
+	0xbe2947b3c8000000ULL, 0x16f578c4e0a060b5ULL, 0x2db399a0ba000000ULL, 0x1cb2d6f618c878e3ULL,
+	0xfc90400474400000ULL, 0x11efc659cf7d4b8dULL, 0x7bb4500591500000ULL, 0x166bb7f0435c9e71ULL,
+	0xdaa16406f5a40000ULL, 0x1c06a5ec5433c60dULL, 0xa8a4de8459868000ULL, 0x118427b3b4a05bc8ULL,
+	0xd2ce16256fe82000ULL, 0x15e531a0a1c872baULL, 0x87819baecbe22800ULL, 0x1b5e7e08ca3a8f69ULL,
+	0xf4b1014d3f6d5900ULL, 0x111b0ec57e6499a1ULL, 0x71dd41a08f48af40ULL, 0x1561d276ddfdc00aULL,
+	0x0e549208b31adb10ULL, 0x1aba4714957d300dULL, 0x28f4db456ff0c8eaULL, 0x10b46c6cdd6e3e08ULL,
+	0x33321216cbecfb24ULL, 0x14e1878814c9cd8aULL, 0xbffe969c7ee839edULL, 0x1a19e96a19fc40ecULL,
+	0xf7ff1e21cf512434ULL, 0x105031e2503da893ULL, 0xf5fee5aa43256d41ULL, 0x14643e5ae44d12b8ULL,
+	0x337e9f14d3eec892ULL, 0x197d4df19d605767ULL, 0x005e46da08ea7ab6ULL, 0x1fdca16e04b86d41ULL,
+	0xa03aec4845928cb2ULL, 0x13e9e4e4c2f34448ULL, 0xc849a75a56f72fdeULL, 0x18e45e1df3b0155aULL,
+	0x7a5c1130ecb4fbd6ULL, 0x1f1d75a5709c1ab1ULL, 0xec798abe93f11d65ULL, 0x13726987666190aeULL,
+	0xa797ed6e38ed64bfULL, 0x184f03e93ff9f4daULL, 0x517de8c9c728bdefULL, 0x1e62c4e38ff87211ULL,
+	0xd2eeb17e1c7976b5ULL, 0x12fdbb0e39fb474aULL, 0x87aa5ddda397d462ULL, 0x17bd29d1c87a191dULL,
+	0xe994f5550c7dc97bULL, 0x1dac74463a989f64ULL, 0x11fd195527ce9dedULL, 0x128bc8abe49f639fULL,
+	0xd67c5faa71c24568ULL, 0x172ebad6ddc73c86ULL, 0x8c1b77950e32d6c2ULL, 0x1cfa698c95390ba8ULL,
+	0x57912abd28dfc639ULL, 0x121c81f7dd43a749ULL, 0xad75756c7317b7c8ULL, 0x16a3a275d494911bULL,
+	0x98d2d2c78fdda5baULL, 0x1c4c8b1349b9b562ULL, 0x9f83c3bcb9ea8794ULL, 0x11afd6ec0e14115dULL,
+	0x0764b4abe8652979ULL, 0x161bcca7119915b5ULL, 0x493de1d6e27e73d7ULL, 0x1ba2bfd0d5ff5b22ULL,
+	0x6dc6ad264d8f0866ULL, 0x1145b7e285bf98f5ULL, 0xc938586fe0f2ca80ULL, 0x159725db272f7f32ULL,
+	0x7b866e8bd92f7d20ULL, 0x1afcef51f0fb5effULL, 0xad34051767bdae34ULL, 0x10de1593369d1b5fULL,
+	0x9881065d41ad19c1ULL, 0x15159af804446237ULL, 0x7ea147f492186032ULL, 0x1a5b01b605557ac5ULL,
+	0x6f24ccf8db4f3c1fULL, 0x1078e111c3556cbbULL, 0x4aee003712230b27ULL, 0x14971956342ac7eaULL,
+	0xdda98044d6abcdf0ULL, 0x19bcdfabc13579e4ULL, 0x0a89f02b062b60b6ULL, 0x10160bcb58c16c2fULL,
+	0xcd2c6c35c7b638e4ULL, 0x141b8ebe2ef1c73aULL, 0x8077874339a3c71dULL, 0x1922726dbaae3909ULL,
+	0xe0956914080cb8e4ULL, 0x1f6b0f092959c74bULL, 0x6c5d61ac8507f38eULL, 0x13a2e965b9d81c8fULL,
+	0x4774ba17a649f072ULL, 0x188ba3bf284e23b3ULL, 0x1951e89d8fdc6c8fULL, 0x1eae8caef261aca0ULL,
+	0x0fd3316279e9c3d9ULL, 0x132d17ed577d0be4ULL, 0x13c7fdbb186434cfULL, 0x17f85de8ad5c4eddULL,
+	0x58b9fd29de7d4203ULL, 0x1df67562d8b36294ULL, 0xb7743e3a2b0e4942ULL, 0x12ba095dc7701d9cULL,
+	0xe5514dc8b5d1db92ULL, 0x17688bb5394c2503ULL, 0xdea5a13ae3465277ULL, 0x1d42aea2879f2e44ULL,
+	0x0b2784c4ce0bf38aULL, 0x1249ad2594c37cebULL, 0xcdf165f6018ef06dULL, 0x16dc186ef9f45c25ULL,
+	0x416dbf7381f2ac88ULL, 0x1c931e8ab871732fULL, 0x88e497a83137abd5ULL, 0x11dbf316b346e7fdULL,
+	0xeb1dbd923d8596caULL, 0x1652efdc6018a1fcULL, 0x25e52cf6cce6fc7dULL, 0x1be7abd3781eca7cULL,
+	0x97af3c1a40105dceULL, 0x1170cb642b133e8dULL, 0xfd9b0b20d0147542ULL, 0x15ccfe3d35d80e30ULL,
+	0x3d01cde904199292ULL, 0x1b403dcc834e11bdULL, 0x462120b1a28ffb9bULL, 0x1108269fd210cb16ULL,
+	0xd7a968de0b33fa82ULL, 0x154a3047c694fddbULL, 0xcd93c3158e00f923ULL, 0x1a9cbc59b83a3d52ULL,
+	0xc07c59ed78c09bb6ULL, 0x10a1f5b813246653ULL, 0xb09b7068d6f0c2a3ULL, 0x14ca732617ed7fe8ULL,
+	0xdcc24c830cacf34cULL, 0x19fd0fef9de8dfe2ULL, 0xc9f96fd1e7ec180fULL, 0x103e29f5c2b18bedULL,
+	0x3c77cbc661e71e13ULL, 0x144db473335deee9ULL, 0x8b95beb7fa60e598ULL, 0x1961219000356aa3ULL,
+	0x6e7b2e65f8f91efeULL, 0x1fb969f40042c54cULL, 0xc50cfcffbb9bb35fULL, 0x13d3e2388029bb4fULL,
+	0xb6503c3faa82a037ULL, 0x18c8dac6a0342a23ULL, 0xa3e44b4f95234844ULL, 0x1efb1178484134acULL,
+	0xe66eaf11bd360d2bULL, 0x135ceaeb2d28c0ebULL, 0xe00a5ad62c839075ULL, 0x183425a5f872f126ULL,
+	0x980cf18bb7a47493ULL, 0x1e412f0f768fad70ULL, 0x5f0816f752c6c8dcULL, 0x12e8bd69aa19cc66ULL,
+	0xf6ca1cb527787b13ULL, 0x17a2ecc414a03f7fULL, 0xf47ca3e2715699d7ULL, 0x1d8ba7f519c84f5fULL,
+	0xf8cde66d86d62026ULL, 0x127748f9301d319bULL, 0xf7016008e88ba830ULL, 0x17151b377c247e02ULL,
+	0xb4c1b80b22ae923cULL, 0x1cda62055b2d9d83ULL, 0x50f91306f5ad1b65ULL, 0x12087d4358fc8272ULL,
+	0xe53757c8b318623fULL, 0x168a9c942f3ba30eULL, 0x9e852dbadfde7acfULL, 0x1c2d43b93b0a8bd2ULL,
+	0xa3133c94cbeb0cc1ULL, 0x119c4a53c4e69763ULL, 0x8bd80bb9fee5cff1ULL, 0x16035ce8b6203d3cULL,
+	0xaece0ea87e9f43eeULL, 0x1b843422e3a84c8bULL, 0x4d40c9294f238a75ULL, 0x1132a095ce492fd7ULL,
+	0x2090fb73a2ec6d12ULL, 0x157f48bb41db7bcdULL, 0x68b53a508ba78856ULL, 0x1adf1aea12525ac0ULL,
+	0x417144725748b536ULL, 0x10cb70d24b7378b8ULL, 0x51cd958eed1ae283ULL, 0x14fe4d06de5056e6ULL,
+	0xe640faf2a8619b24ULL, 0x1a3de04895e46c9fULL, 0xefe89cd7a93d00f7ULL, 0x1066ac2d5daec3e3ULL,
+	0xebe2c40d938c4134ULL, 0x14805738b51a74dcULL, 0x26db7510f86f5181ULL, 0x19a06d06e2611214ULL,
+	0x9849292a9b4592f1ULL, 0x100444244d7cab4cULL, 0xbe5b73754216f7adULL, 0x1405552d60dbd61fULL,
+	0xadf25052929cb598ULL, 0x1906aa78b912cba7ULL, 0x996ee4673743e2ffULL, 0x1f485516e7577e91ULL,
+	0xffe54ec0828a6ddfULL, 0x138d352e5096af1aULL, 0xbfdea270a32d0957ULL, 0x18708279e4bc5ae1ULL,
+	0x2fd64b0ccbf84badULL, 0x1e8ca3185deb719aULL, 0x5de5eee7ff7b2f4cULL, 0x1317e5ef3ab32700ULL,
+	0x755f6aa1ff59fb1fULL, 0x17dddf6b095ff0c0ULL, 0x92b7454a7f3079e7ULL, 0x1dd55745cbb7ecf0ULL,
+	0x5bb28b4e8f7e4c30ULL, 0x12a5568b9f52f416ULL, 0xf29f2e22335ddf3cULL, 0x174eac2e8727b11bULL,
+	0xef46f9aac035570bULL, 0x1d22573a28f19d62ULL, 0xd58c5c0ab8215667ULL, 0x123576845997025dULL,
+	0x4aef730d6629ac01ULL, 0x16c2d4256ffcc2f5ULL, 0x9dab4fd0bfb41701ULL, 0x1c73892ecbfbf3b2ULL,
+	0xa28b11e277d08e60ULL, 0x11c835bd3f7d784fULL, 0x8b2dd65b15c4b1f9ULL, 0x163a432c8f5cd663ULL,
+	0x6df94bf1db35de77ULL, 0x1bc8d3f7b3340bfcULL, 0xc4bbcf772901ab0aULL, 0x115d847ad000877dULL,
+	0x35eac354f34215cdULL, 0x15b4e5998400a95dULL, 0x8365742a30129b40ULL, 0x1b221effe500d3b4ULL,
+	0xd21f689a5e0ba108ULL, 0x10f5535fef208450ULL, 0x06a742c0f58e894aULL, 0x1532a837eae8a565ULL,
+	0x4851137132f22b9dULL, 0x1a7f5245e5a2cebeULL, 0xed32ac26bfd75b42ULL, 0x108f936baf85c136ULL,
+	0xa87f57306fcd3212ULL, 0x14b378469b673184ULL, 0xd29f2cfc8bc07e97ULL, 0x19e056584240fde5ULL,
+	0xa3a37c1dd7584f1eULL, 0x102c35f729689eafULL, 0x8c8c5b254d2e62e6ULL, 0x14374374f3c2c65bULL,
+	0x6faf71eea079fb9fULL, 0x1945145230b377f2ULL, 0x0b9b4e6a48987a87ULL, 0x1f965966bce055efULL,
+	0x674111026d5f4c94ULL, 0x13bdf7e0360c35b5ULL, 0xc111554308b71fbaULL, 0x18ad75d8438f4322ULL,
+	0x7155aa93cae4e7a8ULL, 0x1ed8d34e547313ebULL, 0x26d58a9c5ecf10c9ULL, 0x13478410f4c7ec73ULL,
+	0xf08aed437682d4fbULL, 0x1819651531f9e78fULL, 0xecada89454238a3aULL, 0x1e1fbe5a7e786173ULL,
+	0x73ec895cb4963664ULL, 0x12d3d6f88f0b3ce8ULL, 0x90e7abb3e1bbc3fdULL, 0x1788ccb6b2ce0c22ULL,
+	0x352196a0da2ab4fdULL, 0x1d6affe45f818f2bULL, 0x0134fe24885ab11eULL, 0x1262dfeebbb0f97bULL,
+	0xc1823dadaa715d65ULL, 0x16fb97ea6a9d37d9ULL, 0x31e2cd19150db4bfULL, 0x1cba7de5054485d0ULL,
+	0x1f2dc02fad2890f7ULL, 0x11f48eaf234ad3a2ULL, 0xa6f9303b9872b535ULL, 0x1671b25aec1d888aULL,
+	0x50b77c4a7e8f6282ULL, 0x1c0e1ef1a724eaadULL, 0x5272adae8f199d91ULL, 0x1188d357087712acULL,
+	0x670f591a32e004f6ULL, 0x15eb082cca94d757ULL, 0x40d32f60bf980633ULL, 0x1b65ca37fd3a0d2dULL,
+	0x4883fd9c77bf03e0ULL, 0x111f9e62fe44483cULL, 0x5aa4fd0395aec4d8ULL, 0x156785fbbdd55a4bULL,
+	0x314e3c447b1a760eULL, 0x1ac1677aad4ab0deULL, 0xded0e5aaccf089c9ULL, 0x10b8e0acac4eae8aULL,
+	0x96851f15802cac3bULL, 0x14e718d7d7625a2dULL, 0xfc2666dae037d74aULL, 0x1a20df0dcd3af0b8ULL,
+	0x9d980048cc22e68eULL, 0x10548b68a044d673ULL, 0x84fe005aff2ba032ULL, 0x1469ae42c8560c10ULL,
+	0xa63d8071bef6883eULL, 0x198419d37a6b8f14ULL, 0xcfcce08e2eb42a4eULL, 0x1fe52048590672d9ULL,
+	0x21e00c58dd309a70ULL, 0x13ef342d37a407c8ULL, 0x2a580f6f147cc10dULL, 0x18eb0138858d09baULL,
+	0xb4ee134ad99bf150ULL, 0x1f25c186a6f04c28ULL, 0x7114cc0ec80176d2ULL, 0x137798f428562f99ULL,
+	0xcd59ff127a01d486ULL, 0x18557f31326bbb7fULL, 0xc0b07ed7188249a8ULL, 0x1e6adefd7f06aa5fULL,
+	0xd86e4f466f516e09ULL, 0x1302cb5e6f642a7bULL, 0xce89e3180b25c98bULL, 0x17c37e360b3d351aULL,
+	0x822c5bde0def3beeULL, 0x1db45dc38e0c8261ULL, 0xf15bb96ac8b58575ULL, 0x1290ba9a38c7d17cULL,
+	0x2db2a7c57ae2e6d2ULL, 0x1734e940c6f9c5dcULL, 0x391f51b6d99ba086ULL, 0x1d022390f8b83753ULL,
+	0x03b3931248014454ULL, 0x1221563a9b732294ULL, 0x04a077d6da019569ULL, 0x16a9abc9424feb39ULL,
+	0x45c895cc9081fac3ULL, 0x1c5416bb92e3e607ULL, 0x8b9d5d9fda513cbaULL, 0x11b48e353bce6fc4ULL,
+	0xae84b507d0e58be8ULL, 0x1621b1c28ac20bb5ULL, 0x1a25e249c51eeee3ULL, 0x1baa1e332d728ea3ULL,
+	0xf057ad6e1b33554dULL, 0x114a52dffc679925ULL, 0x6c6d98c9a2002aa1ULL, 0x159ce797fb817f6fULL,
+	0x4788fefc0a803549ULL, 0x1b04217dfa61df4bULL, 0x0cb59f5d8690214eULL, 0x10e294eebc7d2b8fULL,
+	0xcfe30734e83429a1ULL, 0x151b3a2a6b9c7672ULL, 0x83dbc9022241340aULL, 0x1a6208b50683940fULL,
+	0xb2695da15568c086ULL, 0x107d457124123c89ULL, 0x1f03b509aac2f0a7ULL, 0x149c96cd6d16cbacULL,
+	0x26c4a24c1573acd1ULL, 0x19c3bc80c85c7e97ULL, 0x783ae56f8d684c03ULL, 0x101a55d07d39cf1eULL,
+	0x16499ecb70c25f03ULL, 0x1420eb449c8842e6ULL, 0x9bdc067e4cf2f6c4ULL, 0x19292615c3aa539fULL,
+	0x82d3081de02fb476ULL, 0x1f736f9b3494e887ULL, 0xb1c3e512ac1dd0c9ULL, 0x13a825c100dd1154ULL,
+	0xde34de57572544fcULL, 0x18922f31411455a9ULL, 0x55c215ed2cee963bULL, 0x1eb6bafd91596b14ULL,
+	0xb5994db43c151de5ULL, 0x133234de7ad7e2ecULL, 0xe2ffa1214b1a655eULL, 0x17fec216198ddba7ULL,
+	0xdbbf89699de0feb6ULL, 0x1dfe729b9ff15291ULL, 0x2957b5e202ac9f31ULL, 0x12bf07a143f6d39bULL,
+	0xf3ada35a8357c6feULL, 0x176ec98994f48881ULL, 0x70990c31242db8bdULL, 0x1d4a7bebfa31aaa2ULL,
+	0x865fa79eb69c9376ULL, 0x124e8d737c5f0aa5ULL, 0xe7f791866443b854ULL, 0x16e230d05b76cd4eULL,
+	0xa1f575e7fd54a669ULL, 0x1c9abd04725480a2ULL, 0xa53969b0fe54e801ULL, 0x11e0b622c774d065ULL,
+	0x0e87c41d3dea2202ULL, 0x1658e3ab7952047fULL, 0xd229b5248d64aa82ULL, 0x1bef1c9657a6859eULL,
+	0x435a1136d85eea91ULL, 0x117571ddf6c81383ULL, 0x143095848e76a536ULL, 0x15d2ce55747a1864ULL,
+	0x193cbae5b2144e83ULL, 0x1b4781ead1989e7dULL, 0x2fc5f4cf8f4cb112ULL, 0x110cb132c2ff630eULL,
+	0xbbb77203731fdd56ULL, 0x154fdd7f73bf3bd1ULL, 0x2aa54e844fe7d4acULL, 0x1aa3d4df50af0ac6ULL,
+	0xdaa75112b1f0e4ebULL, 0x10a6650b926d66bbULL, 0xd15125575e6d1e26ULL, 0x14cffe4e7708c06aULL,
+	0x85a56ead360865b0ULL, 0x1a03fde214caf085ULL, 0x7387652c41c53f8eULL, 0x10427ead4cfed653ULL,
+	0x50693e7752368f71ULL, 0x14531e58a03e8be8ULL, 0x64838e1526c4334eULL, 0x1967e5eec84e2ee2ULL,
+	0xfda4719a70754022ULL, 0x1fc1df6a7a61ba9aULL, 0xde86c70086494815ULL, 0x13d92ba28c7d14a0ULL,
+	0x162878c0a7db9a1aULL, 0x18cf768b2f9c59c9ULL, 0x5bb296f0d1d280a1ULL, 0x1f03542dfb83703bULL,
+	0x194f9e5683239064ULL, 0x1362149cbd322625ULL, 0x5fa385ec23ec747eULL, 0x183a99c3ec7eafaeULL,
+	0xf78c67672ce7919dULL, 0x1e494034e79e5b99ULL, 0x3ab7c0a07c10bb02ULL, 0x12edc82110c2f940ULL,
+	0x4965b0c89b14e9c3ULL, 0x17a93a2954f3b790ULL, 0x5bbf1cfac1da2433ULL, 0x1d9388b3aa30a574ULL,
+	0xb957721cb92856a0ULL, 0x127c35704a5e6768ULL, 0xe7ad4ea3e7726c48ULL, 0x171b42cc5cf60142ULL,
+	0xa198a24ce14f075aULL, 0x1ce2137f74338193ULL, 0x44ff65700cd16498ULL, 0x120d4c2fa8a030fcULL,
+	0x563f3ecc1005bdbeULL, 0x16909f3b92c83d3bULL, 0x2bcf0e7f14072d2eULL, 0x1c34c70a777a4c8aULL,
+	0x5b61690f6c847c3dULL, 0x11a0fc668aac6fd6ULL, 0xf239c35347a59b4cULL, 0x16093b802d578bcbULL,
+	0xeec83428198f021fULL, 0x1b8b8a6038ad6ebeULL, 0x553d20990ff96153ULL, 0x1137367c236c6537ULL,
+	0x2a8c68bf53f7b9a8ULL, 0x1585041b2c477e85ULL, 0x752f82ef28f5a812ULL, 0x1ae64521f7595e26ULL,
+	0x093db1d57999890bULL, 0x10cfeb353a97dad8ULL, 0x0b8d1e4ad7ffeb4eULL, 0x1503e602893dd18eULL,
+	0x8e7065dd8dffe622ULL, 0x1a44df832b8d45f1ULL, 0xf9063faa78bfefd5ULL, 0x106b0bb1fb384bb6ULL,
+	0xb747cf9516efebcaULL, 0x1485ce9e7a065ea4ULL, 0xe519c37a5cabe6bdULL, 0x19a742461887f64dULL,
+	0xaf301a2c79eb7036ULL, 0x1008896bcf54f9f0ULL, 0xdafc20b798664c43ULL, 0x140aabc6c32a386cULL,
+	0x11bb28e57e7fdf54ULL, 0x190d56b873f4c688ULL, 0x1629f31ede1fd72aULL, 0x1f50ac6690f1f82aULL,
+	0x4dda37f34ad3e67aULL, 0x13926bc01a973b1aULL, 0xe150c5f01d88e019ULL, 0x187706b0213d09e0ULL,
+	0x19a4f76c24eb181fULL, 0x1e94c85c298c4c59ULL, 0xb0071aa39712ef13ULL, 0x131cfd3999f7afb7ULL,
+	0x9c08e14c7cd7aad8ULL, 0x17e43c8800759ba5ULL, 0x030b199f9c0d958eULL, 0x1ddd4baa0093028fULL,
+	0x61e6f003c1887d79ULL, 0x12aa4f4a405be199ULL, 0xba60ac04b1ea9cd7ULL, 0x1754e31cd072d9ffULL,
+	0xa8f8d705de65440dULL, 0x1d2a1be4048f907fULL, 0xc99b8663aaff4a88ULL, 0x123a516e82d9ba4fULL,
+	0xbc0267fc95bf1d2aULL, 0x16c8e5ca239028e3ULL, 0xab0301fbbb2ee474ULL, 0x1c7b1f3cac74331cULL,
+	0xeae1e13d54fd4ec9ULL, 0x11ccf385ebc89ff1ULL, 0x659a598caa3ca27bULL, 0x1640306766bac7eeULL,
+	0xff00efefd4cbcb1aULL, 0x1bd03c81406979e9ULL, 0x3f6095f5e4ff5ef0ULL, 0x116225d0c841ec32ULL,
+	0xcf38bb735e3f36acULL, 0x15baaf44fa52673eULL, 0x8306ea5035cf0457ULL, 0x1b295b1638e7010eULL,
+	0x11e4527221a162b6ULL, 0x10f9d8ede39060a9ULL, 0x565d670eaa09bb64ULL, 0x15384f295c7478d3ULL,
+	0x2bf4c0d2548c2a3dULL, 0x1a8662f3b3919708ULL, 0x1b78f88374d79a66ULL, 0x1093fdd8503afe65ULL,
+	0x625736a4520d8100ULL, 0x14b8fd4e6449bdfeULL, 0xfaed044d6690e140ULL, 0x19e73ca1fd5c2d7dULL,
+	0xbcd422b0601a8cc8ULL, 0x103085e53e599c6eULL, 0x6c092b5c78212ffaULL, 0x143ca75e8df0038aULL,
+	0x070b763396297bf8ULL, 0x194bd136316c046dULL, 0x48ce53c07bb3daf6ULL, 0x1f9ec583bdc70588ULL,
+	0x2d80f4584d5068daULL, 0x13c33b72569c6375ULL, 0x78e1316e60a48310ULL, 0x18b40a4eec437c52ULL,
+};
+
+static inline int32_t sv__pow5_bits(int32_t e)
+{
+	/*ceil(log2(5^e)) for e in [0, 3528].*/
+	return ((e * 1217359) >> 19) + 1;
+}
+
+static inline int32_t sv__log10_pow2(int32_t e)
+{
+	/*floor(log10(2^e)) for e in [0, 1650].*/
+	return (e * 78913) >> 18;
+}
+
+static inline int32_t sv__log10_pow5(int32_t e)
+{
+	/*floor(log10(5^e)) for e in [0, 2620].*/
+	return (e * 732923) >> 20;
+}
+
+static inline bool sv__multiple_of_pow5(uint64_t value, int32_t p)
+{
+	int32_t count = 0;
+	for (; value % 5 == 0; value /= 5)
+		if (++count >= p)
+			return true;
+	return p <= 0;
+}
+
+static inline bool sv__multiple_of_pow2(uint64_t value, int32_t p)
+{
+	return (value & ((1ULL << p) - 1)) == 0;
+}
+
+static inline uint64_t sv__mul_shift64(uint64_t m, const uint64_t *mul, int32_t j)
+{
+	/*(m * mul) >> j for a 128-bit mul and j in [64, 128).*/
+	uint64_t low0 = m, high0 = mul[0];
+	sv__mum(&low0, &high0);
+	uint64_t low = m, high = mul[1];
+	sv__mum(&low, &high);
+	low += high0;
+	high += low < high0;
+	int32_t shift = j - 64;
+	return shift ? (low >> shift) | (high << (64 - shift)) : low;
+}
+
+static uint64_t sv__ryu_shortest(uint64_t ieee_mantissa, uint32_t ieee_exponent, int32_t *exponent)
+{
+	/*Ryu (Adams, PLDI 2018): the shortest digits whose value rounds back to
+	the double, picking the closest when several qualify. The decimal result
+	is digits * 10^exponent.*/
+	int32_t e2;
+	uint64_t m2;
+	if (ieee_exponent == 0)
+	{
+		e2 = 1 - 1023 - 52 - 2;
+		m2 = ieee_mantissa;
+	}
+	else
+	{
+		e2 = (int32_t)ieee_exponent - 1023 - 52 - 2;
+		m2 = (1ULL << 52) | ieee_mantissa;
+	}
+	bool accept_bounds = (m2 & 1) == 0;
+
+	// The interval of values that round to the double, scaled by 4: [mv - 1 - mm_shift, mv + 2].
+	uint64_t mv = 4 * m2;
+	uint64_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+	uint64_t vr, vp, vm;
+	int32_t e10;
+	bool vm_trailing_zeros = false, vr_trailing_zeros = false;
+	if (e2 >= 0)
+	{
+		int32_t q = sv__log10_pow2(e2) - (e2 > 3);
+		e10 = q;
+		int32_t k = SV__RYU_POW5_INV_BITCOUNT + sv__pow5_bits(q) - 1;
+		int32_t i = -e2 + q + k;
+		const uint64_t *mul = sv__ryu_pow5_inv + 2 * q;
+		vr = sv__mul_shift64(4 * m2, mul, i);
+		vp = sv__mul_shift64(4 * m2 + 2, mul, i);
+		vm = sv__mul_shift64(4 * m2 - 1 - mm_shift, mul, i);
+		if (q <= 21)
+		{
+			// Only mv, mv - 1 - mm_shift or mv + 2 can be multiples of 5^q here, at most one of them.
+			if (mv % 5 == 0)
+				vr_trailing_zeros = sv__multiple_of_pow5(mv, q);
+			else if (accept_bounds)
+				vm_trailing_zeros = sv__multiple_of_pow5(mv - 1 - mm_shift, q);
+			else
+				vp -= sv__multiple_of_pow5(mv + 2, q);
+		}
+	}
+	else
+	{
+		int32_t q = sv__log10_pow5(-e2) - (-e2 > 1);
+		e10 = q + e2;
+		int32_t i = -e2 - q;
+		int32_t k = sv__pow5_bits(i) - SV__RYU_POW5_BITCOUNT;
+		int32_t j = q - k;
+		const uint64_t *mul = sv__ryu_pow5 + 2 * i;
+		vr = sv__mul_shift64(4 * m2, mul, j);
+		vp = sv__mul_shift64(4 * m2 + 2, mul, j);
+		vm = sv__mul_shift64(4 * m2 - 1 - mm_shift, mul, j);
+		if (q <= 1)
+		{
+			// mv has at least two trailing zero bits, and so do the bounds when mm_shift is 1.
+			vr_trailing_zeros = true;
+			if (accept_bounds)
+				vm_trailing_zeros = mm_shift == 1;
+			else
+				--vp;
+		}
+		else if (q < 63)
+			vr_trailing_zeros = sv__multiple_of_pow2(mv, q);
+	}
+
+	// Drop digits while the interval still holds a shorter number.
+	int32_t removed = 0;
+	uint64_t output;
+	if (vm_trailing_zeros || vr_trailing_zeros)
+	{
+		// Exact bounds or ties possible (rare): track them digit by digit.
+		unsigned last_removed = 0;
+		while (vp / 10 > vm / 10)
+		{
+			vm_trailing_zeros &= vm % 10 == 0;
+			vr_trailing_zeros &= last_removed == 0;
+			last_removed = vr % 10;
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			++removed;
+		}
+		if (vm_trailing_zeros)
+		{
+			while (vm % 10 == 0)
+			{
+				vr_trailing_zeros &= last_removed == 0;
+				last_removed = vr % 10;
+				vr /= 10;
+				vp /= 10;
+				vm /= 10;
+				++removed;
+			}
+		}
+		if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0)
+			last_removed = 4; // exactly halfway: round to even
+		output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_removed >= 5);
+	}
+	else
+	{
+		bool round_up = false;
+		if (vp / 100 > vm / 100)
+		{
+			round_up = vr % 100 >= 50;
+			vr /= 100;
+			vp /= 100;
+			vm /= 100;
+			removed += 2;
+		}
+		while (vp / 10 > vm / 10)
+		{
+			round_up = vr % 10 >= 5;
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			++removed;
+		}
+		output = vr + (vr == vm || round_up);
+	}
+	*exponent = e10 + removed;
+	return output;
+}
+
+SVDEF StringView sv_format_double(char *buffer, double value)
+{
+	/*Plain notation when the leading digit's exponent is in [-6, 21),
+	scientific outside it, like JavaScript's Number.prototype.toString:
+	"0.001", "123.5", "1e+21", "-2.5e-8". Infinities and NaN are written as
+	"inf", "-inf" and "nan", which sv_parse_double reads back.*/
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	uint64_t ieee_mantissa = bits & ((1ULL << 52) - 1);
+	uint32_t ieee_exponent = (uint32_t)(bits >> 52) & 0x7FF;
+	char *p = buffer;
+	StringView sv = {.data = buffer};
+	if (ieee_exponent == 0x7FF && ieee_mantissa)
+	{
+		memcpy(p, "nan", 3);
+		sv.len = 3;
+		return sv;
+	}
+	if (bits >> 63)
+		*p++ = '-';
+	if (ieee_exponent == 0x7FF)
+	{
+		memcpy(p, "inf", 3);
+		sv.len = p + 3 - buffer;
+		return sv;
+	}
+	if (ieee_exponent == 0 && ieee_mantissa == 0)
+	{
+		*p = '0';
+		sv.len = p + 1 - buffer;
+		return sv;
+	}
+
+	int32_t exponent;
+	uint64_t output = sv__ryu_shortest(ieee_mantissa, ieee_exponent, &exponent);
+	char digits[20];
+	int32_t n = (int32_t)sv__format_u64(digits, output);
+	int32_t point = exponent + n; // digits before the decimal point
+	if (point > -6 && point <= 21)
+	{
+		if (point <= 0)
+		{
+			memcpy(p, "0.", 2);
+			memset(p + 2, '0', -point);
+			p += 2 - point;
+			memcpy(p, digits, n);
+			p += n;
+		}
+		else if (point >= n)
+		{
+			memcpy(p, digits, n);
+			memset(p + n, '0', point - n);
+			p += point;
+		}
+		else
+		{
+			memcpy(p, digits, point);
+			p[point] = '.';
+			memcpy(p + point + 1, digits + point, n - point);
+			p += n + 1;
+		}
+	}
+	else
+	{
+		*p++ = digits[0];
+		if (n > 1)
+		{
+			*p++ = '.';
+			memcpy(p, digits + 1, n - 1);
+			p += n - 1;
+		}
+		int32_t e = point - 1;
+		*p++ = 'e';
+		*p++ = e < 0 ? '-' : '+';
+		p += sv__format_u64(p, e < 0 ? -e : e);
+	}
+	sv.len = p - buffer;
+	return sv;
+}
+
+SVDEF void sv_builder_append_double(sv_builder *builder, double value)
+{
+	if (sv_builder_reserve(builder, SV_FORMAT_DOUBLE_MAX))
+		return;
+	char *data = sv__builder_data(builder);
+	builder->len += sv_format_double(data + builder->len, value).len;
+	data[builder->len] = '\0';
+}
+
+static inline uint64_t sv__map_hash(const sv_map *map, StringView key)
+{
+	uint64_t hash = sv_hash_seeded(key, map->seed);
+	return hash ? hash : 1;
+}
+
+static inline uint64_t sv__map_tag(StringView key)
+{
+	/*Length (saturated to 16 bits) over the first six bytes, zero padded. For
+	keys of up to six bytes equal tags and lengths mean equal keys.*/
+	uint64_t prefix = 0;
+	for (size_t i = 0; i < key.len && i < 6; i++)
+		prefix |= (uint64_t)(unsigned char)key.data[i] << (8 * i);
+	return ((uint64_t)(key.len < 0xFFFF ? key.len : 0xFFFF) << 48) | prefix;
+}
+
+static size_t sv__map_probe(const sv_map *map, StringView key, uint64_t hash, uint64_t tag)
+{
+	/*Slot holding key, or the empty slot where it would be inserted.*/
+	size_t mask = map->capacity - 1;
+	for (size_t i = hash & mask;; i = (i + 1) & mask)
+	{
+		const sv_map_slot *slot = &map->slots[i];
+		if (slot->hash == 0)
+			return i;
+		if (slot->hash == hash && slot->tag == tag && slot->key.len == key.len &&
+			(key.len <= 6 || memcmp(slot->key.data + 6, key.data + 6, key.len - 6) == 0))
+			return i;
+	}
+}
+
+static uint64_t sv__map_seed(const sv_map *map)
+{
+	/*Mixes the map's address, the clock and a code address (ASLR). Not
+	cryptographic, but collisions can no longer be precomputed offline.*/
+	uint64_t where = (uint64_t)(uintptr_t)map ^ ((uint64_t)(uintptr_t)&sv__map_seed << 17);
+	uint64_t when = (uint64_t)time(NULL) ^ ((uint64_t)clock() << 32);
+	uint64_t seed = sv__mix(where ^ 0x9E3779B97F4A7C15ULL, when ^ 0xD1B54A32D192ED03ULL);
+	return seed ? seed : 1;
+}
+
+static int sv__map_resize(sv_map *map, size_t capacity)
+{
+	sv_map_slot *slots = calloc(capacity, sizeof(sv_map_slot));
+	if (slots == NULL)
+		return ENOMEM;
+	sv_map_slot *old = map->slots;
+	size_t old_capacity = map->capacity;
+	map->slots = slots;
+	map->capacity = capacity;
+	for (size_t i = 0; i < old_capacity; i++)
+	{
+		if (old[i].hash == 0)
+			continue;
+		// Keys are distinct, so only the empty-slot search is needed.
+		size_t j = old[i].hash & (capacity - 1);
+		while (slots[j].hash != 0)
+			j = (j + 1) & (capacity - 1);
+		slots[j] = old[i];
+	}
+	free(old);
+	return 0;
+}
+
+SVDEF int sv_map_init(sv_map *map, size_t expected)
+{
+	/*Sizes the table so expected keys fit without rehashing and picks the
+	hash seed. Returns 0 or ENOMEM.*/
+	memset(map, 0, sizeof(*map));
+	map->seed = sv__map_seed(map);
+	size_t capacity = 16;
+	while (capacity / 4 * 3 < expected)
+		capacity *= 2;
+	return sv__map_resize(map, capacity);
+}
+
+SVDEF void sv_map_free(sv_map *map)
+{
+	free(map->slots);
+	map->slots = NULL;
+	map->capacity = 0;
+	map->count = 0;
+}
+
+SVDEF void **sv_map_upsert(sv_map *map, StringView key)
+{
+	/*Pointer to the value stored for key, inserting key with a NULL value when
+	it is missing. Valid until the next insertion. Returns NULL on ENOMEM.*/
+	if ((map->count + 1) * 4 > map->capacity * 3 && sv__map_resize(map, map->capacity ? map->capacity * 2 : 16))
+		return NULL;
+	uint64_t hash = sv__map_hash(map, key), tag = sv__map_tag(key);
+	sv_map_slot *slot = &map->slots[sv__map_probe(map, key, hash, tag)];
+	if (slot->hash == 0)
+	{
+		slot->hash = hash;
+		slot->tag = tag;
+		slot->key = key;
+		slot->value = NULL;
+		map->count++;
+	}
+	return &slot->value;
+}
+
+SVDEF int sv_map_put(sv_map *map, StringView key, void *value)
+{
+	/*Inserts or overwrites. Returns 0 or ENOMEM.*/
+	void **slot = sv_map_upsert(map, key);
+	if (slot == NULL)
+		return ENOMEM;
+	*slot = value;
+	return 0;
+}
+
+SVDEF bool sv_map_get(const sv_map *map, StringView key, void **value)
+{
+	/*value may be NULL to only test for key.*/
+	if (map->count == 0)
+		return false;
+	const sv_map_slot *slot = &map->slots[sv__map_probe(map, key, sv__map_hash(map, key), sv__map_tag(key))];
+	if (slot->hash == 0)
+		return false;
+	if (value)
+		*value = slot->value;
+	return true;
+}
+
+SVDEF bool sv_map_remove(sv_map *map, StringView key)
+{
+	if (map->count == 0)
+		return false;
+	size_t mask = map->capacity - 1;
+	size_t i = sv__map_probe(map, key, sv__map_hash(map, key), sv__map_tag(key));
+	if (map->slots[i].hash == 0)
+		return false;
+
+	// Backward shift: pull later entries of the run into the hole unless their
+	// home slot lies cyclically in (hole, j], so no tombstones are needed.
+	for (size_t j = (i + 1) & mask; map->slots[j].hash != 0; j = (j + 1) & mask)
+	{
+		size_t home = map->slots[j].hash & mask;
+		bool stays = i < j ? (home > i && home <= j) : (home > i || home <= j);
+		if (!stays)
+		{
+			map->slots[i] = map->slots[j];
+			i = j;
+		}
+	}
+	map->slots[i].hash = 0;
+	map->count--;
+	return true;
+}
+
+SVDEF size_t sv_map_find_many(const sv_map *map, const StringView *keys, size_t count, void **values, bool *found)
+{
+	/*Looks up count keys, storing each value (NULL when missing) and, if found
+	is not NULL, whether the key was there. Keys are hashed a batch at a time
+	and their home slots prefetched before any is probed, so the cache misses of
+	a batch overlap. Returns how many keys were found.*/
+	enum
+	{
+		SV__MAP_BATCH = 8
+	};
+	size_t hits = 0;
+	for (size_t base = 0; base < count; base += SV__MAP_BATCH)
+	{
+		size_t n = count - base < SV__MAP_BATCH ? count - base : SV__MAP_BATCH;
+		uint64_t hashes[SV__MAP_BATCH];
+		if (map->count)
+		{
+			for (size_t k = 0; k < n; k++)
+			{
+				hashes[k] = sv__map_hash(map, keys[base + k]);
+				SV__PREFETCH(&map->slots[hashes[k] & (map->capacity - 1)]);
+			}
+		}
+		for (size_t k = 0; k < n; k++)
+		{
+			StringView key = keys[base + k];
+			const sv_map_slot *slot = NULL;
+			if (map->count)
+			{
+				slot = &map->slots[sv__map_probe(map, key, hashes[k], sv__map_tag(key))];
+				if (slot->hash == 0)
+					slot = NULL;
+			}
+			values[base + k] = slot ? slot->value : NULL;
+			if (found)
+				found[base + k] = slot != NULL;
+			hits += slot != NULL;
+		}
+	}
+	return hits;
+}
+
+typedef struct sv__arena_block
+{
+	struct sv__arena_block *prev;
+	size_t size; /* header included */
+	bool mapped;
+} sv__arena_block;
+
+#define SV__ARENA_HEADER ((sizeof(sv__arena_block) + 15) & ~(size_t)15)
+
+static bool sv__arena_grow(sv_arena *arena, size_t need)
+{
+	/*Starts a new block with room for need bytes after the header.*/
+	size_t size = arena->block_size ? arena->block_size : 1024 * 1024;
+	if (need > SIZE_MAX - SV__ARENA_HEADER - (2 << 20))
+		return false;
+	if (size < need + SV__ARENA_HEADER)
+		size = need + SV__ARENA_HEADER;
+
+	sv__arena_block *block = NULL;
+	bool mapped = false;
+#if defined(SV_POSIX) && defined(MAP_ANONYMOUS)
+	if (arena->flags & SV_ARENA_HUGEPAGES)
+	{
+		size = (size + (2 << 20) - 1) & ~(size_t)((2 << 20) - 1);
+		void *addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (addr != MAP_FAILED)
+		{
+#ifdef MADV_HUGEPAGE
+			madvise(addr, size, MADV_HUGEPAGE);
+#endif
+			block = addr;
+			mapped = true;
+		}
+	}
+#endif
+	if (block == NULL)
+		block = malloc(size);
+	if (block == NULL)
+		return false;
+	block->prev = arena->block;
+	block->size = size;
+	block->mapped = mapped;
+	arena->block = block;
+	arena->ptr = (char *)block + SV__ARENA_HEADER;
+	arena->end = (char *)block + size;
+	return true;
+}
+
+static void sv__arena_pop(sv_arena *arena)
+{
+	/*Releases the newest block and makes the one before it current, full.*/
+	sv__arena_block *block = arena->block;
+	arena->block = block->prev;
+#if defined(SV_POSIX) && defined(MAP_ANONYMOUS)
+	if (block->mapped)
+		munmap(block, block->size);
+	else
+		free(block);
+#else
+	free(block);
+#endif
+	arena->ptr = arena->end = arena->block ? (char *)arena->block + arena->block->size : NULL;
+}
+
+SVDEF void sv_arena_init(sv_arena *arena, size_t block_size, int flags)
+{
+	/*No memory is taken until the first allocation.*/
+	memset(arena, 0, sizeof(*arena));
+	arena->block_size = block_size;
+	arena->flags = flags;
+}
+
+SVDEF void sv_arena_free(sv_arena *arena)
+{
+	while (arena->block)
+		sv__arena_pop(arena);
+}
+
+SVDEF void *sv_arena_alloc(sv_arena *arena, size_t size, size_t align)
+{
+	/*size bytes aligned to align (a power of two, 0 means 1). Returns NULL when
+	out of memory.*/
+	if (align == 0)
+		align = 1;
+	uintptr_t p = ((uintptr_t)arena->ptr + align - 1) & ~(uintptr_t)(align - 1);
+	if (arena->ptr == NULL || p > (uintptr_t)arena->end || size > (uintptr_t)arena->end - p)
+	{
+		if (size > SIZE_MAX - align || !sv__arena_grow(arena, size + align - 1))
+			return NULL;
+		p = ((uintptr_t)arena->ptr + align - 1) & ~(uintptr_t)(align - 1);
+	}
+	arena->ptr = (char *)p + size;
+	return (void *)p;
+}
+
+SVDEF StringView sv_arena_dup(sv_arena *arena, StringView sv)
+{
+	/*Copy of sv followed by a '\0', so copy.data also works as a C string.
+	Returns a view with data == NULL when out of memory.*/
+	char *copy = sv_arena_alloc(arena, sv.len + 1, 1);
+	if (copy == NULL)
+		return StringViewNull;
+	if (sv.len)
+		memcpy(copy, sv.data, sv.len);
+	copy[sv.len] = '\0';
+	StringView dup = {.data = copy, .len = sv.len};
+	return dup;
+}
+
+SVDEF sv_arena_mark sv_arena_get_mark(const sv_arena *arena)
+{
+	sv_arena_mark mark = {.block = arena->block, .ptr = arena->ptr};
+	return mark;
+}
+
+SVDEF void sv_arena_rewind(sv_arena *arena, sv_arena_mark mark)
+{
+	/*Drops everything allocated after mark was taken, releasing newer blocks.*/
+	while (arena->block != mark.block)
+		sv__arena_pop(arena);
+	if (arena->block)
+		arena->ptr = mark.ptr;
+}
+
+SVDEF void sv_arena_reset(sv_arena *arena)
+{
+	/*Drops every allocation but keeps the oldest block for reuse.*/
+	if (arena->block == NULL)
+		return;
+	while (arena->block->prev)
+		sv__arena_pop(arena);
+	arena->ptr = (char *)arena->block + SV__ARENA_HEADER;
+}
+
+static inline uint64_t sv__intern_slot(uint64_t hash, uint32_t id)
+{
+	return (hash & 0xFFFFFFFF00000000ULL) | ((uint64_t)id + 1);
+}
+
+/* The home slot comes from the hash's high half, which the slot keeps, so
+tables can be rebuilt without hashing the strings again. */
+static inline size_t sv__intern_home(uint64_t hash, size_t mask)
+{
+	return (hash >> 32) & mask;
+}
+
+static int sv__intern_rehash(sv_intern *intern, size_t capacity)
+{
+	uint64_t *slots = calloc(capacity, sizeof(uint64_t));
+	if (slots == NULL)
+		return ENOMEM;
+	for (size_t i = 0; i < intern->capacity; i++)
+	{
+		if (intern->slots[i] == 0)
+			continue;
+		size_t j = sv__intern_home(intern->slots[i], capacity - 1);
+		while (slots[j] != 0)
+			j = (j + 1) & (capacity - 1);
+		slots[j] = intern->slots[i];
+	}
+	free(intern->slots);
+	intern->slots = slots;
+	intern->capacity = capacity;
+	return 0;
+}
+
+static size_t sv__intern_probe(const sv_intern *intern, StringView sv, uint64_t hash)
+{
+	/*Slot holding sv, or the empty slot where it would be inserted.*/
+	size_t mask = intern->capacity - 1;
+	for (size_t i = sv__intern_home(hash, mask);; i = (i + 1) & mask)
+	{
+		uint64_t slot = intern->slots[i];
+		if (slot == 0)
+			return i;
+		if ((slot ^ hash) >> 32 == 0 && sv_compare(intern->strings[(uint32_t)slot - 1], sv))
+			return i;
+	}
+}
+
+SVDEF int sv_intern_init(sv_intern *intern, size_t expected)
+{
+	/*Sizes the table so expected strings fit without rehashing. Returns 0 or ENOMEM.*/
+	memset(intern, 0, sizeof(*intern));
+	size_t capacity = 16;
+	while (capacity / 4 * 3 < expected)
+		capacity *= 2;
+	return sv__intern_rehash(intern, capacity);
+}
+
+SVDEF void sv_intern_free(sv_intern *intern)
+{
+	free(intern->slots);
+	free(intern->strings);
+	sv_arena_free(&intern->arena);
+	memset(intern, 0, sizeof(*intern));
+}
+
+SVDEF uint32_t sv_intern_id(sv_intern *intern, StringView sv)
+{
+	/*Id of sv, adding it when it is new. Returns SV_INTERN_NONE when out of
+	memory or out of ids.*/
+	if ((intern->count + 1) * 4 > intern->capacity * 3 &&
+		sv__intern_rehash(intern, intern->capacity ? intern->capacity * 2 : 16))
+		return SV_INTERN_NONE;
+	uint64_t hash = sv_hash(sv);
+	size_t i = sv__intern_probe(intern, sv, hash);
+	if (intern->slots[i] != 0)
+		return (uint32_t)intern->slots[i] - 1;
+
+	if (intern->count >= SV_INTERN_NONE)
+		return SV_INTERN_NONE;
+	if (intern->count == intern->strings_capacity)
+	{
+		size_t capacity = intern->strings_capacity ? intern->strings_capacity * 2 : 64;
+		StringView *grown = realloc(intern->strings, capacity * sizeof(StringView));
+		if (grown == NULL)
+			return SV_INTERN_NONE;
+		intern->strings = grown;
+		intern->strings_capacity = capacity;
+	}
+	StringView copy = sv_arena_dup(&intern->arena, sv);
+	if (copy.data == NULL)
+		return SV_INTERN_NONE;
+	uint32_t id = intern->count++;
+	intern->strings[id] = copy;
+	intern->slots[i] = sv__intern_slot(hash, id);
+	return id;
+}
+
+SVDEF bool sv_intern_lookup(const sv_intern *intern, StringView sv, uint32_t *id)
+{
+	/*Finds the id of sv without adding it.*/
+	if (intern->count == 0)
+		return false;
+	uint64_t slot = intern->slots[sv__intern_probe(intern, sv, sv_hash(sv))];
+	if (slot == 0)
+		return false;
+	*id = (uint32_t)slot - 1;
+	return true;
+}
+
+SVDEF StringView sv_intern_view(const sv_intern *intern, uint32_t id)
+{
+	/*The stored copy for id (NUL terminated), or StringViewNull for an unknown id.*/
+	if (id >= intern->count)
+		return StringViewNull;
+	return intern->strings[id];
+}
+
+#ifdef SV_POSIX
+// The top hash bits pick the shard; they stay clear of the home slot bits
+// until a shard passes 2^26 slots.
+#define SV__INTERN_SHARD_BITS 6
+#define SV__INTERN_SEGMENTS 23
+
+/* A shard's table is replaced, never resized in place: readers may still be
+probing an old one, so retired tables are kept until the whole table is freed. */
+typedef struct sv__intern_table
+{
+	struct sv__intern_table *retired;
+	size_t capacity;
+	_Atomic uint64_t slots[];
+} sv__intern_table;
+
+typedef struct sv__intern_shard
+{
+	_Atomic(sv__intern_table *) table;
+	size_t count;
+	sv_arena arena;
+	pthread_mutex_t lock;
+} sv__intern_shard;
+
+/* Views by id live in segments of doubling size (segment k holds 1024 << k
+ids), so growing never moves an entry a reader may be looking at. */
+typedef struct sv__intern_shared
+{
+	sv__intern_shard shards[1 << SV__INTERN_SHARD_BITS];
+	_Atomic(StringView *) segments[SV__INTERN_SEGMENTS];
+	atomic_uint_fast64_t next_id;
+} sv__intern_shared;
+
+static sv__intern_table *sv__intern_table_new(size_t capacity)
+{
+	sv__intern_table *table = malloc(sizeof(sv__intern_table) + capacity * sizeof(uint64_t));
+	if (table == NULL)
+		return NULL;
+	table->retired = NULL;
+	table->capacity = capacity;
+	for (size_t i = 0; i < capacity; i++)
+		atomic_init(&table->slots[i], 0);
+	return table;
+}
+
+static inline size_t sv__intern_segment(uint32_t id, size_t *index)
+{
+	uint64_t biased = (uint64_t)id + 1024;
+	size_t k = 63 - __builtin_clzll(biased) - 10;
+	*index = biased - ((uint64_t)1024 << k);
+	return k;
+}
+
+static StringView *sv__intern_segment_get(sv__intern_shared *shared, size_t k)
+{
+	/*Segment k, created on first use. Shards race to create it; the loser
+	frees its copy. NULL when out of memory.*/
+	StringView *segment = atomic_load_explicit(&shared->segments[k], memory_order_acquire);
+	if (segment != NULL)
+		return segment;
+	StringView *fresh = calloc((size_t)1024 << k, sizeof(StringView));
+	if (fresh == NULL)
+		return NULL;
+	if (atomic_compare_exchange_strong_explicit(&shared->segments[k], &segment, fresh, memory_order_acq_rel,
+												memory_order_acquire))
+		return fresh;
+	free(fresh);
+	return segment;
+}
+
+static StringView sv__intern_entry(sv__intern_shared *shared, uint32_t id)
+{
+	size_t index, k = sv__intern_segment(id, &index);
+	StringView *segment = atomic_load_explicit(&shared->segments[k], memory_order_acquire);
+	return segment ? segment[index] : StringViewNull;
+}
+
+static bool sv__intern_table_find(sv__intern_shared *shared, sv__intern_table *table, StringView sv,
+								  uint64_t hash, size_t *at, uint32_t *id)
+{
+	/*Lock-free probe. The acquire load of a slot makes the id's view visible.
+	On a miss *at is the empty slot that ended the probe.*/
+	size_t mask = table->capacity - 1;
+	for (size_t i = sv__intern_home(hash, mask);; i = (i + 1) & mask)
+	{
+		uint64_t slot = atomic_load_explicit(&table->slots[i], memory_order_acquire);
+		if (slot == 0)
+		{
+			*at = i;
+			return false;
+		}
+		if ((slot ^ hash) >> 32 == 0 && sv_compare(sv__intern_entry(shared, (uint32_t)slot - 1), sv))
+		{
+			*id = (uint32_t)slot - 1;
+			return true;
+		}
+	}
+}
+
+static bool sv__intern_grow(sv__intern_shard *shard)
+{
+	/*Called with the shard locked. Publishes a table of twice the size.*/
+	sv__intern_table *old = atomic_load_explicit(&shard->table, memory_order_relaxed);
+	sv__intern_table *table = sv__intern_table_new(old->capacity * 2);
+	if (table == NULL)
+		return false;
+	size_t mask = table->capacity - 1;
+	for (size_t i = 0; i < old->capacity; i++)
+	{
+		uint64_t slot = atomic_load_explicit(&old->slots[i], memory_order_relaxed);
+		if (slot == 0)
+			continue;
+		size_t j = sv__intern_home(slot, mask);
+		while (atomic_load_explicit(&table->slots[j], memory_order_relaxed) != 0)
+			j = (j + 1) & mask;
+		atomic_store_explicit(&table->slots[j], slot, memory_order_relaxed);
+	}
+	table->retired = old;
+	atomic_store_explicit(&shard->table, table, memory_order_release);
+	return true;
+}
+#else
+typedef struct sv__intern_shared
+{
+	sv_intern single;
+} sv__intern_shared;
+#endif
+
+SVDEF int sv_intern_concurrent_init(sv_intern_concurrent *intern)
+{
+	/*Returns 0 or ENOMEM.*/
+	sv__intern_shared *shared = calloc(1, sizeof(sv__intern_shared));
+	intern->shared = shared;
+	if (shared == NULL)
+		return ENOMEM;
+#ifdef SV_POSIX
+	atomic_init(&shared->next_id, 0);
+	for (size_t k = 0; k < SV__INTERN_SEGMENTS; k++)
+		atomic_init(&shared->segments[k], NULL);
+	for (size_t s = 0; s < (1 << SV__INTERN_SHARD_BITS); s++)
+	{
+		sv__intern_table *table = sv__intern_table_new(64);
+		atomic_init(&shared->shards[s].table, table);
+		sv_arena_init(&shared->shards[s].arena, 64 * 1024, 0);
+		pthread_mutex_init(&shared->shards[s].lock, NULL);
+		if (table == NULL)
+		{
+			for (size_t t = s + 1; t < (1 << SV__INTERN_SHARD_BITS); t++)
+			{
+				atomic_init(&shared->shards[t].table, NULL);
+				pthread_mutex_init(&shared->shards[t].lock, NULL);
+			}
+			sv_intern_concurrent_free(intern);
+			return ENOMEM;
+		}
+	}
+	return 0;
+#else
+	return sv_intern_init(&shared->single, 0);
+#endif
+}
+
+SVDEF void sv_intern_concurrent_free(sv_intern_concurrent *intern)
+{
+	sv__intern_shared *shared = intern->shared;
+	if (shared == NULL)
+		return;
+#ifdef SV_POSIX
+	for (size_t s = 0; s < (1 << SV__INTERN_SHARD_BITS); s++)
+	{
+		sv__intern_table *table = atomic_load_explicit(&shared->shards[s].table, memory_order_relaxed);
+		while (table)
+		{
+			sv__intern_table *retired = table->retired;
+			free(table);
+			table = retired;
+		}
+		sv_arena_free(&shared->shards[s].arena);
+		pthread_mutex_destroy(&shared->shards[s].lock);
+	}
+	for (size_t k = 0; k < SV__INTERN_SEGMENTS; k++)
+		free(atomic_load_explicit(&shared->segments[k], memory_order_relaxed));
+#else
+	sv_intern_free(&shared->single);
+#endif
+	free(shared);
+	intern->shared = NULL;
+}
+
+SVDEF uint32_t sv_intern_concurrent_id(sv_intern_concurrent *intern, StringView sv)
+{
+	/*Id of sv, adding it when it is new. The common case of a known string
+	takes no lock. Returns SV_INTERN_NONE when out of memory or out of ids.*/
+	sv__intern_shared *shared = intern->shared;
+#ifdef SV_POSIX
+	uint64_t hash = sv_hash(sv);
+	sv__intern_shard *shard = &shared->shards[hash >> (64 - SV__INTERN_SHARD_BITS)];
+	size_t at;
+	uint32_t id;
+	if (sv__intern_table_find(shared, atomic_load_explicit(&shard->table, memory_order_acquire), sv, hash, &at, &id))
+		return id;
+
+	pthread_mutex_lock(&shard->lock);
+	id = SV_INTERN_NONE;
+	sv__intern_table *table = atomic_load_explicit(&shard->table, memory_order_relaxed);
+	// Another thread may have added sv since the lock-free probe.
+	if (sv__intern_table_find(shared, table, sv, hash, &at, &id))
+		goto done;
+	id = SV_INTERN_NONE;
+	if ((shard->count + 1) * 4 > table->capacity * 3)
+	{
+		if (!sv__intern_grow(shard))
+			goto done;
+		table = atomic_load_explicit(&shard->table, memory_order_relaxed);
+		sv__intern_table_find(shared, table, sv, hash, &at, &id);
+		id = SV_INTERN_NONE;
+	}
+
+	StringView copy = sv_arena_dup(&shard->arena, sv);
+	if (copy.data == NULL)
+		goto done;
+
+	// The id is claimed only once its segment exists and while ids are left,
+	// so a failure here never leaves a hole in the dense id range.
+	uint64_t next = atomic_load_explicit(&shared->next_id, memory_order_relaxed);
+	StringView *segment;
+	size_t index;
+	do
+	{
+		if (next >= SV_INTERN_NONE)
+			goto done;
+		segment = sv__intern_segment_get(shared, sv__intern_segment(next, &index));
+		if (segment == NULL)
+			goto done;
+	} while (!atomic_compare_exchange_weak_explicit(&shared->next_id, &next, next + 1, memory_order_relaxed,
+													 memory_order_relaxed));
+	segment[index] = copy;
+	id = next;
+	shard->count++;
+	atomic_store_explicit(&table->slots[at], sv__intern_slot(hash, id), memory_order_release);
+
+done:
+	pthread_mutex_unlock(&shard->lock);
+	return id;
+#else
+	return sv_intern_id(&shared->single, sv);
+#endif
+}
+
+SVDEF bool sv_intern_concurrent_lookup(const sv_intern_concurrent *intern, StringView sv, uint32_t *id)
+{
+	/*Finds the id of sv without adding it. Never locks.*/
+	sv__intern_shared *shared = intern->shared;
+#ifdef SV_POSIX
+	uint64_t hash = sv_hash(sv);
+	sv__intern_shard *shard = &shared->shards[hash >> (64 - SV__INTERN_SHARD_BITS)];
+	size_t at;
+	return sv__intern_table_find(shared, atomic_load_explicit(&shard->table, memory_order_acquire), sv, hash, &at, id);
+#else
+	return sv_intern_lookup(&shared->single, sv, id);
+#endif
+}
+
+SVDEF StringView sv_intern_concurrent_view(const sv_intern_concurrent *intern, uint32_t id)
+{
+	/*The stored copy for an id this thread got from the table, or from another
+	thread through some synchronization. StringViewNull for an unknown id.*/
+#ifdef SV_POSIX
+	if (id >= sv_intern_concurrent_count(intern))
+		return StringViewNull;
+	return sv__intern_entry(intern->shared, id);
+#else
+	return sv_intern_view(&intern->shared->single, id);
+#endif
+}
+
+SVDEF size_t sv_intern_concurrent_count(const sv_intern_concurrent *intern)
+{
+	/*Ids handed out so far. An id below the count can still be in the middle
+	of being published by its inserting thread.*/
+#ifdef SV_POSIX
+	return atomic_load_explicit(&intern->shared->next_id, memory_order_acquire);
+#else
+	return intern->shared->single.count;
+#endif
+}
+
+SVDEF void sv_csv_init(sv_csv *csv, StringView input, char delim)
+{
+	/*Parses input in place; it must outlive the fields handed out.*/
+	memset(csv, 0, sizeof(*csv));
+	csv->delim = delim;
+	csv->data = input.data;
+	csv->len = input.len;
+}
+
+SVDEF void sv_csv_init_reader(sv_csv *csv, sv_reader *reader, char delim)
+{
+	/*Streams from reader, refilling it as records need more bytes.*/
+	memset(csv, 0, sizeof(*csv));
+	csv->delim = delim;
+	csv->reader = reader;
+	StringView window = sv_reader_peek(reader);
+	csv->data = window.data;
+	csv->len = window.len;
+}
+
+SVDEF void sv_csv_free(sv_csv *csv)
+{
+	/*Frees the field array and scratch memory, not the input or the reader.*/
+	free(csv->fields);
+	free(csv->scratch);
+	csv->fields = NULL;
+	csv->field_count = 0;
+	csv->field_capacity = 0;
+	csv->scratch = NULL;
+	csv->scratch_capacity = 0;
+}
+
+static uint64_t sv__csv_block(sv_csv *csv)
+{
+	/*Loads the block at csv->scanned and returns its delimiters and newlines
+	outside quotes. The quoted state carries over from the last block. A
+	closing quote followed by another quote is a doubled quote; doubled marks
+	where the second quotes are, so each record only checks its own bytes.*/
+	const char *p = csv->data + csv->scanned;
+	size_t avail = csv->len - csv->scanned;
+	char padded[64];
+	if (avail < 64)
+	{
+		memset(padded, 0, sizeof(padded));
+		memcpy(padded, p, avail);
+		p = padded;
+	}
+	uint64_t quotes;
+	uint64_t separators = sv__kernels.csv_mask64(p, csv->delim, &quotes);
+	if (avail < 64)
+		separators &= (1ULL << avail) - 1;
+	uint64_t inside = sv__kernels.prefix_xor(quotes) ^ csv->inside;
+	uint64_t closing = quotes & ~inside;
+	csv->doubled = ((closing & (quotes >> 1)) << 1) | (csv->closing_tail & quotes);
+	csv->closing_tail = closing >> 63;
+	csv->inside = 0 - (inside >> 63);
+	csv->scanned += 64;
+	return separators & ~inside;
+}
+
+static StringView *sv__csv_grow(sv_csv *csv)
+{
+	size_t capacity = csv->field_capacity ? csv->field_capacity * 2 : 16;
+	StringView *grown = realloc(csv->fields, capacity * sizeof(StringView));
+	if (grown == NULL)
+	{
+		csv->error = ENOMEM;
+		return NULL;
+	}
+	csv->fields = grown;
+	csv->field_capacity = capacity;
+	return grown;
+}
+
+static inline StringView sv__csv_field(const char *p, size_t n)
+{
+	/*The raw bytes of a field without its surrounding quotes, if it has them.*/
+	if (n && *p == '"')
+	{
+		p++;
+		n--;
+		n -= n && p[n - 1] == '"';
+	}
+	StringView field = {.data = p, .len = n};
+	return field;
+}
+
+static inline uint64_t sv__csv_from(size_t base, size_t pos)
+{
+	/*Bits of the block at base for the bytes at pos and after.*/
+	if (pos <= base)
+		return ~0ULL;
+	return pos - base < 64 ? ~0ULL << (pos - base) : 0;
+}
+
+static bool sv__csv_unescape(sv_csv *csv, const char *record, size_t record_len)
+{
+	/*Turns doubled quotes into single ones in the fields that were opened by a
+	quote. Changed fields are copied into scratch, sized once to the record so
+	earlier fields stay put.*/
+	size_t used = 0;
+	for (size_t i = 0; i < csv->field_count; i++)
+	{
+		StringView *field = &csv->fields[i];
+		if (field->data == record || field->data[-1] != '"')
+			continue;
+		const char *in = field->data, *stop = field->data + field->len;
+		const char *quote = memchr(in, '"', field->len);
+		if (quote == NULL)
+			continue;
+
+		if (used == 0 && csv->scratch_capacity < record_len)
+		{
+			char *grown = realloc(csv->scratch, record_len);
+			if (grown == NULL)
+			{
+				csv->error = ENOMEM;
+				return false;
+			}
+			csv->scratch = grown;
+			csv->scratch_capacity = record_len;
+		}
+		char *out = csv->scratch + used, *w = out;
+		while (quote != NULL)
+		{
+			memcpy(w, in, quote - in + 1);
+			w += quote - in + 1;
+			in = quote + 1;
+			if (in < stop && *in == '"')
+				in++;
+			quote = memchr(in, '"', stop - in);
+		}
+		memcpy(w, in, stop - in);
+		w += stop - in;
+		field->data = out;
+		field->len = w - out;
+		used += field->len;
+	}
+	return true;
+}
+
+static bool sv__csv_split(sv_csv *csv, bool final)
+{
+	/*Splits the record at csv->pos into fields. Returns false when the record
+	is not complete in the bytes at hand (or, with final, there is none left).
+	The loop state stays in locals: stores to the fields could alias csv.*/
+	const char *data = csv->data;
+	StringView *fields = csv->fields;
+	size_t start = csv->pos, field_start = start, count = 0;
+	uint64_t pending = csv->pending;
+	bool escaped = false; // a doubled quote of this record in an earlier block
+	for (;;)
+	{
+		size_t base = csv->scanned - 64;
+		while (pending)
+		{
+			size_t at = base + __builtin_ctzll(pending);
+			pending &= pending - 1;
+			if (count == csv->field_capacity && (fields = sv__csv_grow(csv)) == NULL)
+				return false;
+			bool newline = data[at] == '\n';
+			size_t end = at - (newline && at > field_start && data[at - 1] == '\r');
+			fields[count++] = sv__csv_field(data + field_start, end - field_start);
+			field_start = at + 1;
+			if (newline)
+			{
+				csv->pending = pending;
+				csv->field_count = count;
+				csv->pos = at + 1;
+				escaped |= (csv->doubled & sv__csv_from(base, start) & ~sv__csv_from(base, at)) != 0;
+				return !escaped || sv__csv_unescape(csv, data + start, at - start);
+			}
+		}
+		// A partial block is loaded only once no more bytes can follow it.
+		if (csv->scanned >= csv->len || (!final && csv->len - csv->scanned < 64))
+			break;
+		escaped |= (csv->doubled & sv__csv_from(base, start)) != 0;
+		pending = sv__csv_block(csv);
+	}
+	csv->pending = 0;
+	csv->field_count = count;
+	if (!final || start == csv->len)
+		return false;
+	// The last record need not end with a newline.
+	if (count == csv->field_capacity && (fields = sv__csv_grow(csv)) == NULL)
+		return false;
+	size_t end = csv->len - (csv->len > field_start && data[csv->len - 1] == '\r');
+	fields[csv->field_count++] = sv__csv_field(data + field_start, end - field_start);
+	csv->pos = csv->len;
+	escaped |= (csv->doubled & sv__csv_from(csv->scanned - 64, start)) != 0;
+	return !escaped || sv__csv_unescape(csv, data + start, csv->len - start);
+}
+
+SVDEF bool sv_csv_next(sv_csv *csv)
+{
+	/*Reads the next record into csv->fields[0 .. field_count). Returns false at
+	the end of the input or on error (csv->error is set: ENOMEM, or the
+	reader's error). A blank line is a record with one empty field.*/
+	for (;;)
+	{
+		if (csv->error)
+			return false;
+		bool final = csv->reader == NULL || csv->reader->eof;
+		if (sv__csv_split(csv, final))
+			return true;
+		if (csv->error || final)
+		{
+			csv->field_count = 0;
+			return false;
+		}
+
+		// Drop the records handed out, read more and rescan the open record from its start.
+		sv_reader_consume(csv->reader, csv->pos);
+		if (!sv_reader_refill(csv->reader) && csv->reader->error)
+			csv->error = csv->reader->error;
+		StringView window = sv_reader_peek(csv->reader);
+		csv->data = window.data;
+		csv->len = window.len;
+		csv->pos = 0;
+		csv->scanned = 0;
+		csv->pending = 0;
+		csv->inside = 0;
+		csv->closing_tail = 0;
+		csv->doubled = 0;
+	}
+}
+
+SVDEF int sv_find_left_char_scalar(StringView *sv, char n)
+{
+	/*Plain byte loop, kept as the reference the SIMD kernels are tested against.*/
+	const char *hit = sv__find_char_scalar(sv->data, sv->len, n);
+	if (hit == NULL)
+		return -1;
+	return hit - sv->data;
+}
+
+SVDEF int sv_find_right_char_scalar(StringView *sv, char n)
+{
+	const char *hit = sv__rfind_char_scalar(sv->data, sv->len, n);
+	if (hit == NULL)
+		return -1;
+	return hit - sv->data;
+}
+
+SVDEF int sv_cmp(StringView sv, StringView sv_other)
+{
+	size_t len = sv.len < sv_other.len ? sv.len : sv_other.len;
+	int res = len ? memcmp(sv.data, sv_other.data, len) : 0;
+	if (res != 0)
+		return res;
+	return (sv.len > sv_other.len) - (sv.len < sv_other.len);
+}
+
+typedef struct sv__sort_entry
+{
+	uint64_t key;
+	StringView sv;
+} sv__sort_entry;
+
+static inline uint64_t sv__sort_key(StringView sv, size_t depth)
+{
+	/*Seven bytes from depth, big-endian so integer order is byte order,
+	zero padded. The low byte holds the bytes left (capped at 8): of two keys
+	with equal padded bytes the shorter string is a prefix and sorts first,
+	and equal keys with a tag below 8 are equal strings.*/
+	size_t left = sv.len - depth;
+	if (left >= 8)
+		return (sv__load_be64(sv.data + depth) & ~(uint64_t)0xff) | 8;
+	char buf[8] = {0};
+	if (left)
+		memcpy(buf, sv.data + depth, left);
+	return (sv__load_be64(buf) & ~(uint64_t)0xff) | left;
+}
+
+static void sv__sort_rekey(sv__sort_entry *e, size_t n, size_t depth)
+{
+	/*The strings are scattered by now; fetch a few entries ahead.*/
+	for (size_t i = 0; i < n; i++)
+	{
+		if (i + 8 < n)
+			SV__PREFETCH(e[i + 8].sv.data + depth);
+		e[i].key = sv__sort_key(e[i].sv, depth);
+	}
+}
+
+static size_t sv__sort_partition(sv__sort_entry *e, size_t n, uint64_t pivot, bool or_equal)
+{
+	/*Moves keys < pivot (<= pivot if or_equal) to the front, returns how many.*/
+	size_t i = 0, j = n;
+	for (;;)
+	{
+		while (i < j && (e[i].key < pivot || (or_equal && e[i].key == pivot)))
+			i++;
+		while (i < j && !(e[j - 1].key < pivot || (or_equal && e[j - 1].key == pivot)))
+			j--;
+		if (i >= j)
+			return i;
+		sv__sort_entry t = e[i];
+		e[i++] = e[--j];
+		e[j] = t;
+	}
+}
+
+static void sv__sort_keys(sv__sort_entry *e, size_t n, size_t depth)
+{
+	while (n > 1)
+	{
+		if (n <= 16)
+		{
+			for (size_t i = 1; i < n; i++)
+			{
+				sv__sort_entry x = e[i];
+				size_t j = i;
+				for (; j > 0 && e[j - 1].key > x.key; j--)
+					e[j] = e[j - 1];
+				e[j] = x;
+			}
+			if (e[0].key == e[n - 1].key && (e[0].key & 0xff) == 8)
+			{
+				depth += 7;
+				sv__sort_rekey(e, n, depth);
+				continue;
+			}
+			for (size_t i = 0; i < n;)
+			{
+				size_t j = i + 1;
+				while (j < n && e[j].key == e[i].key)
+					j++;
+				if (j - i > 1 && (e[i].key & 0xff) == 8)
+				{
+					sv__sort_rekey(e + i, j - i, depth + 7);
+					sv__sort_keys(e + i, j - i, depth + 7);
+				}
+				i = j;
+			}
+			return;
+		}
+
+		if (n >= 512)
+		{
+			/*MSD radix step on the first 8 key bits that are not shared by
+			every key, permuted in place (American flag sort).*/
+			uint64_t all = ~(uint64_t)0, any = 0;
+			for (size_t i = 0; i < n; i++)
+			{
+				all &= e[i].key;
+				any |= e[i].key;
+			}
+			if (all == any)
+			{
+				if ((all & 0xff) != 8)
+					return;
+				depth += 7;
+				sv__sort_rekey(e, n, depth);
+				continue;
+			}
+			int top = 63 - __builtin_clzll(all ^ any);
+			int shift = top >= 7 ? top - 7 : 0;
+			size_t count[256] = {0}, next[256], end[256];
+			for (size_t i = 0; i < n; i++)
+				count[(e[i].key >> shift) & 0xff]++;
+			size_t pos = 0, largest = 0;
+			for (int d = 0; d < 256; d++)
+			{
+				next[d] = pos;
+				pos += count[d];
+				end[d] = pos;
+				if (count[d] > count[largest])
+					largest = d;
+			}
+			for (int d = 0; d < 256; d++)
+			{
+				while (next[d] < end[d])
+				{
+					sv__sort_entry x = e[next[d]];
+					size_t digit = (x.key >> shift) & 0xff;
+					while (digit != (size_t)d)
+					{
+						sv__sort_entry t = e[next[digit]];
+						e[next[digit]++] = x;
+						x = t;
+						digit = (x.key >> shift) & 0xff;
+					}
+					e[next[d]++] = x;
+				}
+			}
+			/*Buckets other than the largest are at most n / 2.*/
+			for (int d = 0; d < 256; d++)
+				if ((size_t)d != largest && count[d] > 1)
+					sv__sort_keys(e + end[d] - count[d], count[d], depth);
+			e += end[largest] - count[largest];
+			n = count[largest];
+			continue;
+		}
+
+		uint64_t a = e[0].key, b = e[n / 2].key, c = e[n - 1].key;
+		uint64_t pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+
+		/*Two Hoare passes: [0, lt) < pivot, then the rest splits into
+		[lt, gt) == pivot and [gt, n) > pivot. Far fewer swaps than a
+		single-pass three-way partition when keys are mostly distinct.*/
+		size_t lt = sv__sort_partition(e, n, pivot, false);
+		size_t gt = lt + sv__sort_partition(e + lt, n - lt, pivot, true);
+
+		/*Recurse into the two smaller parts and loop on the largest, so the
+		stack stays O(log n) even for long shared prefixes. The equal part only
+		continues if its strings go on past this key.*/
+		size_t eq = (pivot & 0xff) == 8 ? gt - lt : 0;
+		size_t hi = n - gt;
+		if (eq >= lt && eq >= hi)
+		{
+			sv__sort_keys(e, lt, depth);
+			sv__sort_keys(e + gt, hi, depth);
+			e += lt;
+			n = eq;
+			depth += 7;
+			sv__sort_rekey(e, n, depth);
+		}
+		else
+		{
+			if (eq > 1)
+			{
+				sv__sort_rekey(e + lt, eq, depth + 7);
+				sv__sort_keys(e + lt, eq, depth + 7);
+			}
+			if (lt >= hi)
+			{
+				sv__sort_keys(e + gt, hi, depth);
+				n = lt;
+			}
+			else
+			{
+				sv__sort_keys(e, lt, depth);
+				e += gt;
+				n = hi;
+			}
+		}
+	}
+}
+
+SVDEF int sv_sort(StringView *arr, size_t n)
+{
+	if (n < 2)
+		return 0;
+	sv__sort_entry *e = (sv__sort_entry *)malloc(n * sizeof *e);
+	if (!e)
+		return ENOMEM;
+	for (size_t i = 0; i < n; i++)
+	{
+		e[i].sv = arr[i];
+		e[i].key = sv__sort_key(arr[i], 0);
+	}
+	sv__sort_keys(e, n, 0);
+	for (size_t i = 0; i < n; i++)
+		arr[i] = e[i].sv;
+	free(e);
+	return 0;
+}
+
+#define SV__EXTSORT_FANIN 64
+#define SV__EXTSORT_MIN_BUFFER 4096
+#define SV__EXTSORT_FLUSH (1 << 20)
+
+typedef struct sv__extsort
+{
+	char delim;
+	const char *tmp_dir;
+	sv_key_callback key;
+	void *key_ctx;
+} sv__extsort;
+
+/* One run buffer: whole records from the input, sorted and written to fd
+(an unlinked temporary) or straight to out_fd when the input fit in it. */
+typedef struct sv__extsort_run
+{
+	const sv__extsort *sort;
+	char *buffer;
+	size_t capacity; /* one more byte is allocated for a final delimiter */
+	size_t len;
+	StringView *keys;
+	size_t key_capacity;
+	int fd;
+	int out_fd;
+	int error;
+} sv__extsort_run;
+
+typedef struct sv__extsort_source
+{
+	sv_reader reader;
+	StringView record;
+	StringView key;
+	bool done;
+} sv__extsort_source;
+
+static StringView sv__extsort_key(const sv__extsort *sort, StringView record)
+{
+	if (sort->key == NULL)
+		return record;
+	StringView key = sort->key(record, sort->key_ctx);
+	/*The record is found again from its key after sorting, so a key that is
+	not inside the record falls back to the whole record.*/
+	if (key.data < record.data || key.data > record.data + record.len ||
+		key.len > (size_t)(record.data + record.len - key.data))
+		return record;
+	return key;
+}
+
+#ifdef SV_POSIX
+static int sv__write_all(int fd, const char *data, size_t len)
+{
+	while (len)
+	{
+		ssize_t put = write(fd, data, len);
+		if (put < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return errno;
+		}
+		data += put;
+		len -= put;
+	}
+	return 0;
+}
+
+static int sv__extsort_emit(sv_builder *out, int fd, StringView record, char delim)
+{
+	sv_builder_append_sv(out, record);
+	sv_builder_append_char(out, delim);
+	if (out->error || out->len < SV__EXTSORT_FLUSH)
+		return out->error;
+	int err = sv__write_all(fd, sv__builder_data(out), out->len);
+	sv_builder_clear(out);
+	return err;
+}
+
+static int sv__extsort_tmpfile(const sv__extsort *sort, int *fd)
+{
+	sv_builder path;
+	sv_builder_init(&path);
+	sv_builder_append_sv(&path, sv_from_cstr((char *)sort->tmp_dir));
+	sv_builder_append_sv(&path, StringViewFromStr("/sv_extsort.XXXXXX"));
+	if (path.error)
+		return path.error;
+	int err = 0;
+#ifdef SV__HAS_MKSTEMP
+	*fd = mkstemp(sv__builder_data(&path));
+	if (*fd < 0)
+		err = errno;
+	else
+		unlink(sv__builder_data(&path));
+#else
+	*fd = -1;
+	err = ENOSYS;
+#endif
+	sv_builder_free(&path);
+	return err;
+}
+
+static int sv__extsort_fill(int fd, sv__extsort_run *run, bool *eof, size_t *carry)
+{
+	/*Reads until the buffer is full and cuts after its last delimiter; the
+	partial record behind it stays in the buffer for the next run to take.
+	A buffer without any delimiter grows, so one record always fits.*/
+	char delim = run->sort->delim;
+	for (;;)
+	{
+		while (run->len < run->capacity)
+		{
+			ssize_t got = read(fd, run->buffer + run->len, run->capacity - run->len);
+			if (got > 0)
+				run->len += got;
+			else if (got == 0)
+			{
+				*eof = true;
+				*carry = 0;
+				if (run->len && run->buffer[run->len - 1] != delim)
+					run->buffer[run->len++] = delim;
+				return 0;
+			}
+			else if (errno != EINTR)
+				return errno;
+		}
+		const char *last = sv__kernels.rfind_char(run->buffer, run->len, delim);
+		if (last != NULL)
+		{
+			*carry = run->buffer + run->len - last - 1;
+			run->len -= *carry;
+			return 0;
+		}
+		char *grown = realloc(run->buffer, run->capacity * 2 + 1);
+		if (grown == NULL)
+			return ENOMEM;
+		run->buffer = grown;
+		run->capacity *= 2;
+	}
+}
+
+static StringView sv__extsort_record(const sv__extsort_run *run, StringView key)
+{
+	/*Every record in the buffer ends with the delimiter and the key lies
+	inside its record, so the nearest delimiters around it bound the record.*/
+	if (run->sort->key == NULL)
+		return key;
+	char delim = run->sort->delim;
+	const char *before = sv__kernels.rfind_char(run->buffer, key.data - run->buffer, delim);
+	const char *start = before ? before + 1 : run->buffer;
+	const char *stop = sv__kernels.find_char(key.data, run->buffer + run->len - key.data, delim);
+	StringView record = {.data = start, .len = stop - start};
+	return record;
+}
+
+static void *sv__extsort_spill(void *arg)
+{
+	sv__extsort_run *run = arg;
+	const sv__extsort *sort = run->sort;
+	StringView rest = {.data = run->buffer, .len = run->len};
+	size_t count = 0;
+	while (rest.len)
+	{
+		StringView record = sv_split_left(&rest, sort->delim);
+		if (count == run->key_capacity)
+		{
+			size_t capacity = run->key_capacity ? run->key_capacity * 2 : 1024;
+			StringView *grown = realloc(run->keys, capacity * sizeof(StringView));
+			if (grown == NULL)
+			{
+				run->error = ENOMEM;
+				return NULL;
+			}
+			run->keys = grown;
+			run->key_capacity = capacity;
+		}
+		run->keys[count++] = sv__extsort_key(sort, record);
+	}
+
+	run->error = sv_sort(run->keys, count);
+	int fd = run->out_fd;
+	if (!run->error && fd < 0)
+	{
+		run->error = sv__extsort_tmpfile(sort, &run->fd);
+		fd = run->fd;
+	}
+	if (run->error)
+		return NULL;
+
+	sv_builder out;
+	sv_builder_init(&out);
+	for (size_t i = 0; i < count && !run->error; i++)
+		run->error = sv__extsort_emit(&out, fd, sv__extsort_record(run, run->keys[i]), sort->delim);
+	if (!run->error)
+		run->error = sv__write_all(fd, sv__builder_data(&out), out.len);
+	sv_builder_free(&out);
+	return NULL;
+}
+
+static bool sv__extsort_less(const sv__extsort_source *sources, size_t k, size_t a, size_t b)
+{
+	/*Index k is the virtual smallest entry used while the tree is built;
+	exhausted sources are larger than everything.*/
+	if (a == k || b == k)
+		return a == k;
+	if (sources[a].done || sources[b].done)
+		return !sources[a].done;
+	int res = sv_cmp(sources[a].key, sources[b].key);
+	return res < 0 || (res == 0 && a < b);
+}
+
+static void sv__extsort_replay(size_t *tree, const sv__extsort_source *sources, size_t k, size_t s)
+{
+	/*Plays s up from its leaf: every node keeps the loser, the winner moves
+	on, and tree[0] ends up holding the overall winner.*/
+	for (size_t t = (s + k) / 2; t > 0; t /= 2)
+	{
+		if (sv__extsort_less(sources, k, tree[t], s))
+		{
+			size_t winner = tree[t];
+			tree[t] = s;
+			s = winner;
+		}
+	}
+	tree[0] = s;
+}
+
+static void sv__extsort_advance(const sv__extsort *sort, sv__extsort_source *source)
+{
+	source->record = sv_reader_next(&source->reader, sort->delim);
+	source->done = source->record.data == NULL;
+	if (!source->done)
+		source->key = sv__extsort_key(sort, source->record);
+}
+
+static int sv__extsort_merge(const sv__extsort *sort, const int *fds, size_t k, int out_fd, size_t memory)
+{
+	sv__extsort_source *sources = calloc(k, sizeof(sv__extsort_source));
+	size_t *tree = malloc(k * sizeof(size_t));
+	size_t capacity = memory / (k + 1);
+	if (capacity < SV__EXTSORT_MIN_BUFFER)
+		capacity = SV__EXTSORT_MIN_BUFFER;
+
+	int err = sources && tree ? 0 : ENOMEM;
+	size_t opened = 0;
+	for (; !err && opened < k; opened++)
+	{
+		if (lseek(fds[opened], 0, SEEK_SET) < 0)
+			err = errno;
+		else if ((err = sv_reader_init(&sources[opened].reader, fds[opened], capacity)) == 0)
+			sv__extsort_advance(sort, &sources[opened]);
+		err = err ? err : sources[opened].reader.error;
+	}
+
+	sv_builder out;
+	sv_builder_init(&out);
+	if (!err)
+	{
+		for (size_t i = 0; i < k; i++)
+			tree[i] = k;
+		for (size_t i = k; i-- > 0;)
+			sv__extsort_replay(tree, sources, k, i);
+		for (size_t w = tree[0]; !err && !sources[w].done; w = tree[0])
+		{
+			err = sv__extsort_emit(&out, out_fd, sources[w].record, sort->delim);
+			sv__extsort_advance(sort, &sources[w]);
+			err = err ? err : sources[w].reader.error;
+			sv__extsort_replay(tree, sources, k, w);
+		}
+		if (!err)
+			err = sv__write_all(out_fd, sv__builder_data(&out), out.len);
+	}
+	sv_builder_free(&out);
+
+	for (size_t i = 0; sources && i < opened; i++)
+		sv_reader_free(&sources[i].reader);
+	free(sources);
+	free(tree);
+	return err;
+}
+#endif
+
+SVDEF int sv_extsort(int in_fd, int out_fd, char delim, const sv_extsort_options *options)
+{
+#ifdef SV_POSIX
+	sv_extsort_options opt = {0};
+	if (options)
+		opt = *options;
+	if (opt.memory == 0)
+		opt.memory = (size_t)256 << 20;
+	if (opt.nthreads == 0)
+	{
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		opt.nthreads = cpus > 0 ? (size_t)cpus : 1;
+	}
+	if (opt.tmp_dir == NULL || opt.tmp_dir[0] == '\0')
+		opt.tmp_dir = getenv("TMPDIR");
+	if (opt.tmp_dir == NULL || opt.tmp_dir[0] == '\0')
+		opt.tmp_dir = "/tmp";
+	size_t slot_capacity = opt.memory / opt.nthreads;
+	if (slot_capacity < SV__EXTSORT_MIN_BUFFER)
+		slot_capacity = SV__EXTSORT_MIN_BUFFER;
+
+	sv__extsort sort = {.delim = delim, .tmp_dir = opt.tmp_dir, .key = opt.key, .key_ctx = opt.key_ctx};
+	sv__extsort_run *slots = calloc(opt.nthreads, sizeof(sv__extsort_run));
+	pthread_t *threads = malloc(opt.nthreads * sizeof(pthread_t));
+	int *fds = NULL;
+	size_t fd_count = 0, fd_capacity = 0;
+	int err = slots && threads ? 0 : ENOMEM;
+
+	// Run generation: the calling thread fills up to nthreads buffers, then
+	// they are sorted and spilled in parallel while reading waits.
+	bool eof = false;
+	size_t carry = 0;
+	const char *carry_from = NULL;
+	while (!eof && !err)
+	{
+		size_t used = 0;
+		for (; used < opt.nthreads && !eof && !err; used++)
+		{
+			sv__extsort_run *run = &slots[used];
+			run->sort = &sort;
+			run->len = 0;
+			run->fd = -1;
+			run->out_fd = -1;
+			if (run->buffer == NULL)
+			{
+				run->buffer = malloc(slot_capacity + 1);
+				run->capacity = slot_capacity;
+			}
+			while (run->buffer && carry >= run->capacity)
+			{
+				char *grown = realloc(run->buffer, run->capacity * 2 + 1);
+				if (grown == NULL)
+					free(run->buffer);
+				run->buffer = grown;
+				run->capacity *= 2;
+			}
+			if (run->buffer == NULL)
+			{
+				err = ENOMEM;
+				break;
+			}
+			if (carry)
+				memmove(run->buffer, carry_from, carry);
+			run->len = carry;
+			err = sv__extsort_fill(in_fd, run, &eof, &carry);
+			carry_from = run->buffer + run->len;
+		}
+		if (err)
+			break;
+
+		if (eof && used == 1 && fd_count == 0)
+			slots[0].out_fd = out_fd;
+		size_t started = 0;
+		for (size_t i = 1; i < used; i++)
+		{
+			// A thread that cannot be created has its run sorted inline below.
+			if (pthread_create(&threads[started], NULL, sv__extsort_spill, &slots[i]) != 0)
+				break;
+			started++;
+		}
+		sv__extsort_spill(&slots[0]);
+		for (size_t i = 1 + started; i < used; i++)
+			sv__extsort_spill(&slots[i]);
+		for (size_t i = 0; i < started; i++)
+			pthread_join(threads[i], NULL);
+
+		for (size_t i = 0; i < used; i++)
+		{
+			err = err ? err : slots[i].error;
+			if (slots[i].fd < 0)
+				continue;
+			if (fd_count == fd_capacity)
+			{
+				size_t capacity = fd_capacity ? fd_capacity * 2 : 64;
+				int *grown = realloc(fds, capacity * sizeof(int));
+				if (grown == NULL)
+				{
+					close(slots[i].fd);
+					err = ENOMEM;
+					continue;
+				}
+				fds = grown;
+				fd_capacity = capacity;
+			}
+			fds[fd_count++] = slots[i].fd;
+		}
+	}
+	for (size_t i = 0; slots && i < opt.nthreads; i++)
+	{
+		free(slots[i].buffer);
+		free(slots[i].keys);
+	}
+	free(slots);
+	free(threads);
+
+	// Merge passes: while there are more runs than the fan-in, merge the
+	// oldest ones into a new run at the end of the list.
+	while (!err && fd_count > SV__EXTSORT_FANIN)
+	{
+		int fd;
+		err = sv__extsort_tmpfile(&sort, &fd);
+		if (err)
+			break;
+		err = sv__extsort_merge(&sort, fds, SV__EXTSORT_FANIN, fd, opt.memory);
+		for (size_t i = 0; i < SV__EXTSORT_FANIN; i++)
+			close(fds[i]);
+		fd_count -= SV__EXTSORT_FANIN;
+		memmove(fds, fds + SV__EXTSORT_FANIN, fd_count * sizeof(int));
+		fds[fd_count++] = fd;
+	}
+	if (!err && fd_count > 0)
+		err = sv__extsort_merge(&sort, fds, fd_count, out_fd, opt.memory);
+
+	for (size_t i = 0; i < fd_count; i++)
+		close(fds[i]);
+	free(fds);
+	return err;
+#else
+	(void)in_fd;
+	(void)out_fd;
+	(void)delim;
+	(void)options;
+	return ENOSYS;
+#endif
+}
+
+SVDEF bool sv_compare_icase(StringView sv, StringView sv_other)
+{
+	return sv.len == sv_other.len && sv__kernels.equal_icase(sv.data, sv_other.data, sv.len);
+}
+
+SVDEF bool sv_starts_with_icase(StringView sv, StringView sv_other)
+{
+	return sv.len >= sv_other.len && sv__kernels.equal_icase(sv.data, sv_other.data, sv_other.len);
+}
+
+SVDEF bool sv_ends_with_icase(StringView sv, StringView sv_other)
+{
+	return sv.len >= sv_other.len &&
+		   sv__kernels.equal_icase(sv.data + sv.len - sv_other.len, sv_other.data, sv_other.len);
+}
+
+SVDEF StringView sv_to_lower_into(StringView sv, char *out)
+{
+	sv__kernels.flip_case(sv.data, sv.len, out, 'A');
+	StringView result = {.data = out, .len = sv.len};
+	return result;
+}
+
+SVDEF StringView sv_to_upper_into(StringView sv, char *out)
+{
+	sv__kernels.flip_case(sv.data, sv.len, out, 'a');
+	StringView result = {.data = out, .len = sv.len};
+	return result;
+}
+
+SVDEF StringView sv_translate_into(StringView sv, const unsigned char map[256], char *out)
+{
+	sv__kernels.translate(sv.data, sv.len, out, map);
+	StringView result = {.data = out, .len = sv.len};
+	return result;
+}
+
+SVDEF StringView sv_squeeze_into(StringView sv, const sv_charset *set, char replacement, char *out)
+{
+	StringView result = {.data = out, .len = sv__kernels.squeeze(sv.data, sv.len, out, set, replacement)};
+	return result;
+}
+
+SVDEF bool sv_utf8_validate(StringView sv, size_t *error_offset)
+{
+	size_t valid = sv__kernels.utf8_valid(sv.data, sv.len);
+	if (error_offset)
+		*error_offset = valid;
+	return valid == sv.len;
+}
+
+SVDEF void sv_utf8_validator_init(sv_utf8_validator *validator)
+{
+	memset(validator, 0, sizeof(*validator));
+}
+
+static bool sv__utf8_validator_fail(sv_utf8_validator *validator, size_t offset)
+{
+	validator->failed = true;
+	validator->error_offset = offset;
+	return false;
+}
+
+SVDEF bool sv_utf8_validator_feed(sv_utf8_validator *validator, StringView chunk)
+{
+	/*Returns false as soon as the stream is known to be invalid, and from then
+	on. The carried sequence is completed first, the chunk is validated up to
+	its last complete sequence, and what is left is carried again.*/
+	if (validator->failed)
+		return false;
+	size_t start = validator->offset;
+	validator->offset += chunk.len;
+	size_t i = 0;
+	if (validator->pending_len)
+	{
+		size_t carried = validator->pending_len;
+		size_t need = sv__utf8_sequence_len(validator->pending[0]);
+		while (validator->pending_len < need && i < chunk.len)
+			validator->pending[validator->pending_len++] = chunk.data[i++];
+		if (validator->pending_len < need)
+			return true;
+		if (sv__utf8_valid_scalar((const char *)validator->pending, need) != need)
+			return sv__utf8_validator_fail(validator, start - carried);
+		validator->pending_len = 0;
+	}
+
+	const char *rest = chunk.data + i;
+	size_t len = chunk.len - i, tail = 0;
+	for (size_t k = 1; k <= 3 && k <= len; k++)
+	{
+		unsigned char c = (unsigned char)rest[len - k];
+		if ((c & 0xC0) != 0x80)
+		{
+			if (sv__utf8_sequence_len(c) > k)
+				tail = k;
+			break;
+		}
+	}
+	size_t valid = sv__kernels.utf8_valid(rest, len - tail);
+	if (valid != len - tail)
+		return sv__utf8_validator_fail(validator, start + i + valid);
+	if (tail)
+		memcpy(validator->pending, rest + len - tail, tail);
+	validator->pending_len = tail;
+	return true;
+}
+
+SVDEF bool sv_utf8_validator_finish(sv_utf8_validator *validator)
+{
+	/*End of stream: a sequence still being carried is truncated.*/
+	if (!validator->failed && validator->pending_len)
+		sv__utf8_validator_fail(validator, validator->offset - validator->pending_len);
+	return !validator->failed;
+}
+
 #endif
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "sv.h"
 #include "rktest.h"
+#include <ctype.h>
+#include <float.h>
+#include <math.h>
 #include <stdint.h>
+#include <unistd.h>
 
 // CREATION
 
@@ -38,6 +42,23 @@ TEST(utility_tests, read_file_cstr)
     free(text);
 }
 
+TEST(utility_tests, sv_map_file)
+{
+    sv_mapped_file file;
+    ASSERT_EQ(sv_map_file("./tests/test_files/utility_test_file.txt", SV_MAP_POPULATE | SV_MAP_SEQUENTIAL, &file), 0);
+    EXPECT_TRUE(sv_compare(file.view, StringViewFromStr("test text")));
+    EXPECT_EQ(sv_unmap_file(&file), 0);
+    EXPECT_EQ(file.view.len, 0);
+}
+
+TEST(utility_tests, sv_map_file__missing_file)
+{
+    sv_mapped_file file;
+    EXPECT_EQ(sv_map_file("./tests/test_files/does_not_exist.txt", 0, &file), ENOENT);
+    EXPECT_TRUE(file.view.data == NULL);
+    EXPECT_EQ(sv_unmap_file(&file), 0);
+}
+
 TEST(utility_tests, macro_StringViewFromStr)
 {
     char *test_str = "something";
@@ -914,4 +935,2137 @@ TEST(strips_tests, sv_strip_right__null)
 
     EXPECT_EQ(count, 0);
     EXPECT_TRUE(sv_compare(test_sv, StringViewNull));
+}
+// SIMD KERNELS
+
+// Runs the statement that follows once per SIMD level the CPU supports, with
+// that level selected, and restores the level that was active before.
+#define FOR_EACH_SIMD_LEVEL(level)                                                                          \
+    for (int level = SV_SIMD_SCALAR, level##_saved_ = sv_simd_get(), level##_best_ = sv_simd_detect();    \
+         level <= level##_best_ ? (sv_simd_set(level), 1) : (sv_simd_set(level##_saved_), 0); level++)
+
+TEST(simd_tests, sv_simd_set__clamps_to_cpu)
+{
+    sv_simd_level best = sv_simd_detect();
+    EXPECT_EQ(sv_simd_set(SV_SIMD_AVX512), best);
+    EXPECT_EQ(sv_simd_get(), best);
+    EXPECT_EQ(sv_simd_set(SV_SIMD_SCALAR), SV_SIMD_SCALAR);
+    sv_simd_set(best);
+}
+
+TEST(simd_tests, sv_find_left_char__matches_scalar_on_all_levels)
+{
+    char buffer[300];
+    srand(1);
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        for (size_t len = 0; len < sizeof(buffer); len++)
+        {
+            for (size_t i = 0; i < len; i++)
+                buffer[i] = 'a' + rand() % 4;
+            if (len > 0 && rand() % 2)
+                buffer[rand() % len] = ',';
+
+            StringView test_sv = sv_construct(buffer, len);
+            EXPECT_EQ_INFO(sv_find_left_char(&test_sv, ','), sv_find_left_char_scalar(&test_sv, ','),
+                           "level %d len %zu", level, len);
+            EXPECT_EQ_INFO(sv_find_left_char(&test_sv, 'd'), sv_find_left_char_scalar(&test_sv, 'd'),
+                           "level %d len %zu", level, len);
+        }
+    }
+}
+
+TEST(simd_tests, sv_split_left__long_line)
+{
+    char buffer[200];
+    memset(buffer, 'x', sizeof(buffer));
+    buffer[150] = '\n';
+    StringView test_sv = sv_construct(buffer, sizeof(buffer));
+
+    StringView left = sv_split_left(&test_sv, '\n');
+
+    EXPECT_EQ(left.len, 150);
+    EXPECT_EQ(test_sv.len, 49);
+    EXPECT_TRUE(test_sv.data == buffer + 151);
+}
+
+TEST(simd_tests, sv_find_right_char__matches_scalar_on_all_levels)
+{
+    char buffer[300];
+    srand(2);
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        for (size_t len = 0; len < sizeof(buffer); len++)
+        {
+            for (size_t i = 0; i < len; i++)
+                buffer[i] = 'a' + rand() % 4;
+            if (len > 0 && rand() % 2)
+                buffer[rand() % len] = '.';
+
+            StringView test_sv = sv_construct(buffer, len);
+            EXPECT_EQ_INFO(sv_find_right_char(&test_sv, '.'), sv_find_right_char_scalar(&test_sv, '.'),
+                           "level %d len %zu", level, len);
+            EXPECT_EQ_INFO(sv_find_right_char(&test_sv, 'd'), sv_find_right_char_scalar(&test_sv, 'd'),
+                           "level %d len %zu", level, len);
+        }
+    }
+}
+
+TEST(simd_tests, sv_split_right__long_line)
+{
+    char buffer[200];
+    memset(buffer, 'x', sizeof(buffer));
+    buffer[3] = '/';
+    StringView test_sv = sv_construct(buffer, sizeof(buffer));
+
+    StringView right = sv_split_right(&test_sv, '/');
+
+    EXPECT_EQ(right.len, 196);
+    EXPECT_EQ(test_sv.len, 3);
+    EXPECT_TRUE(right.data == buffer + 4);
+}
+
+// CHARSETS
+
+TEST(charset_tests, sv_charset_has__all_byte_values)
+{
+    sv_charset set = sv_charset_from_cstr(",;\t|");
+    sv_charset_add(&set, (char)0x80);
+    sv_charset_add(&set, (char)0xFF);
+    for (int b = 0; b < 256; b++)
+    {
+        bool expected = b == ',' || b == ';' || b == '\t' || b == '|' || b == 0x80 || b == 0xFF;
+        EXPECT_TRUE_INFO(sv_charset_has(&set, (char)b) == expected, "byte %d", b);
+    }
+}
+
+TEST(charset_tests, sv_split_left_any__mixed_delimiters)
+{
+    StringView test_sv = StringViewFromStr("a,b;c\td|e");
+    sv_charset set = sv_charset_from_cstr(",;\t|");
+
+    EXPECT_TRUE(sv_compare(sv_split_left_any(&test_sv, &set), StringViewFromStr("a")));
+    EXPECT_TRUE(sv_compare(sv_split_left_any(&test_sv, &set), StringViewFromStr("b")));
+    EXPECT_TRUE(sv_compare(sv_split_left_any(&test_sv, &set), StringViewFromStr("c")));
+    EXPECT_TRUE(sv_compare(sv_split_left_any(&test_sv, &set), StringViewFromStr("d")));
+    EXPECT_TRUE(sv_compare(test_sv, StringViewFromStr("e")));
+}
+
+TEST(charset_tests, sv_split_right_any__mixed_delimiters)
+{
+    StringView test_sv = StringViewFromStr("usr/lib\\file.tar");
+    sv_charset set = sv_charset_from_cstr("/\\.");
+
+    EXPECT_TRUE(sv_compare(sv_split_right_any(&test_sv, &set), StringViewFromStr("tar")));
+    EXPECT_TRUE(sv_compare(sv_split_right_any(&test_sv, &set), StringViewFromStr("file")));
+    EXPECT_TRUE(sv_compare(sv_split_right_any(&test_sv, &set), StringViewFromStr("lib")));
+    EXPECT_TRUE(sv_compare(test_sv, StringViewFromStr("usr")));
+    EXPECT_EQ(sv_split_right_any(&test_sv, &set).len, 0);
+}
+
+TEST(charset_tests, sv_find_any__matches_scalar_on_all_levels)
+{
+    unsigned char buffer[300];
+    sv_charset set = sv_charset_from_cstr(",;\t|");
+    sv_charset_add(&set, (char)0xC3);
+    srand(3);
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        for (size_t len = 0; len < sizeof(buffer); len++)
+        {
+            for (size_t i = 0; i < len; i++)
+            {
+                buffer[i] = rand() % 256;
+                if (sv_charset_has(&set, buffer[i]) && rand() % 8)
+                    buffer[i] = 'x';
+            }
+
+            StringView test_sv = sv_construct((char *)buffer, len);
+            int left = -1, right = -1;
+            for (size_t i = 0; i < len; i++)
+            {
+                if (sv_charset_has(&set, buffer[i]))
+                {
+                    if (left < 0)
+                        left = i;
+                    right = i;
+                }
+            }
+            EXPECT_EQ_INFO(sv_find_left_any(&test_sv, &set), left, "level %d len %zu", level, len);
+            EXPECT_EQ_INFO(sv_find_right_any(&test_sv, &set), right, "level %d len %zu", level, len);
+        }
+    }
+}
+
+// LINE INDEX
+
+TEST(line_index_tests, sv_line_index_line__crlf_and_empty_lines)
+{
+    sv_line_index index;
+    ASSERT_EQ(sv_line_index_build(&index, StringViewFromStr("a\r\nbb\n\nccc\r\n")), 0);
+
+    EXPECT_EQ(index.line_count, 4);
+    EXPECT_TRUE(sv_compare(sv_line_index_line(&index, 0), StringViewFromStr("a")));
+    EXPECT_TRUE(sv_compare(sv_line_index_line(&index, 1), StringViewFromStr("bb")));
+    EXPECT_TRUE(sv_compare(sv_line_index_line(&index, 2), StringViewFromStr("")));
+    EXPECT_TRUE(sv_compare(sv_line_index_line(&index, 3), StringViewFromStr("ccc")));
+    EXPECT_TRUE(sv_line_index_line(&index, 4).data == NULL);
+    sv_line_index_free(&index);
+}
+
+TEST(line_index_tests, sv_line_index_line__no_trailing_newline)
+{
+    sv_line_index index;
+    ASSERT_EQ(sv_line_index_build(&index, StringViewFromStr("one\ntwo")), 0);
+
+    EXPECT_EQ(index.line_count, 2);
+    EXPECT_TRUE(sv_compare(sv_line_index_line(&index, 1), StringViewFromStr("two")));
+    sv_line_index_free(&index);
+}
+
+TEST(line_index_tests, sv_line_index_build__empty)
+{
+    sv_line_index index;
+    ASSERT_EQ(sv_line_index_build(&index, StringViewNull), 0);
+
+    EXPECT_EQ(index.line_count, 0);
+    EXPECT_TRUE(sv_line_index_line(&index, 0).data == NULL);
+    sv_line_index_free(&index);
+}
+
+TEST(line_index_tests, sv_line_index_locate__matches_split_walk)
+{
+    char buffer[1000];
+    srand(4);
+    for (size_t i = 0; i < sizeof(buffer); i++)
+        buffer[i] = rand() % 10 ? 'a' + rand() % 26 : '\n';
+    StringView text = sv_construct(buffer, sizeof(buffer));
+
+    sv_line_index index;
+    ASSERT_EQ(sv_line_index_build(&index, text), 0);
+
+    size_t line = 0, column = 0;
+    for (size_t i = 0; i < text.len; i++)
+    {
+        sv_line_pos pos;
+        ASSERT_TRUE(sv_line_index_locate(&index, text.data + i, &pos));
+        EXPECT_EQ_INFO(pos.line, line, "offset %zu", i);
+        EXPECT_EQ_INFO(pos.column, column, "offset %zu", i);
+        column++;
+        if (buffer[i] == '\n')
+        {
+            line++;
+            column = 0;
+        }
+    }
+
+    StringView walk = text;
+    for (size_t k = 0; k < index.line_count; k++)
+    {
+        StringView expected = sv_split_left(&walk, '\n');
+        EXPECT_TRUE_INFO(sv_compare(sv_line_index_line(&index, k), expected), "line %zu", k);
+    }
+
+    sv_line_pos pos;
+    EXPECT_FALSE(sv_line_index_locate(&index, text.data + text.len + 1, &pos));
+    sv_line_index_free(&index);
+}
+
+TEST(line_index_tests, sv_line_index_build__same_on_all_levels)
+{
+    char buffer[777];
+    srand(5);
+    for (size_t i = 0; i < sizeof(buffer); i++)
+        buffer[i] = rand() % 7 ? 'x' : '\n';
+    size_t newlines = 0;
+    for (size_t i = 0; i < sizeof(buffer) - 1; i++)
+        newlines += buffer[i] == '\n';
+
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        sv_line_index index;
+        ASSERT_EQ(sv_line_index_build(&index, sv_construct(buffer, sizeof(buffer))), 0);
+        EXPECT_EQ_INFO(index.line_count, newlines + 1, "level %d", level);
+        for (size_t k = 1; k < index.line_count; k++)
+            EXPECT_CHAR_EQ(buffer[index.line_starts[k] - 1], '\n');
+        sv_line_index_free(&index);
+    }
+}
+
+// READER
+
+TEST(reader_tests, sv_reader_next__carries_partial_records)
+{
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    const char *input = "alpha\nbeta\n\na much longer record than the buffer\ngamma";
+    ASSERT_EQ(write(fds[1], input, strlen(input)), strlen(input));
+    close(fds[1]);
+
+    sv_reader reader;
+    ASSERT_EQ(sv_reader_init(&reader, fds[0], 8), 0);
+    EXPECT_TRUE(sv_compare(sv_reader_next(&reader, '\n'), StringViewFromStr("alpha")));
+    EXPECT_TRUE(sv_compare(sv_reader_next(&reader, '\n'), StringViewFromStr("beta")));
+    StringView empty = sv_reader_next(&reader, '\n');
+    EXPECT_TRUE(empty.data != NULL);
+    EXPECT_EQ(empty.len, 0);
+    EXPECT_TRUE(sv_compare(sv_reader_next(&reader, '\n'), StringViewFromStr("a much longer record than the buffer")));
+    EXPECT_TRUE(sv_compare(sv_reader_next(&reader, '\n'), StringViewFromStr("gamma")));
+    EXPECT_TRUE(sv_reader_next(&reader, '\n').data == NULL);
+    EXPECT_TRUE(sv_reader_next(&reader, '\n').data == NULL);
+    EXPECT_EQ(reader.error, 0);
+
+    sv_reader_free(&reader);
+    close(fds[0]);
+}
+
+TEST(reader_tests, sv_reader_next__matches_split_left)
+{
+    FILE *f = tmpfile();
+    ASSERT_TRUE(f != NULL);
+    srand(6);
+    for (int i = 0; i < 5000; i++)
+    {
+        int len = rand() % 40;
+        for (int j = 0; j < len; j++)
+            fputc('a' + rand() % 26, f);
+        fputc('\n', f);
+    }
+    fflush(f);
+    long size = ftell(f);
+    char *text = malloc(size);
+    ASSERT_EQ(lseek(fileno(f), 0, SEEK_SET), 0);
+    ASSERT_EQ(read(fileno(f), text, size), size);
+    ASSERT_EQ(lseek(fileno(f), 0, SEEK_SET), 0);
+
+    sv_reader reader;
+    ASSERT_EQ(sv_reader_init(&reader, fileno(f), 256), 0);
+    StringView expected_sv = sv_construct(text, size);
+    size_t records = 0;
+    for (StringView record = sv_reader_next(&reader, '\n'); record.data; record = sv_reader_next(&reader, '\n'))
+    {
+        StringView expected = sv_split_left(&expected_sv, '\n');
+        EXPECT_TRUE_INFO(sv_compare(record, expected), "record %zu", records);
+        records++;
+    }
+    EXPECT_EQ(records, 5000);
+    EXPECT_EQ(reader.capacity, 256);
+
+    sv_reader_free(&reader);
+    free(text);
+    fclose(f);
+}
+
+// PARALLEL
+
+typedef struct
+{
+    size_t records;
+    size_t bytes;
+} _record_totals;
+
+void *_totals_init(void *ctx)
+{
+    (void)ctx;
+    return calloc(1, sizeof(_record_totals));
+}
+
+void _totals_count(StringView record, void *local, void *ctx)
+{
+    (void)ctx;
+    _record_totals *totals = local;
+    totals->records += 1;
+    totals->bytes += record.len;
+}
+
+void _totals_reduce(void *local, void *ctx)
+{
+    _record_totals *totals = local;
+    _record_totals *sum = ctx;
+    sum->records += totals->records;
+    sum->bytes += totals->bytes;
+    free(totals);
+}
+
+TEST(parallel_tests, sv_parallel_for_each_record_reduce__matches_split_left)
+{
+    size_t size = 3 * 1024 * 1024;
+    char *buffer = malloc(size);
+    srand(7);
+    for (size_t i = 0; i < size; i++)
+        buffer[i] = rand() % 50 ? 'a' : '\n';
+    buffer[size - 1] = 'z';
+
+    _record_totals expected = {0};
+    StringView walk = sv_construct(buffer, size);
+    while (walk.len)
+    {
+        int n = sv_find_left_char(&walk, '\n');
+        if (n < 0)
+        {
+            expected.records += 1;
+            expected.bytes += walk.len;
+            break;
+        }
+        StringView record = sv_split_left(&walk, '\n');
+        expected.records += 1;
+        expected.bytes += record.len;
+    }
+
+    sv_parallel_hooks hooks = {.thread_init = _totals_init, .thread_reduce = _totals_reduce};
+    for (size_t threads = 1; threads <= 4; threads++)
+    {
+        _record_totals sum = {0};
+        EXPECT_EQ(sv_parallel_for_each_record_reduce(sv_construct(buffer, size), '\n', threads, _totals_count, &hooks, &sum), 0);
+        EXPECT_LONG_EQ_INFO(sum.records, expected.records, "threads %zu", threads);
+        EXPECT_LONG_EQ_INFO(sum.bytes, expected.bytes, "threads %zu", threads);
+    }
+    free(buffer);
+}
+
+void _count_record(StringView record, void *local, void *ctx)
+{
+    (void)record;
+    (void)local;
+    (*(size_t *)ctx)++;
+}
+
+TEST(parallel_tests, sv_parallel_for_each_record__small_buffers)
+{
+    size_t count = 0;
+    EXPECT_EQ(sv_parallel_for_each_record(StringViewFromStr("a\nb\n\nc\n"), '\n', 4, _count_record, &count), 0);
+    EXPECT_EQ(count, 4);
+
+    count = 0;
+    EXPECT_EQ(sv_parallel_for_each_record(StringViewNull, '\n', 4, _count_record, &count), 0);
+    EXPECT_EQ(count, 0);
+}
+
+// SUBSTRING SEARCH
+
+int _brute_find(const char *h, size_t n, const char *x, size_t m, bool last)
+{
+    int found = -1;
+    for (size_t i = 0; i + m <= n; i++)
+    {
+        if (memcmp(h + i, x, m) == 0)
+        {
+            found = i;
+            if (!last)
+                break;
+        }
+    }
+    return found;
+}
+
+TEST(search_tests, sv_find_left_sv__basic)
+{
+    StringView test_sv = StringViewFromStr("key::value::rest");
+
+    EXPECT_EQ(sv_find_left_sv(&test_sv, StringViewFromStr("::")), 3);
+    EXPECT_EQ(sv_find_right_sv(&test_sv, StringViewFromStr("::")), 10);
+    EXPECT_EQ(sv_find_left_sv(&test_sv, StringViewFromStr("rest")), 12);
+    EXPECT_EQ(sv_find_left_sv(&test_sv, StringViewFromStr("rests")), -1);
+    EXPECT_EQ(sv_find_left_sv(&test_sv, StringViewFromStr("")), 0);
+    EXPECT_EQ(sv_find_right_sv(&test_sv, StringViewFromStr("")), 16);
+}
+
+TEST(search_tests, sv_split_left_sv__multi_byte_delimiter)
+{
+    StringView test_sv = StringViewFromStr("GET / HTTP/1.1\r\nHost: x\r\n\r\nbody");
+
+    EXPECT_TRUE(sv_compare(sv_split_left_sv(&test_sv, StringViewFromStr("\r\n")), StringViewFromStr("GET / HTTP/1.1")));
+    EXPECT_TRUE(sv_compare(sv_split_left_sv(&test_sv, StringViewFromStr("\r\n")), StringViewFromStr("Host: x")));
+    EXPECT_TRUE(sv_compare(sv_split_left_sv(&test_sv, StringViewFromStr("\r\n")), StringViewFromStr("")));
+    EXPECT_TRUE(sv_compare(test_sv, StringViewFromStr("body")));
+    EXPECT_TRUE(sv_compare(sv_split_left_sv(&test_sv, StringViewFromStr("\r\n")), StringViewFromStr("body")));
+    EXPECT_TRUE(sv_compare(sv_split_left_sv(&test_sv, StringViewFromStr("o")), StringViewFromStr("b")));
+    EXPECT_TRUE(sv_compare(sv_split_left_sv(&test_sv, StringViewFromStr("dyx")), StringViewFromStr("dy")));
+    EXPECT_TRUE(sv_compare(test_sv, StringViewFromStr("dy")));
+}
+
+TEST(search_tests, sv_find_sv__matches_brute_force_on_all_levels)
+{
+    char haystack[400];
+    char needle[40];
+    srand(8);
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        for (int round = 0; round < 2000; round++)
+        {
+            size_t n = rand() % sizeof(haystack);
+            size_t m = 1 + rand() % (round % 4 == 0 ? sizeof(needle) : 6);
+            int alphabet = 2 + rand() % 3;
+            for (size_t i = 0; i < n; i++)
+                haystack[i] = 'a' + rand() % alphabet;
+            for (size_t i = 0; i < m; i++)
+                needle[i] = 'a' + rand() % alphabet;
+            if (n >= m && rand() % 2)
+                memcpy(haystack + rand() % (n - m + 1), needle, m);
+
+            StringView test_sv = sv_construct(haystack, n);
+            StringView needle_sv = sv_construct(needle, m);
+            EXPECT_EQ_INFO(sv_find_left_sv(&test_sv, needle_sv), _brute_find(haystack, n, needle, m, false),
+                           "level %d n %zu m %zu", level, n, m);
+            EXPECT_EQ_INFO(sv_find_right_sv(&test_sv, needle_sv), _brute_find(haystack, n, needle, m, true),
+                           "level %d n %zu m %zu", level, n, m);
+        }
+    }
+}
+
+TEST(search_tests, sv_find_sv__adversarial_input_falls_back)
+{
+    // Every offset passes the first/last byte filter and fails in the middle.
+    size_t n = 200000, m = 300;
+    char *haystack = malloc(n);
+    char *needle = malloc(m);
+    memset(needle, 'a', m);
+    needle[m / 2] = 'b';
+
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        StringView test_sv = sv_construct(haystack, n);
+
+        memset(haystack, 'a', n);
+        memcpy(haystack + n - m - 7, needle, m);
+        EXPECT_EQ_INFO(sv_find_left_sv(&test_sv, sv_construct(needle, m)), n - m - 7, "level %d", level);
+
+        memset(haystack, 'a', n);
+        memcpy(haystack + 5, needle, m);
+        EXPECT_EQ_INFO(sv_find_right_sv(&test_sv, sv_construct(needle, m)), 5, "level %d", level);
+
+        memset(haystack, 'a', n);
+        EXPECT_EQ_INFO(sv_find_left_sv(&test_sv, sv_construct(needle, m)), -1, "level %d", level);
+        EXPECT_EQ_INFO(sv_find_right_sv(&test_sv, sv_construct(needle, m)), -1, "level %d", level);
+    }
+    free(haystack);
+    free(needle);
+}
+
+TEST(search_tests, sv_searcher__all_needle_lengths_on_all_levels)
+{
+    char haystack[600];
+    char needle[40];
+    srand(9);
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        for (int round = 0; round < 1500; round++)
+        {
+            size_t n = rand() % sizeof(haystack);
+            size_t m = rand() % sizeof(needle);
+            int alphabet = 2 + rand() % 3;
+            for (size_t i = 0; i < n; i++)
+                haystack[i] = 'a' + rand() % alphabet;
+            for (size_t i = 0; i < m; i++)
+                needle[i] = 'a' + rand() % alphabet;
+            if (n >= m && rand() % 2)
+                memcpy(haystack + rand() % (n - m + 1), needle, m);
+
+            sv_searcher searcher;
+            sv_searcher_init(&searcher, sv_construct(needle, m));
+            int expected = m ? _brute_find(haystack, n, needle, m, false) : 0;
+            EXPECT_EQ_INFO(sv_searcher_find(&searcher, sv_construct(haystack, n)), expected,
+                           "level %d n %zu m %zu", level, n, m);
+
+            size_t count = 0;
+            for (size_t i = 0; m && i + m <= n;)
+            {
+                if (memcmp(haystack + i, needle, m) == 0)
+                {
+                    count++;
+                    i += m;
+                }
+                else
+                {
+                    i++;
+                }
+            }
+            EXPECT_EQ_INFO(sv_searcher_count(&searcher, sv_construct(haystack, n)), count,
+                           "level %d n %zu m %zu", level, n, m);
+        }
+    }
+}
+
+TEST(search_tests, sv_searcher_count__log_lines)
+{
+    sv_searcher searcher;
+    sv_searcher_init(&searcher, StringViewFromStr("ERROR"));
+    StringView log = StringViewFromStr("INFO ok\nERROR disk\nWARN x\nERROR net\nERRO\n");
+
+    EXPECT_EQ(sv_searcher_count(&searcher, log), 2);
+    EXPECT_EQ(sv_searcher_find(&searcher, log), 8);
+}
+
+// MULTI-PATTERN MATCHING
+
+typedef struct
+{
+    sv_match matches[64];
+    size_t count;
+} _match_list;
+
+bool _collect_match(sv_match match, void *ctx)
+{
+    _match_list *list = ctx;
+    if (list->count < 64)
+        list->matches[list->count] = match;
+    list->count++;
+    return true;
+}
+
+TEST(multimatch_tests, sv_multimatch_scan__all_matches)
+{
+    StringView patterns[] = {StringViewFromStr("he"), StringViewFromStr("she"), StringViewFromStr("his"),
+                             StringViewFromStr("hers")};
+    sv_multimatch mm;
+    ASSERT_EQ(sv_multimatch_build(&mm, patterns, 4), 0);
+
+    _match_list list = {0};
+    EXPECT_EQ(sv_multimatch_scan(&mm, StringViewFromStr("ushers"), SV_MATCH_ALL, _collect_match, &list), 3);
+    ASSERT_EQ(list.count, 3);
+    EXPECT_EQ(list.matches[0].pattern, 1);
+    EXPECT_EQ(list.matches[0].offset, 1);
+    EXPECT_EQ(list.matches[1].pattern, 0);
+    EXPECT_EQ(list.matches[1].offset, 2);
+    EXPECT_EQ(list.matches[2].pattern, 3);
+    EXPECT_EQ(list.matches[2].offset, 2);
+    sv_multimatch_free(&mm);
+}
+
+TEST(multimatch_tests, sv_multimatch_scan__leftmost_longest)
+{
+    StringView patterns[] = {StringViewFromStr("abc"), StringViewFromStr("ab"), StringViewFromStr("bcdef"),
+                             StringViewFromStr("x"), StringViewFromStr("")};
+    sv_multimatch mm;
+    ASSERT_EQ(sv_multimatch_build(&mm, patterns, 5), 0);
+
+    _match_list list = {0};
+    sv_multimatch_scan(&mm, StringViewFromStr("zabcdefxab"), SV_MATCH_LEFTMOST_LONGEST, _collect_match, &list);
+    ASSERT_EQ(list.count, 3);
+    EXPECT_EQ(list.matches[0].pattern, 0);
+    EXPECT_EQ(list.matches[0].offset, 1);
+    EXPECT_EQ(list.matches[1].pattern, 3);
+    EXPECT_EQ(list.matches[1].offset, 7);
+    EXPECT_EQ(list.matches[2].pattern, 1);
+    EXPECT_EQ(list.matches[2].offset, 8);
+    sv_multimatch_free(&mm);
+}
+
+TEST(multimatch_tests, sv_multimatch_scan__matches_brute_force)
+{
+    char text[500];
+    char storage[30][6];
+    StringView patterns[30];
+    srand(10);
+    for (int round = 0; round < 50; round++)
+    {
+        for (int p = 0; p < 30; p++)
+        {
+            size_t len = 1 + rand() % 5;
+            for (size_t i = 0; i < len; i++)
+                storage[p][i] = 'a' + rand() % 3;
+            patterns[p] = sv_construct(storage[p], len);
+        }
+        for (size_t i = 0; i < sizeof(text); i++)
+            text[i] = 'a' + rand() % 3;
+
+        sv_multimatch mm;
+        ASSERT_EQ(sv_multimatch_build(&mm, patterns, 30), 0);
+
+        size_t all = 0;
+        for (size_t i = 0; i < sizeof(text); i++)
+        {
+            for (int p = 0; p < 30; p++)
+            {
+                bool earlier_duplicate = false;
+                for (int q = 0; q < p; q++)
+                    earlier_duplicate |= sv_compare(patterns[p], patterns[q]);
+                StringView rest = sv_construct(text + i, sizeof(text) - i);
+                all += !earlier_duplicate && sv_starts_with(rest, patterns[p]);
+            }
+        }
+        EXPECT_EQ(sv_multimatch_scan(&mm, sv_construct(text, sizeof(text)), SV_MATCH_ALL, NULL, NULL), all);
+
+        size_t leftmost = 0;
+        for (size_t i = 0; i < sizeof(text);)
+        {
+            size_t longest = 0;
+            for (int p = 0; p < 30; p++)
+            {
+                StringView rest = sv_construct(text + i, sizeof(text) - i);
+                if (sv_starts_with(rest, patterns[p]) && patterns[p].len > longest)
+                    longest = patterns[p].len;
+            }
+            leftmost += longest > 0;
+            i += longest ? longest : 1;
+        }
+        EXPECT_EQ(sv_multimatch_scan(&mm, sv_construct(text, sizeof(text)), SV_MATCH_LEFTMOST_LONGEST, NULL, NULL),
+                  leftmost);
+        sv_multimatch_free(&mm);
+    }
+}
+
+// CHARACTER CLASSES
+
+TEST(class_tests, sv_charset_class__matches_ctype)
+{
+    int (*ctype[SV_CLASS_COUNT])(int) = {
+        [SV_CLASS_SPACE] = isspace, [SV_CLASS_DIGIT] = isdigit, [SV_CLASS_ALPHA] = isalpha,
+        [SV_CLASS_ALNUM] = isalnum, [SV_CLASS_XDIGIT] = isxdigit, [SV_CLASS_UPPER] = isupper,
+        [SV_CLASS_LOWER] = islower, [SV_CLASS_PUNCT] = ispunct,
+    };
+    for (int cls = 0; cls < SV_CLASS_COUNT; cls++)
+    {
+        const sv_charset *set = sv_charset_class(cls);
+        for (int b = 0; b < 256; b++)
+            EXPECT_EQ(sv_charset_has(set, (char)b), b < 128 && ctype[cls](b) != 0);
+    }
+    EXPECT_TRUE(sv_charset_class(SV_CLASS_COUNT) == NULL);
+    EXPECT_TRUE(sv_charset_class(-1) == NULL);
+}
+
+TEST(class_tests, sv_charset_complement_and_from_predicate)
+{
+    sv_charset alnum = sv_charset_from_predicate(_alphanum_prediucate);
+    sv_charset other = sv_charset_complement(&alnum);
+    for (int b = 0; b < 256; b++)
+    {
+        EXPECT_EQ(sv_charset_has(&alnum, (char)b), sv_charset_has(sv_charset_class(SV_CLASS_ALNUM), (char)b));
+        EXPECT_EQ(sv_charset_has(&other, (char)b), !sv_charset_has(&alnum, (char)b));
+    }
+}
+
+TEST(class_tests, sv_starts_ends_with_class__matches_predicate)
+{
+    char text[300];
+    srand(11);
+    for (int round = 0; round < 200; round++)
+    {
+        size_t len = rand() % sizeof(text);
+        size_t head = len ? rand() % (len + 1) : 0;
+        for (size_t i = 0; i < len; i++)
+            text[i] = (char)(rand() % 256);
+        for (size_t i = 0; i < head; i++)
+            text[i] = "abcXYZ019"[rand() % 9];
+        for (size_t i = len - head / 2; i < len; i++)
+            text[i] = "abcXYZ019"[rand() % 9];
+        StringView sv = sv_construct(text, len);
+
+        FOR_EACH_SIMD_LEVEL(level)
+        {
+            const sv_charset *alnum = sv_charset_class(SV_CLASS_ALNUM);
+            EXPECT_EQ(sv_starts_with_class(&sv, alnum), sv_starts_with_predicate(&sv, _alphanum_prediucate));
+            EXPECT_EQ(sv_ends_with_class(&sv, alnum), sv_ends_with_predicate(&sv, _alphanum_prediucate));
+            EXPECT_EQ(sv_find_left_class(&sv, alnum), sv_find_left_predicate(&sv, _alphanum_prediucate));
+        }
+    }
+}
+
+TEST(class_tests, sv_starts_with_predicate__stays_in_bounds)
+{
+    StringView sv = sv_construct("aaab", 3);
+    EXPECT_EQ(sv_starts_with_predicate(&sv, _alphanum_prediucate), 3);
+    EXPECT_EQ(sv_ends_with_predicate(&sv, _alphanum_prediucate), 3);
+    EXPECT_EQ(sv_starts_with_class(&sv, sv_charset_class(SV_CLASS_ALPHA)), 3);
+}
+
+TEST(class_tests, sv_strip__whitespace_class)
+{
+    StringView sv = StringViewFromStr(" \t\v\f\r\n word \n\r\f\v\t ");
+    EXPECT_EQ(sv_strip_left(&sv), 7);
+    EXPECT_EQ(sv_strip_right(&sv), 7);
+    EXPECT_TRUE(sv_compare(sv, StringViewFromStr("word")));
+
+    StringView blank = StringViewFromStr(" \t \n");
+    EXPECT_EQ(sv_strip_left(&blank), 4);
+    EXPECT_EQ(blank.len, 0);
+}
+
+// GENERATED SPLITTERS AND SCANNERS
+
+SV_DEFINE_SPLITTER(_split_comma, ',')
+SV_DEFINE_SCANNER(_find_separator, c == ';' || c == '|' || c >= 0x80)
+
+TEST(generated_tests, sv_define_splitter__fields)
+{
+    StringView sv = StringViewFromStr("a,bb,,ccc,");
+    const char *expected[] = {"a", "bb", "", "ccc"};
+    for (int i = 0; i < 4; i++)
+    {
+        StringView piece = _split_comma(&sv);
+        EXPECT_TRUE(sv_compare(piece, StringViewFromStr((char *)expected[i])));
+    }
+    EXPECT_EQ(sv.len, 0);
+
+    StringView tail = StringViewFromStr("no delimiter here at all");
+    StringView piece = _split_comma(&tail);
+    EXPECT_EQ(piece.len, 24);
+    EXPECT_EQ(tail.len, 0);
+}
+
+TEST(generated_tests, sv_define_splitter__matches_split_left)
+{
+    char text[400];
+    srand(12);
+    for (int round = 0; round < 200; round++)
+    {
+        size_t len = rand() % sizeof(text);
+        for (size_t i = 0; i < len; i++)
+            text[i] = rand() % 8 ? 'a' + rand() % 26 : ',';
+        StringView generated = sv_construct(text, len);
+        StringView generic = generated;
+        while (generated.len)
+        {
+            StringView piece = _split_comma(&generated);
+            StringView expected = sv_split_left(&generic, ',');
+            EXPECT_TRUE(piece.data == expected.data && piece.len == expected.len);
+            if (expected.data + expected.len == generic.data + generic.len)
+                generic.len = 0;
+        }
+        EXPECT_EQ(generic.len, 0);
+    }
+}
+
+TEST(generated_tests, sv_define_scanner)
+{
+    StringView sv = StringViewFromStr("key=value|rest");
+    EXPECT_EQ(_find_separator(&sv), 9);
+    StringView high = StringViewFromStr("ab\xc3\xa9;");
+    EXPECT_EQ(_find_separator(&high), 2);
+    StringView none = StringViewFromStr("plain text");
+    EXPECT_EQ(_find_separator(&none), -1);
+}
+
+TEST(generated_tests, sv_define_scanner__matches_byte_loop)
+{
+    char text[300];
+    srand(13);
+    for (int round = 0; round < 300; round++)
+    {
+        size_t len = rand() % sizeof(text);
+        for (size_t i = 0; i < len; i++)
+            text[i] = 'a' + rand() % 26;
+        if (len > 0 && rand() % 4)
+            text[rand() % len] = "|;\xc3"[rand() % 3];
+        int expected = -1;
+        for (size_t i = 0; i < len && expected < 0; i++)
+            if (text[i] == ';' || text[i] == '|' || (unsigned char)text[i] >= 0x80)
+                expected = i;
+        StringView sv = sv_construct(text, len);
+        EXPECT_EQ_INFO(_find_separator(&sv), expected, "len %zu", len);
+    }
+}
+
+// ARENA
+
+TEST(arena_tests, sv_arena_dup__outlives_source)
+{
+    sv_arena arena;
+    sv_arena_init(&arena, 256, 0);
+    char *text = read_file_cstr("./tests/test_files/utility_test_file.txt");
+    StringView line = sv_construct(text, strlen(text));
+    StringView word = sv_split_left(&line, ' ');
+    StringView copy = sv_arena_dup(&arena, word);
+    free(text);
+
+    EXPECT_STREQ(copy.data, "test");
+    EXPECT_EQ(copy.len, 4);
+    EXPECT_EQ(copy.data[copy.len], '\0');
+    StringView empty = sv_arena_dup(&arena, StringViewNull);
+    ASSERT_TRUE(empty.data != NULL);
+    EXPECT_EQ(empty.data[0], '\0');
+    sv_arena_free(&arena);
+    EXPECT_TRUE(arena.block == NULL);
+}
+
+TEST(arena_tests, sv_arena_rewind_and_reset)
+{
+    sv_arena arena = {0};
+    arena.block_size = 128;
+    StringView keep = sv_arena_dup(&arena, StringViewFromStr("kept"));
+    sv_arena_mark mark = sv_arena_get_mark(&arena);
+
+    char *first = NULL;
+    for (int i = 0; i < 100; i++)
+    {
+        StringView tmp = sv_arena_dup(&arena, StringViewFromStr("temporary token"));
+        first = first ? first : (char *)tmp.data;
+        uint64_t *aligned = sv_arena_alloc(&arena, 3 * sizeof(uint64_t), 8);
+        ASSERT_TRUE(aligned != NULL);
+        EXPECT_EQ((uintptr_t)aligned % 8, 0);
+        aligned[2] = i;
+    }
+    sv_arena_rewind(&arena, mark);
+    EXPECT_STREQ(keep.data, "kept");
+    EXPECT_TRUE(sv_arena_dup(&arena, StringViewFromStr("x")).data == first);
+
+    sv_arena_reset(&arena);
+    EXPECT_TRUE(sv_arena_dup(&arena, StringViewFromStr("y")).data == keep.data);
+    sv_arena_free(&arena);
+
+    sv_arena huge;
+    sv_arena_init(&huge, 0, SV_ARENA_HUGEPAGES);
+    StringView token = sv_arena_dup(&huge, StringViewFromStr("huge"));
+    EXPECT_STREQ(token.data, "huge");
+    sv_arena_free(&huge);
+}
+
+// BUILDER
+
+TEST(builder_tests, sv_builder__grows_past_inline_buffer)
+{
+    sv_builder builder = {0};
+    sv_builder_append_sv(&builder, StringViewFromStr("key"));
+    sv_builder_append_char(&builder, '=');
+    EXPECT_TRUE(builder.heap == NULL);
+    EXPECT_STREQ(sv_builder_view(&builder).data, "key=");
+
+    for (int i = 0; i < 1000; i++)
+    {
+        sv_builder_append_repeat(&builder, 'x', i % 7);
+        sv_builder_append_char(&builder, ',');
+    }
+    StringView view = sv_builder_view(&builder);
+    EXPECT_TRUE(builder.heap != NULL);
+    EXPECT_EQ(view.len, 4 + 1000 + 2997);
+    EXPECT_TRUE(sv_starts_with(view, StringViewFromStr("key=,x,xx,xxx,")));
+    EXPECT_EQ(view.data[view.len], '\0');
+    EXPECT_EQ(builder.error, 0);
+
+    sv_builder_clear(&builder);
+    EXPECT_EQ(sv_builder_view(&builder).len, 0);
+    EXPECT_EQ(sv_builder_reserve(&builder, 10000), 0);
+    char *before = builder.heap;
+    sv_builder_append_repeat(&builder, 'y', 9999);
+    EXPECT_TRUE(builder.heap == before);
+    sv_builder_free(&builder);
+}
+
+TEST(builder_tests, sv_builder_append_int__matches_snprintf)
+{
+    char expected[64];
+    sv_builder builder;
+    sv_builder_init(&builder);
+    uint64_t values[] = {0, 1, 9, 10, 99, 100, 4294967295ULL, 9999999999999999999ULL, 10000000000000000000ULL,
+                         UINT64_MAX};
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        sv_builder_clear(&builder);
+        sv_builder_append_u64(&builder, values[i]);
+        snprintf(expected, sizeof(expected), "%llu", (unsigned long long)values[i]);
+        EXPECT_STREQ(sv_builder_view(&builder).data, expected);
+    }
+
+    srand(16);
+    for (int round = 0; round < 2000; round++)
+    {
+        // Random magnitudes so every digit count is covered, and both powers of ten edges.
+        uint64_t u = ((uint64_t)rand() << 40 ^ (uint64_t)rand() << 20 ^ rand()) >> (rand() % 64);
+        int64_t s = round % 2 ? -(int64_t)(u >> 1) : (int64_t)(u >> 1);
+        if (round % 50 == 0)
+            s = INT64_MIN;
+        sv_builder_clear(&builder);
+        sv_builder_append_u64(&builder, u);
+        sv_builder_append_char(&builder, ' ');
+        sv_builder_append_i64(&builder, s);
+        snprintf(expected, sizeof(expected), "%llu %lld", (unsigned long long)u, (long long)s);
+        EXPECT_STREQ(sv_builder_view(&builder).data, expected);
+    }
+    for (int k = 1; k < 20; k++)
+    {
+        uint64_t power = 1;
+        for (int j = 0; j < k; j++)
+            power *= 10;
+        sv_builder_clear(&builder);
+        sv_builder_append_u64(&builder, power - 1);
+        EXPECT_EQ(sv_builder_view(&builder).len, k);
+        sv_builder_clear(&builder);
+        sv_builder_append_u64(&builder, power);
+        EXPECT_EQ(sv_builder_view(&builder).len, k + 1);
+    }
+    sv_builder_free(&builder);
+}
+
+// INTEGER PARSING
+
+TEST(parse_tests, sv_parse_u64__fields)
+{
+    StringView line = StringViewFromStr("200,18446744073709551615,18446744073709551616,,007,12x");
+    uint64_t value;
+    size_t consumed;
+
+    EXPECT_EQ(sv_parse_u64(sv_split_left(&line, ','), &value, &consumed), 0);
+    EXPECT_EQ(value, 200);
+    EXPECT_EQ(consumed, 3);
+    EXPECT_EQ(sv_parse_u64(sv_split_left(&line, ','), &value, &consumed), 0);
+    EXPECT_TRUE(value == UINT64_MAX);
+    EXPECT_EQ(sv_parse_u64(sv_split_left(&line, ','), &value, &consumed), ERANGE);
+    EXPECT_TRUE(value == UINT64_MAX);
+    EXPECT_EQ(consumed, 20);
+    EXPECT_EQ(sv_parse_u64(sv_split_left(&line, ','), &value, &consumed), EINVAL);
+    EXPECT_EQ(consumed, 0);
+    EXPECT_EQ(sv_parse_u64(sv_split_left(&line, ','), &value, NULL), 0);
+    EXPECT_EQ(value, 7);
+    EXPECT_EQ(sv_parse_u64(line, &value, &consumed), 0);
+    EXPECT_EQ(value, 12);
+    EXPECT_EQ(consumed, 2);
+
+    uint32_t small;
+    EXPECT_EQ(sv_parse_u32(StringViewFromStr("4294967295"), &small, NULL), 0);
+    EXPECT_TRUE(small == UINT32_MAX);
+    EXPECT_EQ(sv_parse_u32(StringViewFromStr("4294967296"), &small, NULL), ERANGE);
+    EXPECT_TRUE(small == UINT32_MAX);
+}
+
+TEST(parse_tests, sv_parse_i64__limits_and_signs)
+{
+    int64_t value;
+    size_t consumed;
+    EXPECT_EQ(sv_parse_i64(StringViewFromStr("-9223372036854775808"), &value, &consumed), 0);
+    EXPECT_TRUE(value == INT64_MIN);
+    EXPECT_EQ(consumed, 20);
+    EXPECT_EQ(sv_parse_i64(StringViewFromStr("-9223372036854775809"), &value, NULL), ERANGE);
+    EXPECT_TRUE(value == INT64_MIN);
+    EXPECT_EQ(sv_parse_i64(StringViewFromStr("9223372036854775807"), &value, NULL), 0);
+    EXPECT_TRUE(value == INT64_MAX);
+    EXPECT_EQ(sv_parse_i64(StringViewFromStr("+9223372036854775808"), &value, NULL), ERANGE);
+    EXPECT_TRUE(value == INT64_MAX);
+    EXPECT_EQ(sv_parse_i64(StringViewFromStr("+42 "), &value, &consumed), 0);
+    EXPECT_EQ(value, 42);
+    EXPECT_EQ(consumed, 3);
+    EXPECT_EQ(sv_parse_i64(StringViewFromStr("-"), &value, &consumed), EINVAL);
+    EXPECT_EQ(consumed, 0);
+}
+
+TEST(parse_tests, sv_parse_u64__matches_strtoull)
+{
+    char text[48];
+    srand(17);
+    for (int round = 0; round < 20000; round++)
+    {
+        size_t digits = rand() % 24;
+        size_t len = 0;
+        for (size_t i = 0; i < digits; i++)
+            text[len++] = round % 5 == 0 && i < 4 ? '0' : '0' + rand() % 10;
+        // Trailing bytes close to the digit range, so the SWAR scan sees them too.
+        const char *after = "/:a \xb0";
+        text[len++] = after[rand() % 5];
+        memset(text + len, '9', 8);
+        size_t view_len = len - 1 + (rand() % 2);
+
+        StringView sv = sv_construct(text, view_len);
+        uint64_t value;
+        size_t consumed;
+        int err = sv_parse_u64(sv, &value, &consumed);
+
+        char copy[48];
+        memcpy(copy, text, digits);
+        copy[digits] = '\0';
+        errno = 0;
+        unsigned long long expected = strtoull(copy, NULL, 10);
+        EXPECT_EQ(consumed, digits);
+        if (digits == 0)
+        {
+            EXPECT_EQ(err, EINVAL);
+            continue;
+        }
+        EXPECT_EQ(err, errno);
+        EXPECT_TRUE(value == expected);
+    }
+}
+
+// FLOATING-POINT PARSING
+
+TEST(parse_tests, sv_parse_double__forms)
+{
+    double value;
+    size_t consumed;
+    EXPECT_EQ(sv_parse_double(StringViewFromStr("3.25,next"), &value, &consumed), 0);
+    EXPECT_DOUBLE_EQ(value, 3.25);
+    EXPECT_EQ(consumed, 4);
+    EXPECT_EQ(sv_parse_double(StringViewFromStr("-.5e+2"), &value, &consumed), 0);
+    EXPECT_DOUBLE_EQ(value, -50.0);
+    EXPECT_EQ(consumed, 6);
+    EXPECT_EQ(sv_parse_double(StringViewFromStr("7.e"), &value, &consumed), 0);
+    EXPECT_DOUBLE_EQ(value, 7.0);
+    EXPECT_EQ(consumed, 2);
+    EXPECT_EQ(sv_parse_double(StringViewFromStr("1E-3x"), &value, &consumed), 0);
+    EXPECT_DOUBLE_EQ(value, 0.001);
+    EXPECT_EQ(consumed, 4);
+    EXPECT_EQ(sv_parse_double(StringViewFromStr("-0"), &value, NULL), 0);
+    EXPECT_TRUE(value == 0 && 1 / value < 0);
+    EXPECT_EQ(sv_parse_double(StringViewFromStr("-Infinity"), &value, &consumed), 0);
+    EXPECT_TRUE(value < -DBL_MAX);
+    EXPECT_EQ(consumed, 9);
+    EXPECT_EQ(sv_parse_double(StringViewFromStr("NaN"), &value, NULL), 0);
+    EXPECT_TRUE(value != value);
+    EXPECT_EQ(sv_parse_double(StringViewFromStr("1e400"), &value, NULL), ERANGE);
+    EXPECT_TRUE(value > DBL_MAX);
+    EXPECT_EQ(sv_parse_double(StringViewFromStr("1e-400"), &value, NULL), ERANGE);
+    EXPECT_TRUE(value == 0);
+    EXPECT_EQ(sv_parse_double(StringViewFromStr("."), &value, &consumed), EINVAL);
+    EXPECT_EQ(consumed, 0);
+    EXPECT_EQ(sv_parse_double(StringViewFromStr("e5"), &value, &consumed), EINVAL);
+
+    float single;
+    EXPECT_EQ(sv_parse_float(StringViewFromStr("0.1"), &single, NULL), 0);
+    EXPECT_FLOAT_EQ(single, 0.1f);
+    EXPECT_EQ(sv_parse_float(StringViewFromStr("3.4028236e38"), &single, NULL), ERANGE);
+}
+
+TEST(parse_tests, sv_parse_double__matches_strtod)
+{
+    // Hard cases: halfway points, long mantissas, subnormal and overflow edges.
+    const char *cases[] = {
+        "9007199254740993",
+        "9007199254740992.999999999999999999999",
+        "2.2250738585072011e-308",
+        "2.2250738585072012e-308",
+        "4.9406564584124654e-324",
+        "2.4703282292062327e-324",
+        "2.4703282292062328e-324",
+        "1.7976931348623157e308",
+        "1.7976931348623158e308",
+        "1.7976931348623159e308",
+        "7.038531e-26",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124",
+        "1.00000000000000011102230246251565404236316680908203126",
+        "123456789012345678901234567890e-10",
+        "0.000000000000000000000000000000000000000000001e300",
+        "179769313486231580793728971405303415079934132710037826936173778980444968292764750946649017977587207096330"
+        "28641669288791094655554785194040263065748867150582068.5",
+        "3.4028235677973366e38",
+        "1.1754943508222875e-38",
+        "1.40129846432481707e-45",
+        "7.006492321624085e-46",
+    };
+    double value;
+    float single;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        StringView sv = sv_construct((char *)cases[i], strlen(cases[i]));
+        sv_parse_double(sv, &value, NULL);
+        EXPECT_TRUE_INFO(value == strtod(cases[i], NULL), "%s", cases[i]);
+        sv_parse_float(sv, &single, NULL);
+        EXPECT_TRUE_INFO(single == strtof(cases[i], NULL), "%s", cases[i]);
+    }
+
+    char text[64];
+    srand(18);
+    for (int round = 0; round < 100000; round++)
+    {
+        int len = 0;
+        int digits = 1 + rand() % (round % 10 == 0 ? 30 : 17);
+        int point = rand() % (digits + 1);
+        for (int d = 0; d < digits; d++)
+        {
+            if (d == point)
+                text[len++] = '.';
+            text[len++] = '0' + rand() % 10;
+        }
+        len += snprintf(text + len, sizeof(text) - len, "e%d", rand() % 700 - 350);
+
+        size_t consumed;
+        sv_parse_double(sv_construct(text, len), &value, &consumed);
+        char *end;
+        double expected = strtod(text, &end);
+        EXPECT_TRUE_INFO(value == expected, "%s", text);
+        EXPECT_EQ(consumed, end - text);
+        sv_parse_float(sv_construct(text, len), &single, NULL);
+        EXPECT_TRUE_INFO(single == strtof(text, NULL), "%s", text);
+    }
+}
+
+// NUMBER FORMATTING
+
+TEST(format_tests, sv_format_int__limits)
+{
+    char buffer[SV_FORMAT_I64_MAX + 1];
+    StringView view = sv_format_u64(buffer, 0);
+    buffer[view.len] = '\0';
+    EXPECT_STREQ(buffer, "0");
+    view = sv_format_u64(buffer, UINT64_MAX);
+    buffer[view.len] = '\0';
+    EXPECT_TRUE(view.data == buffer);
+    EXPECT_STREQ(buffer, "18446744073709551615");
+    view = sv_format_i64(buffer, INT64_MIN);
+    buffer[view.len] = '\0';
+    EXPECT_STREQ(buffer, "-9223372036854775808");
+    view = sv_format_i64(buffer, -7);
+    buffer[view.len] = '\0';
+    EXPECT_STREQ(buffer, "-7");
+    view = sv_format_i64(buffer, 1000000);
+    buffer[view.len] = '\0';
+    EXPECT_STREQ(buffer, "1000000");
+}
+
+TEST(format_tests, sv_format_double__forms)
+{
+    struct
+    {
+        double value;
+        const char *text;
+    } cases[] = {
+        {0.0, "0"},
+        {-0.0, "-0"},
+        {1.0, "1"},
+        {-2.5, "-2.5"},
+        {0.1, "0.1"},
+        {0.1 + 0.2, "0.30000000000000004"},
+        {123.456, "123.456"},
+        {1e20, "100000000000000000000"},
+        {1e21, "1e+21"},
+        {1.5e300, "1.5e+300"},
+        {0.000001, "0.000001"},
+        {1.25e-7, "1.25e-7"},
+        {9007199254740993.0, "9007199254740992"},
+        {5e-324, "5e-324"},
+        {2.2250738585072014e-308, "2.2250738585072014e-308"},
+        {DBL_MAX, "1.7976931348623157e+308"},
+        {-1.0 / 0.0, "-inf"},
+        {0.0 / 0.0, "nan"},
+    };
+    char buffer[SV_FORMAT_DOUBLE_MAX + 1];
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        StringView view = sv_format_double(buffer, cases[i].value);
+        buffer[view.len] = '\0';
+        EXPECT_STREQ(buffer, cases[i].text);
+    }
+
+    sv_builder builder = {0};
+    sv_builder_append_sv(&builder, StringViewFromStr("x="));
+    sv_builder_append_double(&builder, 0.5);
+    EXPECT_STREQ(sv_builder_view(&builder).data, "x=0.5");
+    sv_builder_free(&builder);
+}
+
+static size_t _significant_digits(const char *text, char *digits)
+{
+    // The digits of a formatted number without leading or trailing zeros.
+    size_t n = 0;
+    for (; *text && *text != 'e'; text++)
+        if (*text >= '0' && *text <= '9' && (n || *text != '0'))
+            digits[n++] = *text;
+    while (n > 1 && digits[n - 1] == '0')
+        n--;
+    digits[n] = '\0';
+    return n;
+}
+
+TEST(format_tests, sv_format_double__shortest_round_trip)
+{
+    char buffer[SV_FORMAT_DOUBLE_MAX + 1];
+    char text[64], digits[32], expected[32];
+    srand(19);
+    for (int round = 0; round < 200000; round++)
+    {
+        // Random bit patterns cover every exponent; short decimals hit the exact-bound paths.
+        double value;
+        uint64_t bits = (uint64_t)rand() << 42 ^ (uint64_t)rand() << 21 ^ rand();
+        memcpy(&value, &bits, sizeof(value));
+        if (round % 2)
+            value = (double)(rand() % 100000) / (double)(1 + rand() % 1000) * (round % 3 ? 1e-5 : 1e12);
+        if (value != value || value - value != 0)
+            continue;
+
+        StringView view = sv_format_double(buffer, value);
+        buffer[view.len] = '\0';
+        EXPECT_TRUE(view.len <= SV_FORMAT_DOUBLE_MAX);
+        double back;
+        EXPECT_EQ(sv_parse_double(view, &back, NULL), 0);
+        EXPECT_TRUE_INFO(back == value && signbit(back) == signbit(value), "%s", buffer);
+        if (value == 0)
+            continue;
+
+        // No shorter string reads back to value, and among equally short ones the closest is chosen.
+        int n = (int)_significant_digits(buffer, digits);
+        if (n > 1)
+        {
+            snprintf(text, sizeof(text), "%.*e", n - 2, value);
+            EXPECT_TRUE_INFO(strtod(text, NULL) != value, "%s shorter %s", buffer, text);
+        }
+        snprintf(text, sizeof(text), "%.*e", n - 1, value);
+        if (strtod(text, NULL) == value)
+        {
+            _significant_digits(text, expected);
+            EXPECT_STREQ(digits, expected);
+        }
+    }
+}
+
+// HASHING AND MAPS
+
+TEST(map_tests, sv_hash__depends_on_every_byte)
+{
+    char text[200];
+    srand(13);
+    for (size_t i = 0; i < sizeof(text); i++)
+        text[i] = 'a' + rand() % 26;
+    for (size_t len = 0; len < sizeof(text); len++)
+    {
+        StringView sv = sv_construct(text, len);
+        uint64_t hash = sv_hash(sv);
+        EXPECT_TRUE(hash != sv_hash(sv_construct(text, len + 1)));
+        EXPECT_TRUE(hash != sv_hash_seeded(sv, 1));
+        for (size_t i = 0; i < len; i++)
+        {
+            text[i] ^= 1;
+            EXPECT_TRUE(hash != sv_hash(sv));
+            text[i] ^= 1;
+        }
+        EXPECT_EQ(hash, sv_hash(sv));
+    }
+}
+
+TEST(map_tests, sv_map__put_get_remove)
+{
+    sv_map map = {0};
+    EXPECT_FALSE(sv_map_get(&map, StringViewFromStr("missing"), NULL));
+    EXPECT_EQ(sv_map_put(&map, StringViewFromStr("alpha"), (void *)1), 0);
+    EXPECT_EQ(sv_map_put(&map, StringViewFromStr("alphabet soup"), (void *)2), 0);
+    EXPECT_EQ(sv_map_put(&map, StringViewFromStr(""), (void *)3), 0);
+    EXPECT_EQ(sv_map_put(&map, StringViewFromStr("alpha"), (void *)4), 0);
+    EXPECT_EQ(map.count, 3);
+
+    void *value;
+    ASSERT_TRUE(sv_map_get(&map, StringViewFromStr("alpha"), &value));
+    EXPECT_TRUE(value == (void *)4);
+    ASSERT_TRUE(sv_map_get(&map, StringViewFromStr(""), &value));
+    EXPECT_TRUE(value == (void *)3);
+    EXPECT_FALSE(sv_map_get(&map, StringViewFromStr("alphabet stew"), NULL));
+    EXPECT_FALSE(sv_map_get(&map, StringViewFromStr("alph"), NULL));
+
+    EXPECT_TRUE(sv_map_remove(&map, StringViewFromStr("alpha")));
+    EXPECT_FALSE(sv_map_remove(&map, StringViewFromStr("alpha")));
+    EXPECT_FALSE(sv_map_get(&map, StringViewFromStr("alpha"), NULL));
+    EXPECT_TRUE(sv_map_get(&map, StringViewFromStr("alphabet soup"), NULL));
+    EXPECT_EQ(map.count, 2);
+    sv_map_free(&map);
+}
+
+TEST(map_tests, sv_map__word_counts_and_find_many)
+{
+    // Keys share long prefixes so the tag alone cannot tell them apart.
+    char storage[2000][16];
+    StringView keys[2000];
+    for (int i = 0; i < 2000; i++)
+    {
+        int len = snprintf(storage[i], sizeof(storage[i]), "token-%d", i);
+        keys[i] = sv_construct(storage[i], len);
+    }
+
+    sv_map map;
+    ASSERT_EQ(sv_map_init(&map, 10), 0);
+    // Every initialized map hashes with its own seed.
+    sv_map other;
+    ASSERT_EQ(sv_map_init(&other, 0), 0);
+    EXPECT_TRUE(map.seed != 0 && other.seed != map.seed);
+    sv_map_free(&other);
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < 2000; i += round + 1)
+        {
+            void **count = sv_map_upsert(&map, keys[i]);
+            ASSERT_TRUE(count != NULL);
+            *count = (void *)((uintptr_t)*count + 1);
+        }
+    }
+    for (int i = 0; i < 2000; i += 2)
+        EXPECT_TRUE(sv_map_remove(&map, keys[i]));
+
+    void *values[2000];
+    bool found[2000];
+    EXPECT_EQ(sv_map_find_many(&map, keys, 2000, values, found), 1000);
+    for (int i = 0; i < 2000; i++)
+    {
+        uintptr_t expected = i % 2 == 0 ? 0 : 1 + (i % 3 == 0);
+        EXPECT_EQ(found[i], i % 2 == 1);
+        EXPECT_EQ((uintptr_t)values[i], expected);
+    }
+    sv_map_free(&map);
+}
+
+// INTERNING
+
+TEST(intern_tests, sv_intern_id__dense_stable_ids)
+{
+    sv_intern intern = {0};
+    char word[32];
+    for (int round = 0; round < 2; round++)
+    {
+        for (int i = 0; i < 3000; i++)
+        {
+            int len = snprintf(word, sizeof(word), "host-%d.example", i);
+            EXPECT_EQ(sv_intern_id(&intern, sv_construct(word, len)), i);
+        }
+    }
+    EXPECT_EQ(intern.count, 3000);
+    EXPECT_EQ(sv_intern_id(&intern, StringViewNull), 3000);
+
+    uint32_t id;
+    ASSERT_TRUE(sv_intern_lookup(&intern, StringViewFromStr("host-42.example"), &id));
+    EXPECT_EQ(id, 42);
+    EXPECT_FALSE(sv_intern_lookup(&intern, StringViewFromStr("host-3000.example"), &id));
+    EXPECT_STREQ(sv_intern_view(&intern, 42).data, "host-42.example");
+    EXPECT_EQ(sv_intern_view(&intern, 3000).len, 0);
+    EXPECT_TRUE(sv_intern_view(&intern, 3001).data == NULL);
+    sv_intern_free(&intern);
+}
+
+static void _intern_record(StringView record, void *local, void *ctx)
+{
+    (void)local;
+    while (record.len)
+    {
+        StringView token = sv_split_left(&record, ' ');
+        if (token.data + token.len == record.data + record.len)
+            record.len = 0;
+        uint32_t id = sv_intern_concurrent_id(ctx, token);
+        StringView stored = sv_intern_concurrent_view(ctx, id);
+        if (!sv_compare(stored, token))
+            abort();
+    }
+}
+
+TEST(intern_tests, sv_intern_concurrent__matches_single_threaded)
+{
+    size_t size = 2 * 1024 * 1024;
+    char *buffer = malloc(size);
+    srand(14);
+    size_t i = 0;
+    while (i < size)
+    {
+        int len = snprintf(buffer + i, size - i, "t%d%c", rand() % 20000, rand() % 8 ? ' ' : '\n');
+        i += len;
+    }
+
+    sv_intern_concurrent intern;
+    ASSERT_EQ(sv_intern_concurrent_init(&intern), 0);
+    EXPECT_EQ(sv_parallel_for_each_record(sv_construct(buffer, size - 1), '\n', 4, _intern_record, &intern), 0);
+
+    sv_intern single = {0};
+    sv_charset separators = sv_charset_from_cstr(" \n");
+    StringView walk = sv_construct(buffer, size - 1);
+    while (walk.len)
+    {
+        StringView token = sv_split_left_any(&walk, &separators);
+        if (token.data + token.len == walk.data + walk.len)
+            walk.len = 0;
+        uint32_t id;
+        ASSERT_TRUE(sv_intern_concurrent_lookup(&intern, token, &id));
+        EXPECT_TRUE(sv_compare(sv_intern_concurrent_view(&intern, id), token));
+        sv_intern_id(&single, token);
+    }
+    EXPECT_EQ(sv_intern_concurrent_count(&intern), single.count);
+    sv_intern_free(&single);
+    sv_intern_concurrent_free(&intern);
+    free(buffer);
+}
+
+// CSV
+
+TEST(csv_tests, sv_csv_next__rfc4180_quoting)
+{
+    const char *text = "name,note,n\r\n"
+                       "plain,\"a, b\",1\r\n"
+                       "\"multi\nline\",\"say \"\"hi\"\"\",\r\n"
+                       "\n"
+                       ",\"\",\"\"\"\"\n"
+                       "last,no newline";
+    const char *expected[][3] = {
+        {"name", "note", "n"}, {"plain", "a, b", "1"}, {"multi\nline", "say \"hi\"", ""}, {""}, {"", "", "\""},
+        {"last", "no newline"},
+    };
+    size_t widths[] = {3, 3, 3, 1, 3, 2};
+
+    sv_csv csv;
+    sv_csv_init(&csv, sv_construct((char *)text, strlen(text)), ',');
+    size_t records = 0;
+    while (sv_csv_next(&csv))
+    {
+        ASSERT_TRUE(records < 6);
+        EXPECT_EQ_INFO(csv.field_count, widths[records], "record %zu", records);
+        for (size_t i = 0; i < csv.field_count && i < widths[records]; i++)
+        {
+            StringView field = csv.fields[i];
+            EXPECT_TRUE_INFO(field.len == strlen(expected[records][i]) &&
+                                 memcmp(field.data, expected[records][i], field.len) == 0,
+                             "record %zu field %zu: " StringViewFormat, records, i, (int)field.len, field.data);
+        }
+        records++;
+    }
+    EXPECT_EQ(records, 6);
+    EXPECT_EQ(csv.error, 0);
+    EXPECT_FALSE(sv_csv_next(&csv));
+    sv_csv_free(&csv);
+
+    sv_csv_init(&csv, sv_construct("a;b,c\n", 6), ';');
+    ASSERT_TRUE(sv_csv_next(&csv));
+    EXPECT_EQ(csv.field_count, 2);
+    EXPECT_EQ(csv.fields[1].len, 3);
+    EXPECT_FALSE(sv_csv_next(&csv));
+    sv_csv_free(&csv);
+}
+
+static char *_random_csv(size_t rows, size_t *len, char ***cells, size_t **widths)
+{
+    // Random fields over an alphabet heavy in structural bytes, quoted whenever they need it.
+    static const char alphabet[] = "ab ,\"\n";
+    size_t capacity = 1 << 16, n = 0, cell = 0;
+    char *text = malloc(capacity);
+    *cells = malloc(rows * 8 * sizeof(char *));
+    *widths = malloc(rows * sizeof(size_t));
+    for (size_t r = 0; r < rows; r++)
+    {
+        size_t width = 1 + rand() % 8;
+        (*widths)[r] = width;
+        for (size_t f = 0; f < width; f++)
+        {
+            size_t flen = rand() % (r % 10 == 0 ? 150 : 12);
+            char *content = malloc(flen + 1);
+            bool special = false;
+            for (size_t i = 0; i < flen; i++)
+            {
+                content[i] = rand() % 3 ? 'a' + rand() % 3 : alphabet[rand() % 6];
+                special |= content[i] == ',' || content[i] == '"' || content[i] == '\n';
+            }
+            content[flen] = '\0';
+            (*cells)[cell++] = content;
+
+            if (n + 2 * flen + 8 > capacity)
+            {
+                capacity = capacity * 2 + 2 * flen;
+                text = realloc(text, capacity);
+            }
+            bool quote = special || rand() % 8 == 0;
+            if (quote)
+                text[n++] = '"';
+            for (size_t i = 0; i < flen; i++)
+            {
+                if (content[i] == '"')
+                    text[n++] = '"';
+                text[n++] = content[i];
+            }
+            if (quote)
+                text[n++] = '"';
+            if (f + 1 < width)
+                text[n++] = ',';
+        }
+        if (rand() % 2)
+            text[n++] = '\r';
+        text[n++] = '\n';
+    }
+    *len = n;
+    return text;
+}
+
+static void _check_csv(sv_csv *csv, size_t rows, char **cells, size_t *widths, int level)
+{
+    size_t cell = 0, r = 0;
+    for (; sv_csv_next(csv); r++)
+    {
+        ASSERT_TRUE(r < rows);
+        EXPECT_EQ_INFO(csv->field_count, widths[r], "level %d row %zu", level, r);
+        for (size_t f = 0; f < csv->field_count && f < widths[r]; f++)
+        {
+            const char *want = cells[cell + f];
+            EXPECT_TRUE_INFO(csv->fields[f].len == strlen(want) && memcmp(csv->fields[f].data, want, strlen(want)) == 0,
+                             "level %d row %zu field %zu", level, r, f);
+        }
+        cell += widths[r];
+    }
+    EXPECT_EQ(csv->error, 0);
+    EXPECT_EQ_INFO(r, rows, "level %d", level);
+}
+
+TEST(csv_tests, sv_csv_next__doubled_quotes_stay_in_their_record)
+{
+    // A quote pair in an unquoted field is not an escape, whatever the records
+    // sharing its 64-byte block hold. Rows repeat in random order so the pairs
+    // fall on every block offset, and a short reader buffer moves them again.
+    static const char *rows[] = {"a\"\"b,c", "\"x\"\"y\"", "\"x\"\"y\",a\"\"b", "ab,\"\"\"\"", "\"\",b\"\""};
+    static const char *row_cells[][2] = {{"a\"\"b", "c"}, {"x\"y"}, {"x\"y", "a\"\"b"}, {"ab", "\""}, {"", "b\"\""}};
+    static const size_t row_widths[] = {2, 1, 2, 2, 2};
+    size_t count = 400, len = 0;
+    char *text = malloc(count * 16);
+    char **cells = malloc(count * 2 * sizeof(char *));
+    size_t *widths = malloc(count * sizeof(size_t)), cell = 0;
+    srand(21);
+    for (size_t r = 0; r < count; r++)
+    {
+        int kind = rand() % 5;
+        len += sprintf(text + len, "%s\n", rows[kind]);
+        widths[r] = row_widths[kind];
+        for (size_t f = 0; f < widths[r]; f++)
+            cells[cell++] = (char *)row_cells[kind][f];
+    }
+
+    FILE *file = tmpfile();
+    ASSERT_TRUE(file != NULL);
+    ASSERT_EQ(fwrite(text, 1, len, file), len);
+    fflush(file);
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        sv_csv csv;
+        sv_csv_init(&csv, sv_construct(text, len), ',');
+        _check_csv(&csv, count, cells, widths, level);
+        sv_csv_free(&csv);
+
+        ASSERT_EQ(lseek(fileno(file), 0, SEEK_SET), 0);
+        sv_reader reader;
+        ASSERT_EQ(sv_reader_init(&reader, fileno(file), 64), 0);
+        sv_csv_init_reader(&csv, &reader, ',');
+        _check_csv(&csv, count, cells, widths, level);
+        sv_csv_free(&csv);
+        sv_reader_free(&reader);
+    }
+    fclose(file);
+    free(widths);
+    free(cells);
+    free(text);
+}
+
+TEST(csv_tests, sv_csv__buffer_and_reader_match_on_all_levels)
+{
+    srand(20);
+    size_t rows = 3000, len;
+    char **cells;
+    size_t *widths;
+    char *text = _random_csv(rows, &len, &cells, &widths);
+
+    FILE *f = tmpfile();
+    ASSERT_TRUE(f != NULL);
+    ASSERT_EQ(fwrite(text, 1, len, f), len);
+    fflush(f);
+
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        sv_csv csv;
+        sv_csv_init(&csv, sv_construct(text, len), ',');
+        _check_csv(&csv, rows, cells, widths, level);
+        sv_csv_free(&csv);
+
+        // A small reader buffer puts records across refills and forces it to grow for the long ones.
+        ASSERT_EQ(lseek(fileno(f), 0, SEEK_SET), 0);
+        sv_reader reader;
+        ASSERT_EQ(sv_reader_init(&reader, fileno(f), 64), 0);
+        sv_csv_init_reader(&csv, &reader, ',');
+        _check_csv(&csv, rows, cells, widths, level);
+        sv_csv_free(&csv);
+        sv_reader_free(&reader);
+    }
+
+    size_t total = 0;
+    for (size_t r = 0; r < rows; r++)
+        total += widths[r];
+    for (size_t i = 0; i < total; i++)
+        free(cells[i]);
+    free(cells);
+    free(widths);
+    free(text);
+    fclose(f);
+}
+
+// CASE-INSENSITIVE MATCHING
+
+TEST(icase_tests, sv_compare_icase__ascii_only)
+{
+    EXPECT_TRUE(sv_compare_icase(StringViewFromStr("Content-Length"), StringViewFromStr("content-LENGTH")));
+    EXPECT_FALSE(sv_compare_icase(StringViewFromStr("Content-Length"), StringViewFromStr("content-lengths")));
+    EXPECT_TRUE(sv_compare_icase(StringViewFromStr(""), StringViewFromStr("")));
+    // Neighbours of the letter ranges and bytes with the top bit set do not fold.
+    EXPECT_FALSE(sv_compare_icase(StringViewFromStr("@[`{"), StringViewFromStr("`{@[")));
+    EXPECT_FALSE(sv_compare_icase(StringViewFromStr("\xc3\x89"), StringViewFromStr("\xc3\xa9")));
+    EXPECT_TRUE(sv_starts_with_icase(StringViewFromStr("WARNING: disk"), StringViewFromStr("warning")));
+    EXPECT_FALSE(sv_starts_with_icase(StringViewFromStr("WARN"), StringViewFromStr("warning")));
+    EXPECT_TRUE(sv_ends_with_icase(StringViewFromStr("api.Example.COM"), StringViewFromStr(".example.com")));
+    EXPECT_FALSE(sv_ends_with_icase(StringViewFromStr("api.example.org"), StringViewFromStr(".example.com")));
+
+    char a[200], b[200];
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        for (size_t len = 0; len <= sizeof(a); len++)
+        {
+            for (size_t i = 0; i < len; i++)
+            {
+                a[i] = (char)(i * 7 + 33);
+                b[i] = isalpha((unsigned char)a[i]) && i % 2 ? a[i] ^ 0x20 : a[i];
+            }
+            EXPECT_TRUE_INFO(sv_compare_icase(sv_construct(a, len), sv_construct(b, len)), "level %d len %zu", level, len);
+            for (size_t i = 0; i < len; i++)
+            {
+                char saved = b[i];
+                b[i] = a[i] ^ (isalpha((unsigned char)a[i]) ? 0x01 : 0x20);
+                EXPECT_FALSE_INFO(sv_compare_icase(sv_construct(a, len), sv_construct(b, len)), "level %d len %zu at %zu",
+                                  level, len, i);
+                b[i] = saved;
+            }
+        }
+    }
+}
+
+static int _brute_find_icase(const char *h, size_t n, const char *x, size_t m)
+{
+    for (size_t i = 0; i + m <= n; i++)
+    {
+        size_t j = 0;
+        while (j < m && tolower((unsigned char)h[i + j]) == tolower((unsigned char)x[j]))
+            j++;
+        if (j == m)
+            return i;
+    }
+    return -1;
+}
+
+TEST(icase_tests, sv_find_left_sv_icase__matches_brute_force_on_all_levels)
+{
+    char haystack[400];
+    char needle[40];
+    const char alphabet[] = "aAbB@`";
+    srand(21);
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        for (int round = 0; round < 2000; round++)
+        {
+            size_t n = rand() % sizeof(haystack);
+            size_t m = 1 + rand() % (round % 4 == 0 ? sizeof(needle) : 6);
+            int letters = 2 + rand() % 5;
+            for (size_t i = 0; i < n; i++)
+                haystack[i] = alphabet[rand() % letters];
+            for (size_t i = 0; i < m; i++)
+                needle[i] = alphabet[rand() % letters];
+            StringView test_sv = sv_construct(haystack, n);
+            EXPECT_EQ_INFO(sv_find_left_sv_icase(&test_sv, sv_construct(needle, m)),
+                           _brute_find_icase(haystack, n, needle, m), "level %d n %zu m %zu", level, n, m);
+        }
+
+        // Periodic worst case: the filter gives up and Two-Way finishes with folded compares.
+        size_t n = 100000, m = 300;
+        char *big = malloc(n);
+        char *pattern = malloc(m);
+        for (size_t i = 0; i < n; i++)
+            big[i] = i % 3 ? 'a' : 'A';
+        memset(pattern, 'a', m);
+        pattern[m / 2] = 'B';
+        memcpy(big + n - m - 3, pattern, m);
+        pattern[m / 2] = 'b';
+        StringView big_sv = sv_construct(big, n);
+        EXPECT_EQ_INFO(sv_find_left_sv_icase(&big_sv, sv_construct(pattern, m)), n - m - 3, "level %d", level);
+        free(big);
+        free(pattern);
+    }
+}
+
+// TRANSFORMS
+
+TEST(transform_tests, sv_to_lower_into__all_bytes_on_all_levels)
+{
+    char in[300], out[300], copy[300];
+    for (size_t i = 0; i < sizeof(in); i++)
+        in[i] = (char)(i * 37 + 11);
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        for (size_t len = 0; len <= sizeof(in); len += 1 + len / 16)
+        {
+            StringView lower = sv_to_lower_into(sv_construct(in, len), out);
+            EXPECT_TRUE(lower.data == out && lower.len == len);
+            for (size_t i = 0; i < len; i++)
+                EXPECT_EQ_INFO(out[i], (char)tolower((unsigned char)in[i]), "level %d len %zu at %zu", level, len, i);
+            sv_to_upper_into(sv_construct(in, len), out);
+            for (size_t i = 0; i < len; i++)
+                EXPECT_EQ_INFO(out[i], (char)toupper((unsigned char)in[i]), "level %d len %zu at %zu", level, len, i);
+
+            // In place.
+            memcpy(copy, in, len);
+            sv_to_lower_into(sv_construct(copy, len), copy);
+            for (size_t i = 0; i < len; i++)
+                EXPECT_EQ_INFO(copy[i], (char)tolower((unsigned char)in[i]), "level %d len %zu at %zu", level, len, i);
+        }
+    }
+
+    sv_arena arena;
+    sv_arena_init(&arena, 0, 0);
+    StringView header = StringViewFromStr("Content-Type");
+    StringView key = sv_to_lower_into(header, sv_arena_alloc(&arena, header.len, 1));
+    EXPECT_TRUE(sv_compare(key, StringViewFromStr("content-type")));
+    sv_arena_free(&arena);
+}
+
+TEST(transform_tests, sv_translate_into__sparse_and_dense_maps)
+{
+    unsigned char sparse[256], dense[256];
+    for (int c = 0; c < 256; c++)
+    {
+        sparse[c] = c;
+        dense[c] = (unsigned char)(c * 167 + 13);
+    }
+    sparse[','] = ';';
+    sparse['\0'] = ' ';
+    sparse[';'] = ',';
+
+    size_t n = 5000;
+    char *in = malloc(n), *out = malloc(n), *copy = malloc(n);
+    srand(22);
+    for (size_t i = 0; i < n; i++)
+        in[i] = rand() % 4 ? ",;\0a"[rand() % 4] : (char)rand();
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        for (size_t len = 0; len <= n; len += 1 + len / 3)
+        {
+            const unsigned char *maps[] = {sparse, dense};
+            for (int m = 0; m < 2; m++)
+            {
+                StringView result = sv_translate_into(sv_construct(in, len), maps[m], out);
+                EXPECT_EQ(result.len, len);
+                memcpy(copy, in, len);
+                sv_translate_into(sv_construct(copy, len), maps[m], copy);
+                for (size_t i = 0; i < len; i++)
+                {
+                    EXPECT_EQ_INFO((unsigned char)out[i], maps[m][(unsigned char)in[i]], "level %d map %d len %zu at %zu",
+                                   level, m, len, i);
+                    EXPECT_EQ_INFO(copy[i], out[i], "level %d map %d len %zu at %zu", level, m, len, i);
+                }
+            }
+        }
+    }
+    free(in);
+    free(out);
+    free(copy);
+}
+
+static size_t _squeeze_reference(const char *in, size_t len, const char *members, char replacement, char *out)
+{
+    size_t o = 0;
+    bool run = false;
+    for (size_t i = 0; i < len; i++)
+    {
+        bool member = in[i] && strchr(members, in[i]) != NULL;
+        if (member && !run)
+            out[o++] = replacement;
+        else if (!member)
+            out[o++] = in[i];
+        run = member;
+    }
+    return o;
+}
+
+TEST(transform_tests, sv_squeeze_into__matches_reference_on_all_levels)
+{
+    char out[64];
+    StringView squeezed = sv_squeeze_into(StringViewFromStr("  a \t b\n\nc  "), sv_charset_class(SV_CLASS_SPACE), ' ', out);
+    EXPECT_TRUE(sv_compare(squeezed, StringViewFromStr(" a b c ")));
+
+    size_t n = 3000;
+    char *in = malloc(n), *got = malloc(n), *want = malloc(n), *copy = malloc(n);
+    srand(23);
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        for (int round = 0; round < 200; round++)
+        {
+            size_t len = rand() % n;
+            int density = 1 + rand() % 6;
+            for (size_t i = 0; i < len; i++)
+                in[i] = rand() % density ? 'a' + rand() % 26 : " \t\n"[rand() % 3];
+            size_t expected = _squeeze_reference(in, len, " \t\n", '_', want);
+            StringView result = sv_squeeze_into(sv_construct(in, len), sv_charset_class(SV_CLASS_SPACE), '_', got);
+            EXPECT_TRUE_INFO(result.len == expected && memcmp(got, want, expected) == 0, "level %d len %zu", level, len);
+            memcpy(copy, in, len);
+            result = sv_squeeze_into(sv_construct(copy, len), sv_charset_class(SV_CLASS_SPACE), '_', copy);
+            EXPECT_TRUE_INFO(result.len == expected && memcmp(copy, want, expected) == 0, "in place, level %d len %zu",
+                             level, len);
+        }
+    }
+    free(in);
+    free(got);
+    free(want);
+    free(copy);
+}
+
+// SORTING
+
+TEST(sort_tests, sv_cmp__bytes_then_length)
+{
+    EXPECT_TRUE(sv_cmp(StringViewFromStr("abc"), StringViewFromStr("abc")) == 0);
+    EXPECT_TRUE(sv_cmp(StringViewFromStr("abc"), StringViewFromStr("abd")) < 0);
+    EXPECT_TRUE(sv_cmp(StringViewFromStr("ab"), StringViewFromStr("abc")) < 0);
+    EXPECT_TRUE(sv_cmp(StringViewFromStr("b"), StringViewFromStr("abc")) > 0);
+    EXPECT_TRUE(sv_cmp(StringViewNull, StringViewFromStr("")) == 0);
+    EXPECT_TRUE(sv_cmp(StringViewFromStr("\xff"), StringViewFromStr("a")) > 0);
+    EXPECT_TRUE(sv_cmp(sv_construct("a\0", 2), StringViewFromStr("a")) > 0);
+}
+
+static int _sv_cmp_qsort(const void *a, const void *b)
+{
+    return sv_cmp(*(const StringView *)a, *(const StringView *)b);
+}
+
+TEST(sort_tests, sv_sort__matches_qsort_on_shared_prefixes_and_duplicates)
+{
+    size_t n = 20000;
+    StringView *got = malloc(n * sizeof *got), *want = malloc(n * sizeof *want);
+    char *pool = malloc(n * 40);
+    srand(24);
+    for (size_t i = 0; i < n; i++)
+    {
+        /*Short alphabets and a common prefix give many equal keys, zero bytes
+        and lengths around the 7-byte key boundary.*/
+        char *p = pool + i * 40;
+        size_t prefix = rand() % 3 ? 14 : 0;
+        size_t len = prefix + rand() % 26;
+        for (size_t j = 0; j < len; j++)
+            p[j] = j < prefix ? 'p' : "\0ab\xff"[rand() % 4];
+        got[i] = want[i] = sv_construct(p, len);
+    }
+    qsort(want, n, sizeof *want, _sv_cmp_qsort);
+    EXPECT_TRUE(sv_sort(got, n) == 0);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < n; i++)
+        mismatches += sv_cmp(got[i], want[i]) != 0;
+    EXPECT_TRUE_INFO(mismatches == 0, "%zu mismatches", mismatches);
+    free(got);
+    free(want);
+    free(pool);
+}
+
+TEST(sort_tests, sv_sort__long_equal_strings_and_small_inputs)
+{
+    EXPECT_TRUE(sv_sort(NULL, 0) == 0);
+    size_t n = 100, len = 100000;
+    char *text = malloc(len);
+    memset(text, 'x', len);
+    StringView *arr = malloc(n * sizeof *arr);
+    for (size_t i = 0; i < n; i++)
+        arr[i] = sv_construct(text, len - (i * 7919) % n);
+    EXPECT_TRUE(sv_sort(arr, n) == 0);
+    bool sorted = true;
+    for (size_t i = 1; i < n; i++)
+        sorted &= arr[i - 1].len <= arr[i].len;
+    EXPECT_TRUE(sorted);
+    free(arr);
+    free(text);
+}
+
+static char *_extsort_file(const char *input, size_t len, const sv_extsort_options *options, size_t *out_len,
+                           int *err)
+{
+    FILE *in = tmpfile(), *out = tmpfile();
+    fwrite(input, 1, len, in);
+    fflush(in);
+    lseek(fileno(in), 0, SEEK_SET);
+    *err = sv_extsort(fileno(in), fileno(out), '\n', options);
+    long size = (long)lseek(fileno(out), 0, SEEK_END);
+    char *result = malloc(size + 1);
+    lseek(fileno(out), 0, SEEK_SET);
+    *out_len = *err ? 0 : (size_t)read(fileno(out), result, size);
+    fclose(in);
+    fclose(out);
+    return result;
+}
+
+static StringView _extsort_second_field(StringView record, void *ctx)
+{
+    (void)ctx;
+    sv_split_left(&record, ',');
+    return record;
+}
+
+TEST(sort_tests, sv_extsort__small_and_empty_inputs_in_memory)
+{
+    size_t len;
+    int err;
+    char *out = _extsort_file("pear\napple\n\nfig", 15, NULL, &len, &err);
+    EXPECT_EQ(err, 0);
+    EXPECT_TRUE(sv_compare(sv_construct(out, len), StringViewFromStr("\napple\nfig\npear\n")));
+    free(out);
+    out = _extsort_file("", 0, NULL, &len, &err);
+    EXPECT_EQ(len, 0);
+    free(out);
+}
+
+TEST(sort_tests, sv_extsort__many_runs_match_in_memory_sort)
+{
+    size_t n = 60000;
+    char *text = malloc(n * 16);
+    StringView *lines = malloc(n * sizeof *lines);
+    size_t len = 0;
+    srand(25);
+    for (size_t i = 0; i < n; i++)
+    {
+        int line_len = sprintf(text + len, "%x,%u", rand() % 5000, (unsigned)rand() % 100);
+        lines[i] = sv_construct(text + len, line_len);
+        len += line_len + 1;
+        text[len - 1] = '\n';
+    }
+    // A 4 KiB budget gives a few hundred runs, so merging takes several passes.
+    sv_extsort_options options = {.memory = 4096, .nthreads = 1};
+    size_t out_len;
+    int err;
+    char *out = _extsort_file(text, len - 1, &options, &out_len, &err);
+    if (err == ENOSYS)
+    {
+        // Strict ISO builds have no mkstemp, so runs cannot be spilled.
+        free(out);
+        free(lines);
+        free(text);
+        return;
+    }
+    ASSERT_EQ(out_len, len);
+    sv_sort(lines, n);
+    StringView rest = sv_construct(out, out_len);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < n; i++)
+        mismatches += !sv_compare(sv_split_left(&rest, '\n'), lines[i]);
+    EXPECT_TRUE_INFO(mismatches == 0, "%zu mismatches", mismatches);
+    free(out);
+
+    // Keyed by the second field and sorted by four threads: keys come out in
+    // order and the records are the input ones.
+    options = (sv_extsort_options){.memory = 64 * 1024, .nthreads = 4, .key = _extsort_second_field};
+    out = _extsort_file(text, len, &options, &out_len, &err);
+    ASSERT_EQ(out_len, len);
+    StringView *got = malloc(n * sizeof *got);
+    rest = sv_construct(out, out_len);
+    bool ordered = true;
+    for (size_t i = 0; i < n; i++)
+    {
+        got[i] = sv_split_left(&rest, '\n');
+        if (i > 0)
+            ordered &= sv_cmp(_extsort_second_field(got[i - 1], NULL), _extsort_second_field(got[i], NULL)) <= 0;
+    }
+    EXPECT_TRUE(ordered);
+    sv_sort(got, n);
+    mismatches = 0;
+    for (size_t i = 0; i < n; i++)
+        mismatches += !sv_compare(got[i], lines[i]);
+    EXPECT_TRUE_INFO(mismatches == 0, "%zu mismatches", mismatches);
+    free(got);
+    free(out);
+    free(lines);
+    free(text);
+}
+
+// UTF-8 VALIDATION
+
+static size_t _utf8_reference(const unsigned char *s, size_t len)
+{
+    // Decodes code points and checks their range, independent of how sv.h
+    // classifies lead and continuation bytes.
+    static const uint32_t min_cp[5] = {0, 0, 0x80, 0x800, 0x10000};
+    size_t i = 0;
+    while (i < len)
+    {
+        size_t n = s[i] < 0x80 ? 1 : (s[i] & 0xE0) == 0xC0 ? 2 : (s[i] & 0xF0) == 0xE0 ? 3 : (s[i] & 0xF8) == 0xF0 ? 4 : 0;
+        if (n == 0 || len - i < n)
+            return i;
+        uint32_t cp = n == 1 ? s[i] : s[i] & (0x7F >> n);
+        for (size_t k = 1; k < n; k++)
+        {
+            if ((s[i + k] & 0xC0) != 0x80)
+                return i;
+            cp = cp << 6 | (s[i + k] & 0x3F);
+        }
+        if (cp < min_cp[n] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+            return i;
+        i += n;
+    }
+    return i;
+}
+
+TEST(utf8_tests, sv_utf8_validate__known_sequences)
+{
+    struct
+    {
+        const char *text;
+        size_t error_offset;
+    } cases[] = {
+        {"plain ascii", 11},
+        {"caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80", 14},
+        {"\xf4\x8f\xbf\xbf", 4},      // U+10FFFF
+        {"a\xc0\x80", 1},              // overlong NUL
+        {"ab\xe0\x80\x80", 2},         // overlong 3-byte
+        {"\xed\xa0\x80", 0},           // surrogate
+        {"xyz\xf4\x90\x80\x80", 3},    // past U+10FFFF
+        {"\xf5\x80\x80\x80", 0},       // invalid lead
+        {"ok\x80", 2},                 // stray continuation
+        {"\xe2\x82", 0},               // truncated at the end
+        {"\xc3\xa9\xc3", 2},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        StringView sv = StringViewFromStr((char *)cases[i].text);
+        size_t offset = 99;
+        bool valid = sv_utf8_validate(sv, &offset);
+        EXPECT_TRUE_INFO(valid == (cases[i].error_offset == sv.len) && offset == cases[i].error_offset,
+                         "case %zu: got %zu", i, offset);
+    }
+    EXPECT_TRUE(sv_utf8_validate(StringViewNull, NULL));
+}
+
+static void _utf8_random_text(unsigned char *buf, size_t len)
+{
+    // Mostly valid text in runs of ASCII and multibyte characters, with the
+    // occasional random byte to break it.
+    static const char *pieces[] = {"a", "Z ", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xed\x9f\xbf", "\xef\xbf\xbf"};
+    size_t i = 0;
+    while (i < len)
+    {
+        if (rand() % 400 == 0)
+        {
+            buf[i++] = rand();
+            continue;
+        }
+        const char *piece = pieces[rand() % 3 ? 0 : rand() % 7];
+        for (size_t k = 0; piece[k] && i < len; k++)
+            buf[i++] = piece[k];
+    }
+}
+
+TEST(utf8_tests, sv_utf8_validate__matches_reference_on_all_levels)
+{
+    size_t n = 4096;
+    unsigned char *buf = malloc(n);
+    srand(26);
+    FOR_EACH_SIMD_LEVEL(level)
+    {
+        for (int round = 0; round < 2000; round++)
+        {
+            size_t len = rand() % n;
+            _utf8_random_text(buf, len);
+            size_t expected = _utf8_reference(buf, len), offset;
+            bool valid = sv_utf8_validate(sv_construct((char *)buf, len), &offset);
+            EXPECT_TRUE_INFO(offset == expected && valid == (expected == len), "level %d len %zu: %zu vs %zu", level,
+                             len, offset, expected);
+        }
+    }
+    free(buf);
+}
+
+TEST(utf8_tests, sv_utf8_validator__chunks_agree_with_whole_buffer)
+{
+    size_t n = 3000;
+    unsigned char *buf = malloc(n);
+    srand(27);
+    for (int round = 0; round < 2000; round++)
+    {
+        size_t len = rand() % n;
+        _utf8_random_text(buf, len);
+        size_t expected = _utf8_reference(buf, len);
+
+        sv_utf8_validator validator;
+        sv_utf8_validator_init(&validator);
+        bool valid = true;
+        for (size_t at = 0; at < len && valid;)
+        {
+            size_t chunk = rand() % 4 ? rand() % 5 : rand() % 300;
+            chunk = chunk > len - at ? len - at : chunk;
+            valid = sv_utf8_validator_feed(&validator, sv_construct((char *)buf + at, chunk));
+            at += chunk;
+        }
+        valid = sv_utf8_validator_finish(&validator);
+        EXPECT_TRUE_INFO(valid == (expected == len) && (valid || validator.error_offset == expected),
+                         "len %zu: %zu vs %zu", len, validator.error_offset, expected);
+    }
+    free(buf);
 }
\ No newline at end of file